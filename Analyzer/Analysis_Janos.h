@@ -3248,38 +3248,38 @@ Analysis::fill_analysis_histos(DataStruct& d, const unsigned int& syst_index, co
     //__________________________________ 
     //         Fill Smarthistos
     //__________________________________
-    while(d.jetsAK4.Loop()) if (passLooseJet     [d.jetsAK4.it]) sh.Fill("AK4");
-    while(d.jetsAK8.Loop()) if (passLooseJetAK8  [d.jetsAK8.it]) sh.Fill("AK8");
-    while(d.jetsAK4.Loop()) if (passMediumBTag   [d.jetsAK4.it]) sh.Fill("b");
-    while(d.jetsAK4.Loop()) if (passLooseBTag    [d.jetsAK4.it]) sh.Fill("b loose");
-    while(d.jetsAK8.Loop()) if (passWMassTag     [d.jetsAK8.it]) sh.Fill("mW");
-    while(d.jetsAK8.Loop()) if (passTightWAntiTag[d.jetsAK8.it]) sh.Fill("aW");
-    while(d.jetsAK8.Loop()) if (passTightWTag    [d.jetsAK8.it]) sh.Fill("W");
-    while(d.ele.Loop())     if (passEleSelect    [d.ele.it])     sh.Fill("ele");
-    while(d.ele.Loop())     if (passEleVeto      [d.ele.it])     sh.Fill("ele veto");
-    while(d.mu.Loop())      if (passMuSelect     [d.mu.it])      sh.Fill("mu");
-    while(d.mu.Loop())      if (passMuVeto       [d.mu.it])      sh.Fill("mu veto");
-    while(d.pho.Loop())     if (passPhotonSelect [d.pho.it])     sh.Fill("pho");
-    while(d.gen.Loop())     if (passGenHadW      [d.gen.it])     sh.Fill("gen W");
-    while(d.gen.Loop())     if (passGenTop       [d.gen.it])     sh.Fill("gen top");
+    while(passLooseJet.Loop(d.jetsAK4.it))      sh.Fill("AK4");
+    while(passLooseJetAK8.Loop(d.jetsAK8.it))   sh.Fill("AK8");
+    while(passMediumBTag.Loop(d.jetsAK4.it))    sh.Fill("b");
+    while(passLooseBTag.Loop(d.jetsAK4.it))     sh.Fill("b loose");
+    while(passWMassTag.Loop(d.jetsAK8.it))      sh.Fill("mW");
+    while(passTightWAntiTag.Loop(d.jetsAK8.it)) sh.Fill("aW");
+    while(passTightWTag.Loop(d.jetsAK8.it))     sh.Fill("W");
+    while(passEleSelect.Loop(d.ele.it))         sh.Fill("ele");
+    while(passEleVeto.Loop(d.ele.it))           sh.Fill("ele veto");
+    while(passMuSelect.Loop(d.mu.it))           sh.Fill("mu");
+    while(passMuVeto.Loop(d.mu.it))             sh.Fill("mu veto");
+    while(passPhotonSelect.Loop(d.pho.it))      sh.Fill("pho");
+    while(passGenHadW.Loop(d.gen.it))           sh.Fill("gen W");
+    while(passGenTop.Loop(d.gen.it))            sh.Fill("gen top");
     sh.Fill("evt");
   }
 
   // Do the same for systematics plots:
-  while(d.jetsAK4.Loop()) if (passLooseJet     [d.jetsAK4.it]) sh.Fill("syst AK4");
-  while(d.jetsAK8.Loop()) if (passLooseJetAK8  [d.jetsAK8.it]) sh.Fill("syst AK8");
-  while(d.jetsAK4.Loop()) if (passMediumBTag   [d.jetsAK4.it]) sh.Fill("syst b");
-  while(d.jetsAK4.Loop()) if (passLooseBTag    [d.jetsAK4.it]) sh.Fill("syst b loose");
-  while(d.jetsAK8.Loop()) if (passWMassTag     [d.jetsAK8.it]) sh.Fill("syst mW");
-  while(d.jetsAK8.Loop()) if (passTightWAntiTag[d.jetsAK8.it]) sh.Fill("syst aW");
-  while(d.jetsAK8.Loop()) if (passTightWTag    [d.jetsAK8.it]) sh.Fill("syst W");
-  while(d.ele.Loop())     if (passEleSelect    [d.ele.it])     sh.Fill("syst ele");
-  while(d.ele.Loop())     if (passEleVeto      [d.ele.it])     sh.Fill("syst ele veto");
-  while(d.mu.Loop())      if (passMuSelect     [d.mu.it])      sh.Fill("syst mu");
-  while(d.mu.Loop())      if (passMuVeto       [d.mu.it])      sh.Fill("syst mu veto");
-  while(d.pho.Loop())     if (passPhotonSelect [d.pho.it])     sh.Fill("syst pho");
-  while(d.gen.Loop())     if (passGenHadW      [d.gen.it])     sh.Fill("syst gen W");
-  while(d.gen.Loop())     if (passGenTop       [d.gen.it])     sh.Fill("syst gen top");
+  while(passLooseJet.Loop(d.jetsAK4.it))      sh.Fill("syst AK4");
+  while(passLooseJetAK8.Loop(d.jetsAK8.it))   sh.Fill("syst AK8");
+  while(passMediumBTag.Loop(d.jetsAK4.it))    sh.Fill("syst b");
+  while(passLooseBTag.Loop(d.jetsAK4.it))     sh.Fill("syst b loose");
+  while(passWMassTag.Loop(d.jetsAK8.it))      sh.Fill("syst mW");
+  while(passTightWAntiTag.Loop(d.jetsAK8.it)) sh.Fill("syst aW");
+  while(passTightWTag.Loop(d.jetsAK8.it))     sh.Fill("syst W");
+  while(passEleSelect.Loop(d.ele.it))         sh.Fill("syst ele");
+  while(passEleVeto.Loop(d.ele.it))           sh.Fill("syst ele veto");
+  while(passMuSelect.Loop(d.mu.it))           sh.Fill("syst mu");
+  while(passMuVeto.Loop(d.mu.it))             sh.Fill("syst mu veto");
+  while(passPhotonSelect.Loop(d.pho.it))      sh.Fill("syst pho");
+  while(passGenHadW.Loop(d.gen.it))           sh.Fill("syst gen W");
+  while(passGenTop.Loop(d.gen.it))            sh.Fill("syst gen top");
   sh.Fill("syst evt");
     
   //// W fake rate scale factors
@@ -5,8 +5,11 @@
 //-----------------------------------------------------------------------------
 #include <iostream>
 #include <cstdlib>
+#include <cstdio>
 #include <unistd.h>
+#include <sys/wait.h>
 #include <vector>
+#include <set>
 
 #include "settings_Janos.h" // Define all Analysis specific settings here
 
@@ -35,28 +38,90 @@ int main(int argc, char** argv) {
   utils::decodeCommandLine(argc, argv, cmdline, vname_data, vname_signal);
   if (debug) std::cout<<"Analyzer::main: decodeCommandLine ok"<<std::endl;
 
-  itreestream stream(cmdline.fileNames, settings.treeName, 2000);
-  if ( !stream.good() ) utils::error("unable to open ntuple file(s)");
+  // The sample index has the entries (and clusters, xsec, total weights) of all
+  // files of the list, so the chain does not open each file at the start
+  SampleIndex index;
+  std::vector<long long> file_entries;
+  if (settings.useSampleIndex && cmdline.indexFileName!="") {
+    std::vector<std::string> histos(1, settings.totWeightHistoName);
+    histos.insert(histos.end(), settings.totWeightHistoNamesSignal.begin(), settings.totWeightHistoNamesSignal.end());
+    std::vector<std::string> files(cmdline.allFileNames);
+    files.insert(files.end(), cmdline.fileNames.begin(), cmdline.fileNames.end());
+    index.load(cmdline.indexFileName, files, settings.treeName, histos);
+    file_entries = index.entries(cmdline.fileNames);
+  }
+
+  itreestream* stream = new itreestream(cmdline.fileNames, settings.treeName, file_entries, 2000);
+  if ( !stream->good() ) utils::error("unable to open ntuple file(s)");
 
   if ( cmdline.isData ) cout << "Running on Data." << endl;
   else if ( cmdline.isBkg ) cout << "Running on Background MC." << endl;
   else cout << "Running on Signal MC." << endl;
 
-  // Get number of events to be read
-  int nevents = stream.size();
-
+  // Get the entries to be read
+  // firstEntry/lastEntry select a range, shard=i/N the i-th part of it
+  // (split at cluster boundaries, so a basket is only read by one job)
+  // quickTest=N takes the first 1/N of these entries, or with stratified=1
+  // every N-th cluster, so the test sees all files
+  utils::EntryRanges entry_ranges;
+  int first_entry = std::max(0, cmdline.firstEntry);
+  int last_entry  = cmdline.lastEntry<0 ? stream->size() : std::min(cmdline.lastEntry, stream->size());
+  if (first_entry<last_entry) entry_ranges.push_back(std::make_pair(first_entry, last_entry));
+  if (first_entry!=0 || last_entry!=stream->size())
+    cout << "Entry range (cmdline): "<<first_entry<<" - "<<last_entry-1<< endl;
+  std::vector<int> clusters;
+  if (cmdline.nShards>1 || (cmdline.quickTest>1 && cmdline.stratified))
+    clusters = index.good() ? index.clusters(cmdline.fileNames) : stream->clusters();
+  if (cmdline.nShards>1) {
+    entry_ranges = utils::shard_range(clusters, first_entry, last_entry, cmdline.shard, cmdline.nShards);
+    cout << "Shard (cmdline): "<<cmdline.shard<<"/"<<cmdline.nShards;
+    if (entry_ranges.size()) cout<<" - entries: "<<entry_ranges[0].first<<" - "<<entry_ranges[0].second-1;
+    cout << endl;
+  }
   if (cmdline.quickTest) {
     cout << "quickTest (cmdline): "<<cmdline.quickTest<< endl;
-    cout << "--> Doing a quick test on 1/"<<cmdline.quickTest<<" statitics"<< endl;
-    nevents /= cmdline.quickTest;
-    cout << "Number of events (1/" << cmdline.quickTest << "): " << nevents << endl;
-  } else {
-    cout << "Number of events: " << nevents << endl;
+    cout << "--> Doing a quick test on 1/"<<cmdline.quickTest<<" statitics";
+    if (cmdline.stratified) {
+      cout << " (every "<<cmdline.quickTest<<"th cluster)"<< endl;
+      entry_ranges = utils::stratified_ranges(clusters, entry_ranges, cmdline.quickTest);
+    } else {
+      cout << endl;
+      entry_ranges = utils::sub_ranges(entry_ranges, 0, utils::nentries(entry_ranges) / cmdline.quickTest);
+    }
   }
+  int nevents = utils::nentries(entry_ranges);
+  cout << "Number of events: " << nevents << endl;
 
   // Select variables to be read
+  // With readPreselectionFirst (data only), the branches needed for the
+  // baseline cuts are read first, and the rest only for events passing them
   DataStruct data;
-  settings.selectVariables(stream, data);
+  // Input files are staged by a thread of the stream, that can not be forked
+  // with the workers (and each worker would use up to stageSize on its own)
+  if (cmdline.stageDir!="" && cmdline.nThreads>1) {
+    cout << "stageDir (cmdline): not supported with nThreads>1, switched off"<< endl;
+    cmdline.stageDir = "";
+  }
+  const bool read_preselection_first = settings.readPreselectionFirst && cmdline.isData;
+  auto select_variables = [&] (itreestream& s) {
+#ifdef DATASTRUCT_SCHEMA
+    // Same executable for all ntuple versions, only the branches used are read
+    if (settings.useSchema)
+      selectSchema(s, data, settings.saveSkimmedNtuple, read_preselection_first ?
+		   settings.preselectionBranches : std::vector<std::string>());
+    else
+#endif
+    settings.selectVariables(s, data);
+    if (read_preselection_first)
+      for (const auto& name : settings.preselectionBranches) s.preselect(name);
+    s.cache(settings.cacheSize, settings.parallelUnzip, settings.asyncPrefetch);
+    s.retry(settings.readStallTime, settings.readRetries, settings.skipBadFiles);
+    if (cmdline.stageDir!="") s.stage(cmdline.stageDir, cmdline.stageSize*1e9);
+    // The skim is copied from the branch buffers, these have to keep the values read
+    if (settings.saveSkimmedNtuple) s.bind(false);
+    else if (cmdline.cacheDir!="") s.columncache(cmdline.cacheDir);
+  };
+  select_variables(*stream);
   if (debug) std::cout<<"Analyzer::main: selectVariables ok"<<std::endl;
 
   /*
@@ -80,16 +145,18 @@ int main(int argc, char** argv) {
     passing a given cut. If omitted, the event-weight is taken to be 1.
     If you want the counts in the count histogram to appear in a given
     order, specify the order, before entering the event loop, as in
-    the example below
+    the example below. The returned ids can then be used in the event
+    loop instead of the names, eg. ofile.count_id(c_met, event-weight)
 	 
-    ofile.count("NoCuts", 0)
-    ofile.count("GoodEvent", 0)
-    ofile.count("Vertex", 0)
-    ofile.count("MET", 0)
+    size_t c_nocuts    = ofile.counter("NoCuts")
+    size_t c_goodevent = ofile.counter("GoodEvent")
+    size_t c_vertex    = ofile.counter("Vertex")
+    size_t c_met       = ofile.counter("MET")
   */
 
   // Constuct the Analysis (specified in settings.h)
   Analysis ana(cmdline.isData, cmdline.isSignal, cmdline.dirname);
+  if (index.good()) ana.use_sample_index(&index);
 
   // ---------------------------------------------------------------------------
   // -- output file                                                           --
@@ -98,7 +165,18 @@ int main(int argc, char** argv) {
   utils::outputFile* ofile;
   if ( settings.saveSkimmedNtuple ) {
     cout << "saveSkimmedNtuple (settings): true" << endl;
-    ofile = new utils::outputFile(cmdline.outputFileName, stream);
+    std::vector<std::string> skim_branches;
+    if (settings.skimBranchesFileName!="") {
+      cout << "skimBranchesFileName (settings): " << settings.skimBranchesFileName << endl;
+      skim_branches = utils::read_branch_list(settings.skimBranchesFileName);
+    } else cout << "skimBranchesFileName (settings): \"\" - saving all branches" << endl;
+    cout << "saveDerivedTree (settings): " << ( settings.saveDerivedTree ? "true" : "false" ) << endl;
+    cout << "skimCompression (settings): " << settings.skimCompression << endl;
+    cout << "skimAutoFlush (settings): " << settings.skimAutoFlush << endl;
+    cout << "skimWriteQueue (settings): " << settings.skimWriteQueue << endl;
+    ofile = new utils::outputFile(cmdline.outputFileName, *stream, skim_branches, settings.saveDerivedTree,
+				  settings.skimCompression, settings.skimAutoFlush, settings.skimWriteQueue);
+    if (settings.saveDerivedTree) ana.init_derived_tree(ofile->derived_);
   } else {
     ofile = new utils::outputFile(cmdline.outputFileName);
     cout << "saveSkimmedNtuple (settings): false" << endl;
@@ -133,6 +211,18 @@ int main(int argc, char** argv) {
       std::vector<std::vector<double> >(settings.nSigmaScaleFactors, std::vector<double>(1,0));
     std::vector<unsigned int> numScale    = std::vector<unsigned int>(1,0);
     std::vector<unsigned int> numPdf      = std::vector<unsigned int>(1,0);
+    // Order in which the variations are evaluated for each event
+    std::vector<unsigned int> order       = std::vector<unsigned int>(1,0);
+
+    // Variations i and j shift jets/MET the same way (no need to recalculate variables)
+    bool same_shape(const unsigned int& i, const unsigned int& j) const {
+      return nSigmaJES[i]==nSigmaJES[j] && nSigmaJER[i]==nSigmaJER[j] && nSigmaRestMET[i]==nSigmaRestMET[j];
+    }
+    // Variations i and j use the same object scale factor sigmas
+    bool same_sfs(const unsigned int& i, const unsigned int& j) const {
+      for (const auto& sigmas : nSigmaSFs) if (sigmas[i]!=sigmas[j]) return false;
+      return true;
+    }
   } syst;
 
   if (settings.varySystematics) {
@@ -169,6 +259,22 @@ int main(int argc, char** argv) {
       std::cout<<" line "<<syst.nSyst<<": "<<line<<std::endl;
     }
     std::cout<<std::endl;
+
+    // Evaluate the nominal first, then all variations that only change the event weight
+    // (lumi, pileup, theory, trigger, SFs), and finally the JES/JER/MET variations
+    // grouped by their shift, so each distinct shift is only recalculated once per event
+    std::vector<bool> added(syst.nSyst+1, false);
+    added[0] = true;
+    for (unsigned int i=1; i<=syst.nSyst; ++i) if (syst.same_shape(i, 0)) {
+      syst.order.push_back(i);
+      added[i] = true;
+    }
+    for (unsigned int i=1; i<=syst.nSyst; ++i) if (!added[i]) {
+      for (unsigned int j=i; j<=syst.nSyst; ++j) if (!added[j] && syst.same_shape(i, j)) {
+	syst.order.push_back(j);
+	added[j] = true;
+      }
+    }
     
   } else {
     cout << "varySystematics (settings): false" << endl;
@@ -180,35 +286,12 @@ int main(int argc, char** argv) {
   // -- Read and apply JSON file (Data)                                       --
   // ---------------------------------------------------------------------------
 
-  std::map<int, std::map<int, bool> > json_run_ls;
+  LumiMask json_lumi_mask;
   if (settings.useJSON) {
     cout << "useJSON (settings): true" << endl;
     cout << "jsonFileName (settings): " << settings.jsonFileName << endl;
-    std::ifstream jsonFile(settings.jsonFileName.c_str());
-    if ( !jsonFile.good() ) utils::error("unable to open systematics file: " + settings.jsonFileName);
-
-    std::string line;
-    int run, ls_low, ls_high;
-    while ( std::getline(jsonFile, line, ' ') ) {
-      if (TString(line).Contains("\"")) {
-	std::stringstream run_str;
-	run_str<<line.substr(line.find("\"")+1, 6);
-	run_str>>run;
-      } else {
-	if (TString(line).Contains("[")) {
-	  std::stringstream ls_low_str;
-	  while (line.find("[")!=std::string::npos) line.erase(line.find("["),1);
-	  ls_low_str<<line;
-	  ls_low_str>>ls_low;
-	} else if (TString(line).Contains("]")) {
-	  std::stringstream ls_high_str;
-	  ls_high_str<<line;
-	  ls_high_str>>ls_high;
-	  for (int ls=ls_low; ls<=ls_high; ++ls)
-	    json_run_ls[run].insert(std::pair<int, bool>(ls, 1));
-	}
-      }
-    }
+    json_lumi_mask.load(settings.jsonFileName);
+    cout << "JSON file: " << json_lumi_mask.nRuns() << " runs, " << json_lumi_mask.nRanges() << " lumisection ranges" << endl;
   } else {
     cout << "useJSON (settings): false" << endl;
   }
@@ -231,9 +314,23 @@ int main(int argc, char** argv) {
   ana.define_histo_options(w, data, syst.nSyst, syst.index, settings.runOnSkim);
   if (debug) std::cout<<"Analyzer::main: define_histo_options ok"<<std::endl;
 
+  // The histos booked here are filled in the event loop, these are
+  // merged between workers (the others hold inputs, eg. pileup or weight
+  // normalization), together with any histo created during the event loop
+  auto histo_names = [&out_dir] () {
+    std::set<std::string> names;
+    TIter next(out_dir->GetList());
+    while (TObject* obj = next())
+      if (obj->InheritsFrom("TH1")) names.insert(obj->GetName());
+    return names;
+  };
+  std::set<std::string> setup_histos = histo_names(), loop_histos;
+
   ana.init_common_histos();
   if (!cmdline.noPlots)
     ana.init_analysis_histos(syst.nSyst, syst.index);
+  for (const auto& name : histo_names())
+    if (!setup_histos.count(name)) loop_histos.insert(name);
   if (debug) std::cout<<"Analyzer::main: init_histos ok"<<std::endl;
 
   // Read histograms for scale factors
@@ -325,6 +422,8 @@ int main(int argc, char** argv) {
   // Given in common/AnalysisBase.h
   ana.define_preselections(data);
   if (debug) std::cout<<"Analyzer::main: define_preselections ok"<<std::endl;
+  ana.define_common_variables(data);
+  if (debug) std::cout<<"Analyzer::main: define_common_variables ok"<<std::endl;
 
   // Define cuts that specific to this analysis
   // Given in [Name]_Analysis.h specified in setting.h
@@ -332,55 +431,306 @@ int main(int argc, char** argv) {
   if (debug) std::cout<<"Analyzer::main: define_selections ok"<<std::endl;
 
   // Define bin order for counts histogram
-  ofile->count("nevents",   0);
+  // Each counter gets an id here, which is used in the event loop
+  const size_t c_nevents = ofile->counter("nevents");
   // Counts after each reweighting step
+  size_t c_w_lumi = 0, c_w_toppt = 0, c_w_pileup = 0, c_w_alphas = 0, c_w_scale = 0, c_w_pdf = 0, c_w_trigger = 0;
   if ( ! cmdline.isData ) {
-    ofile->count("w_lumi",    0);
-    ofile->count("w_toppt",  0);
-    ofile->count("w_pileup",  0);
-    ofile->count("w_alphas",  0);
-    ofile->count("w_scale",   0);
-    ofile->count("w_pdf",     0);
-    ofile->count("w_trigger", 0);
+    c_w_lumi    = ofile->counter("w_lumi");
+    c_w_toppt   = ofile->counter("w_toppt");
+    c_w_pileup  = ofile->counter("w_pileup");
+    c_w_alphas  = ofile->counter("w_alphas");
+    c_w_scale   = ofile->counter("w_scale");
+    c_w_pdf     = ofile->counter("w_pdf");
+    c_w_trigger = ofile->counter("w_trigger");
     ana.all_weights.resize(6,1);
   }
-  ofile->count("NoCuts",    0);
+  // Event weights for each systematic variation (recalculated for each event)
+  std::vector<double> syst_weight(syst.nSyst+1, 1);
+  std::vector<std::vector<double> > syst_all_weights(syst.nSyst+1, ana.all_weights);
+  const size_t c_nocuts = ofile->counter("NoCuts");
+  // Only the leading cuts that need no common variables can be checked before
+  // the rest of the event is read, the others are applied after it
+  size_t n_preselection_cuts = 0;
+  while (n_preselection_cuts<ana.baseline_cuts.size() && ana.baseline_cuts[n_preselection_cuts].preselection) ++n_preselection_cuts;
+  if (read_preselection_first && n_preselection_cuts<ana.baseline_cuts.size())
+    cout << "readPreselectionFirst (settings): baseline cuts from "<<ana.baseline_cuts[n_preselection_cuts].name<<" are applied after reading the rest"<< endl;
   cout << endl;
   cout << "Number of events counted after applying" << endl;
   cout << "- Baseline cuts (common for all analysis):" << endl;
+  std::vector<size_t> c_baseline_cuts;
   for (const auto& cut : ana.baseline_cuts) {
-    ofile->count(cut.name, 0);
+    c_baseline_cuts.push_back(ofile->counter(cut.name));
     cout << "  "<<cut.name << endl;
   }
   cout << endl;
   cout << "- Analysis specific cuts (and scale factors):\n";
+  // Ids for each search region (in the order of ana.analysis_cuts)
+  std::vector<std::vector<size_t> > c_analysis_cuts, c_scale_factors;
+  auto sf_counter = [&ofile] (const char& region, const size_t& i) {
+    return ofile->counter(std::string(1,region)+"_sf_"+std::to_string(i+1));
+  };
   for (const auto& search_region : ana.analysis_cuts) {
+    c_analysis_cuts.push_back(std::vector<size_t>());
     for (const auto& cut : search_region.second) {
-      ofile->count(std::string(1,search_region.first)+"_cut_"+cut.name, 0);
+      c_analysis_cuts.back().push_back(ofile->counter(std::string(1,search_region.first)+"_cut_"+cut.name));
       cout << "  " << std::string(1,search_region.first)+"_cut_"+cut.name << endl;
     }
     // Apply scale factors
     ana.apply_scale_factors(data, syst.index, syst.nSigmaSFs);
+    c_scale_factors.push_back(std::vector<size_t>());
     for (size_t i=0, n=ana.scale_factors[search_region.first].size(); i<n; ++i)
-      ofile->count(std::string(1,search_region.first)+"_sf_"+std::to_string(i+1), 0);
+      c_scale_factors.back().push_back(sf_counter(search_region.first, i));
   }
   if (debug) std::cout<<"Analyzer::main: init counts ok"<<std::endl;
 
+  //---------------------------------------------------------------------------
+  // Timing of the event loop stages
+  //---------------------------------------------------------------------------
+
+  utils::StageTimer timer(cmdline.timing);
+  const size_t t_event             = timer.add_stage("event");
+  const size_t t_read              = timer.add_stage("read");
+  const size_t t_weights           = timer.add_stage("event_weights");
+  const size_t t_rescale_smear     = timer.add_stage("rescale_smear_jet_met");
+  const size_t t_common_variables  = timer.add_stage("calculate_common_variables");
+  const size_t t_variables         = timer.add_stage("calculate_variables");
+  const size_t t_scale_factors     = timer.add_stage("apply_scale_factors");
+  const size_t t_baseline_cuts     = timer.add_stage("baseline_cuts");
+  const size_t t_analysis_cuts     = timer.add_stage("analysis_cuts");
+  const size_t t_common_histos     = timer.add_stage("fill_common_histos");
+  const size_t t_analysis_histos   = timer.add_stage("fill_analysis_histos");
+
+  //---------------------------------------------------------------------------
+  // Split events between parallel workers
+  //---------------------------------------------------------------------------
+
+  // Workers are forked processes, because the analyses keep their variables
+  // and histograms in globals, so each worker needs its own copy of them
+  // Everything above (input histos, weight normalization, booking) is done only once
+  // Worker 0 is this process, the others save their histos and counts
+  // to a temporary file, which are merged here after the event loop
+  int worker = 0;
+  std::vector<pid_t> worker_pids;
+  auto worker_file = [&cmdline] (const std::string& suffix) {
+    std::string name = cmdline.outputFileName;
+    if (name.find(".root")!=std::string::npos) name.erase(name.rfind(".root"));
+    return name + suffix + ".root";
+  };
+  if (cmdline.nThreads>1 && settings.saveSkimmedNtuple) {
+    cout << "nThreads (cmdline): "<<cmdline.nThreads<<" - not supported when skimming, using 1"<< endl;
+    cmdline.nThreads = 1;
+  }
+
+  // Histos that exist from here on (except the booked ones) are inputs
+  setup_histos = histo_names();
+
+  // Results of the event loop so far (histos filled in the loop, counts,
+  // timing and analysis histos), saved by workers and in checkpoints
+  auto write_partial_results = [&] (TFile* f) {
+    TDirectory* dir = f->mkdir("loop_histos");
+    for (const auto& name : histo_names())
+      if (loop_histos.count(name) || !setup_histos.count(name))
+	dir->WriteTObject(out_dir->GetList()->FindObject(name.c_str()));
+    ofile->write_count_partials(f);
+    timer.write(f);
+    if (!cmdline.noPlots) {
+      f->cd();
+      ana.save_analysis_histos();
+    }
+  };
+
+  // Add the results saved with write_partial_results (file is closed)
+  auto add_partial_results = [&] (TFile* f) {
+    std::string filename = f->GetName();
+    TDirectory* dir = (TDirectory*)f->Get("loop_histos");
+    if (dir == 0) utils::error("loop_histos not found in file " + filename);
+    TIter next(dir->GetListOfKeys());
+    while (TKey* key = (TKey*)next()) {
+      TH1* h_saved = (TH1*)key->ReadObj();
+      TH1* h = (TH1*)out_dir->GetList()->FindObject(key->GetName());
+      if (h) h->Add(h_saved);
+      else {
+	// Created during the event loop, but not (yet) here
+	h = (TH1*)h_saved->Clone();
+	h->SetDirectory(out_dir);
+      }
+    }
+    ofile->add_count_partials(f);
+    timer.add(f);
+    f->Close();
+    if (!cmdline.noPlots)
+      ana.load_analysis_histos(filename);
+    out_dir->cd();
+  };
+
+  if (cmdline.nThreads>1) {
+    cout << "nThreads (cmdline): "<<cmdline.nThreads<< endl;
+    cout << flush;
+    for (int i=1; i<cmdline.nThreads; ++i) {
+      pid_t pid = fork();
+      if (pid<0) utils::error("unable to start worker process");
+      if (pid==0) { worker = i; break; }
+      worker_pids.push_back(pid);
+    }
+    entry_ranges = utils::sub_ranges(entry_ranges, (long)nevents *  worker    / cmdline.nThreads,
+				     (long)nevents * (worker+1) / cmdline.nThreads);
+    nevents = utils::nentries(entry_ranges);
+    if (worker>0) {
+      // Don't share open input files with the parent, open the chain again
+      stream = new itreestream(cmdline.fileNames, settings.treeName, file_entries, 2000);
+      if ( !stream->good() ) utils::error("worker unable to open ntuple file(s)");
+      select_variables(*stream);
+    }
+    cout << "Worker "<<worker<<" runs on "<<nevents<<" entries";
+    if (entry_ranges.size()) cout<<": "<<entry_ranges.front().first<<" - "<<entry_ranges.back().second-1;
+    cout << endl;
+  }
+  if (debug) std::cout<<"Analyzer::main: start workers ok"<<std::endl;
+
+  //---------------------------------------------------------------------------
+  // Checkpoints
+  //---------------------------------------------------------------------------
+
+  // Every checkpoint=N events and/or checkpointTime=N seconds, each worker saves
+  // the number of entries done, its partial results and the random generator state
+  // The file is written under a temporary name first, and then renamed, so a
+  // job that is killed while writing it still leaves the previous checkpoint
+  // With resume=1 the job is set up as usual, and then continues from there
+  // (with the same input and options, the output is identical)
+  if ((cmdline.checkpoint>0 || cmdline.checkpointTime>0 || cmdline.resume) && settings.saveSkimmedNtuple) {
+    cout << "checkpoint/resume (cmdline): not supported when skimming, switched off"<< endl;
+    cmdline.checkpoint = cmdline.checkpointTime = 0;
+    cmdline.resume = false;
+  }
+  const bool use_checkpoints = cmdline.checkpoint>0 || cmdline.checkpointTime>0;
+  const std::string checkpoint_file = worker_file("_checkpoint" + (worker ? std::to_string(worker) : std::string()));
+  int first_entry = entry_ranges.empty() ? 0 : entry_ranges.front().first;
+  auto last_checkpoint = std::chrono::steady_clock::now();
+
+  auto write_checkpoint = [&] (int nentries_done) {
+    std::string tmp_file = checkpoint_file + ".tmp";
+    TFile* f = TFile::Open(tmp_file.c_str(), "RECREATE");
+    if (!f || f->IsZombie()) utils::error("unable to write checkpoint: "+tmp_file);
+    TTree* tree = new TTree("checkpoint", "Position of the checkpoint");
+    tree->Branch("nentries_done", &nentries_done, "nentries_done/I");
+    tree->Branch("nevents",       &nevents,       "nevents/I");
+    tree->Branch("first_entry",   &first_entry,   "first_entry/I");
+    tree->Branch("nThreads",      &cmdline.nThreads, "nThreads/I");
+    tree->Fill();
+    tree->Write();
+    write_partial_results(f);
+    ana.write_random_state(f);
+    f->Close();
+    delete f;
+    if (std::rename(tmp_file.c_str(), checkpoint_file.c_str()))
+      utils::error("unable to rename checkpoint: "+tmp_file);
+    out_dir->cd();
+    last_checkpoint = std::chrono::steady_clock::now();
+  };
+
+  auto checkpoint_due = [&] (const int& nentries_done) {
+    if (cmdline.checkpoint>0 && nentries_done % cmdline.checkpoint == 0) return true;
+    return cmdline.checkpointTime>0 &&
+      std::chrono::steady_clock::now() - last_checkpoint >= std::chrono::seconds(cmdline.checkpointTime);
+  };
+
+  int ientry = 0;
+  if (cmdline.resume) {
+    TFile* f = TFile::Open(checkpoint_file.c_str());
+    if (!f || f->IsZombie()) {
+      cout << "resume (cmdline): no checkpoint found ("<<checkpoint_file<<"), starting from the first entry"<< endl;
+    } else {
+      TTree* tree = (TTree*)f->Get("checkpoint");
+      if (tree == 0) utils::error("checkpoint tree not found in file "+checkpoint_file);
+      int nentries_done = 0, saved_nevents = 0, saved_first_entry = 0, saved_nthreads = 0;
+      tree->SetBranchAddress("nentries_done", &nentries_done);
+      tree->SetBranchAddress("nevents",       &saved_nevents);
+      tree->SetBranchAddress("first_entry",   &saved_first_entry);
+      tree->SetBranchAddress("nThreads",      &saved_nthreads);
+      tree->GetEntry(0);
+      tree->ResetBranchAddresses();
+      if (saved_nevents!=nevents || saved_first_entry!=first_entry || saved_nthreads!=cmdline.nThreads)
+	utils::error("checkpoint "+checkpoint_file+" was made with different input or options");
+      ana.read_random_state(f);
+      add_partial_results(f);
+      ientry = nentries_done;
+      entry_ranges = utils::sub_ranges(entry_ranges, ientry, nevents);
+      cout << "resume (cmdline): continue from checkpoint "<<checkpoint_file<<" after "<<ientry<<" entries"<< endl;
+    }
+  }
+  if (debug) std::cout<<"Analyzer::main: checkpoints ok"<<std::endl;
+
+  // Live metrics (rates, bytes read, stalls, memory, time left) for monitoring running jobs
+  MetricsStream metrics;
+  if (cmdline.metrics!="") {
+    metrics.open(cmdline.metrics, cmdline.outputFileName, worker, cmdline.metricsInterval);
+    if (worker==0) cout << "metrics (cmdline): "<<cmdline.metrics<<" - every "<<cmdline.metricsInterval<<" s"<< endl;
+  }
+
   //---------------------------------------------------------------------------
   // Loop over events
   //---------------------------------------------------------------------------
 
+  // Count the events passing baseline cuts [first, last), true if all of them are passed
+  auto pass_baseline_cuts = [&] (size_t first, size_t last) {
+    timer.start(t_baseline_cuts);
+    bool pass_all_baseline_cuts = true;
+    if (first==0) ofile->count_id(c_nocuts, w);
+    for (size_t i=first; i<last; ++i) {
+      if ( !(pass_all_baseline_cuts = ana.baseline_cuts[i].func()) ) break;
+      ofile->count_id(c_baseline_cuts[i], w);
+    }
+    timer.stop(t_baseline_cuts);
+    return pass_all_baseline_cuts;
+  };
+
+  // Data events are first only checked with the preselection baseline cuts
+  // (these use only the preselected ntuple branches) and the rest is read if they pass
+  // Skimming also uses the common variables, so there the rest is always read
+  // Events for which the rest could not be read are skipped
+  bool rest_read_failed = false;
+  auto pass_preselection = [&] () {
+    rest_read_failed = false;
+    if (!read_preselection_first) return true;
+    if (!settings.saveSkimmedNtuple && !pass_baseline_cuts(0, n_preselection_cuts)) return false;
+    timer.start(t_read);
+    rest_read_failed = !stream->read_rest();
+    timer.stop(t_read);
+    return !rest_read_failed;
+  };
+
   cout << endl;
   cout << "Start looping on events ..." << endl;
-  for(int entry=0; entry < nevents; ++entry) {
+  for (const auto& range : entry_ranges) for (int entry=range.first; entry < range.second; ++entry, ++ientry) {
+
+    timer.new_event(entry);
+    timer.start(t_event);
 
     // Read event into memory
-    stream.read(entry);
+    timer.start(t_read);
+    int localentry = read_preselection_first ? stream->read_preselection(entry) : stream->read(entry);
+    timer.stop(t_read);
     if (debug>1) std::cout<<"Analyzer::main: reading entry ok"<<std::endl;
 
+    // Events of input files that could not be read (with skipBadFiles)
+    // are counted, so the normalization can be corrected
+    if (localentry==itreestream::kSKIPPED) {
+      ofile->count("nevents_skipped", 1);
+      ofile->count("skipped: "+stream->filename(entry), 1);
+      timer.stop(t_event);
+      metrics.update(ientry, nevents, *stream);
+      if (use_checkpoints && checkpoint_due(ientry+1)) write_checkpoint(ientry+1);
+      continue;
+    }
+
+    // Random numbers (eg. for smearing) are seeded for each event
+    // so results do not depend on how events are split between workers
+    ana.set_random_seed(entry);
+
     if ( entry%100000==0 ) cout << entry << " events analyzed." << endl;
 
-    ofile->count("nevents", 1);
+    ofile->count_id(c_nevents, 1);
 
     if ( cmdline.isData ) {
       syst.index = 0;
@@ -390,29 +740,32 @@ int main(int argc, char** argv) {
 	ana.sf_weight[region.first] = 1;
 
       // Only analyze events that are in the JSON file
-      if (settings.useJSON ? json_run_ls[data.evt.RunNumber][data.evt.LumiBlock] : 1) {
+      if ((settings.useJSON ? json_lumi_mask.contains(data.evt.RunNumber, data.evt.LumiBlock) : 1) && pass_preselection()) {
 
 	// Calculate variables that do not exist in the ntuple
+	timer.start(t_common_variables);
 	ana.calculate_common_variables(data, syst.index);
+	timer.stop(t_common_variables);
 	if (debug>1) std::cout<<"Analyzer::main: calculate_common_variables ok"<<std::endl;
+	timer.start(t_variables);
 	ana.calculate_variables(data, syst.index);
+	timer.stop(t_variables);
 	if (debug>1) std::cout<<"Analyzer::main: calculate_variables ok"<<std::endl;
 
 	// If option (saveSkimmedNtuple) is specified save all 
 	// skimmed events selected by the analysis to the output file
 	// tree is copied and current weight is saved as "eventWeight"
 	if ( settings.saveSkimmedNtuple ) {
-	  if (ana.pass_skimming(data)) ofile->addEvent(w);
+	  if (ana.pass_skimming(data)) {
+	    if (settings.saveDerivedTree) ana.fill_derived_variables(data);
+	    ofile->addEvent(w);
+	  }
 	  if (debug>1) std::cout<<"Analyzer::main: adding skimmed event ok"<<std::endl;
 	} else {
 
 	  // Save counts (after each baseline cuts)
-	  ofile->count("NoCuts", w);
-	  bool pass_all_baseline_cuts = true;
-	  for (const auto& cut : ana.baseline_cuts) {
-	    if ( !(pass_all_baseline_cuts = cut.func()) ) break;
-	    ofile->count(cut.name, w);
-	  }
+	  // (already done for the preselection cuts, if it was read first)
+	  bool pass_all_baseline_cuts = pass_baseline_cuts(read_preselection_first ? n_preselection_cuts : 0, ana.baseline_cuts.size());
 	  if (debug>1) std::cout<<"Analyzer::main: saving baseline cut counts ok"<<std::endl;
 
 	  // _______________________________________________________
@@ -442,20 +795,28 @@ int main(int argc, char** argv) {
 	    // You specify there also which cut is applied for each histo
 	    // But all common baseline cuts are alreay applied above
 	    if (!cmdline.noPlots) {
+	      timer.start(t_common_histos);
 	      ana.fill_common_histos(data, syst.index, w);
+	      timer.stop(t_common_histos);
 	      if (debug>1) std::cout<<"Analyzer::main: fill_common_histos ok"<<std::endl;
+	      timer.start(t_analysis_histos);
 	      ana.fill_analysis_histos(data, syst.index, w);
+	      timer.stop(t_analysis_histos);
 	      if (debug>1) std::cout<<"Analyzer::main: fill_analysis_histos ok"<<std::endl;
 	    }
 
 	    // Save counts for the analysis cuts in each search region (signal/control)
+	    timer.start(t_analysis_cuts);
+	    size_t r = 0;
 	    for (const auto& search_region : ana.analysis_cuts) {
 	      bool pass_all_regional_cuts = true;
-	      for (const auto& cut : search_region.second) {
-		if ( !(pass_all_regional_cuts = cut.func()) ) break;
-		ofile->count(std::string(1,search_region.first)+"_cut_"+cut.name, w);
+	      for (size_t i=0, n=search_region.second.size(); i<n; ++i) {
+		if ( !(pass_all_regional_cuts = search_region.second[i].func()) ) break;
+		ofile->count_id(c_analysis_cuts[r][i], w);
 	      }
+	      ++r;
 	    }
+	    timer.stop(t_analysis_cuts);
 	    if (debug>1) std::cout<<"Analyzer::main: saving analysis cut counts ok"<<std::endl;
 
 	  } // end Blinding
@@ -463,6 +824,10 @@ int main(int argc, char** argv) {
 	} // end not skimming
 
       } // end JSON file cut
+      else if (rest_read_failed) {
+	ofile->count("nevents_skipped", 1);
+	ofile->count("skipped: "+stream->filename(entry), 1);
+      }
 
       if (debug>1) std::cout<<"Analyzer::main: end data event"<<std::endl;
     } // End DATA
@@ -472,49 +837,66 @@ int main(int argc, char** argv) {
       if ( settings.saveSkimmedNtuple ) {
 
 	// Scale and Smear Jets and MET
+	timer.start(t_rescale_smear);
 	ana.rescale_smear_jet_met(data, settings.applySmearing, syst.index, syst.nSigmaJES[syst.index],
 				  syst.nSigmaJER[syst.index], syst.nSigmaRestMET[syst.index]);
+	timer.stop(t_rescale_smear);
 	if (debug>1) std::cout<<"Analyzer::main: rescale_smear_jet_met ok"<<std::endl;
 
 	// Calculate variables that do not exist in the ntuple
+	timer.start(t_common_variables);
 	ana.calculate_common_variables(data, syst.index);
+	timer.stop(t_common_variables);
 	if (debug>1) std::cout<<"Analyzer::main: calculate_common_variables ok"<<std::endl;
+	timer.start(t_variables);
 	ana.calculate_variables(data, syst.index);
+	timer.stop(t_variables);
 	if (debug>1) std::cout<<"Analyzer::main: calculate_variables ok"<<std::endl;
 
 	// If option (saveSkimmedNtuple) is specified save all 
 	// skimmed events selected by the analysis to the output file
 	// tree is copied and current weight is saved as "eventWeight"
-	if (ana.pass_skimming(data)) ofile->addEvent(w);
+	if (ana.pass_skimming(data)) {
+	  if (settings.saveDerivedTree) ana.fill_derived_variables(data);
+	  ofile->addEvent(w);
+	}
 	if (debug>1) std::cout<<"Analyzer::main: adding skimmed event ok"<<std::endl;
 
       } else {
 
-	// Loop and vary systematics
-	for (syst.index = 0; syst.index <= (settings.varySystematics ? syst.nSyst : 0); ++syst.index) {
-	
+	// Event weights
+	// These do not depend on the jet/MET variation, so they are calculated
+	// for all systematics in a single pass before any kinematic recalculation
+	// Signals are binned so we get the total weight separately for each bin
+	timer.start(t_weights);
+	if (cmdline.isSignal) {
+	  int bin = vh_weightnorm_signal[signal_index]->FindBin(signal_index ? data.evt.SUSY_Stop_Mass : data.evt.SUSY_Gluino_Mass, data.evt.SUSY_LSP_Mass);
+	  weightnorm = vh_weightnorm_signal[signal_index]->GetBinContent(bin);
+	}
+	if (debug>1) std::cout<<"Analyzer::main: calculate signal weight ok"<<std::endl;
+	// Top pt weight without variation (loop on gen particles only once)
+	double w_toppt_nom = doTopPtReweighting ? ana.get_toppt_nominal(data) : 1;
+	for (const auto& index : syst.order) {
+	  syst.index = index;
+
+	  // Weights that do not apply to this variation stay 1
+	  // (not the value of the previously evaluated variation)
 	  w = 1;
+	  ana.all_weights.assign(ana.all_weights.size(), 1);
 
-	  // Event weights
 	  // Lumi normalization
-	  // Signals are binned so we get the total weight separately for each bin
-	  if (cmdline.isSignal) {
-	    int bin = vh_weightnorm_signal[signal_index]->FindBin(signal_index ? data.evt.SUSY_Stop_Mass : data.evt.SUSY_Gluino_Mass, data.evt.SUSY_LSP_Mass);
-	    weightnorm = vh_weightnorm_signal[signal_index]->GetBinContent(bin);
-	  }
-	  if (debug>1) std::cout<<"Analyzer::main: calculate signal weight ok"<<std::endl;
 	  // Normalize to chosen luminosity, also consider symmeteric up/down variation in lumi uncertainty
 	  
 	  w *= (ana.all_weights[0] = ana.get_syst_weight(data.evt.Gen_Weight*weightnorm, settings.lumiUncertainty, syst.nSigmaLumi[syst.index]));
-	  if (syst.index==0) ofile->count("w_lumi", w);
+	  if (syst.index==0) ofile->count_id(c_w_lumi, w);
 	  if (debug==-1) std::cout<<syst.index<<" lumi = "<<ana.get_syst_weight(data.evt.Gen_Weight*weightnorm, settings.lumiUncertainty, syst.nSigmaLumi[syst.index]);
 	  if (debug>1) std::cout<<"Analyzer::main: apply lumi weight ok"<<std::endl;
 
 	  // Top pt reweighting
 	  if (doTopPtReweighting) {
-	    w *= (ana.all_weights[1] = ana.get_toppt_weight(data, syst.nSigmaTopPt[syst.index]));	    
+	    w *= (ana.all_weights[1] = ana.get_toppt_weight(w_toppt_nom, syst.nSigmaTopPt[syst.index]));	    
 	  }
-	  if (syst.index==0) ofile->count("w_toppt", w);
+	  if (syst.index==0) ofile->count_id(c_w_toppt, w);
 
 	  // Pileup reweighting (Currently only do for Background)
 	  if (syst.index == 0) h_nvtx->Fill(data.evt.NGoodVtx, w);
@@ -525,7 +907,7 @@ int main(int argc, char** argv) {
 	  }
 	  if (syst.index==0) {
 	    h_nvtx_rw->Fill(data.evt.NGoodVtx, w);
-	    ofile->count("w_pileup", w);
+	    ofile->count_id(c_w_pileup, w);
 	  }
 	  if (debug==-1) std::cout<<" pileup = "<<ana.get_pileup_weight(data.pu.NtrueInt, syst.nSigmaPU[syst.index]);
 	  if (debug>1) std::cout<<"Analyzer::main: apply pileup weight ok"<<std::endl;
@@ -541,7 +923,7 @@ int main(int argc, char** argv) {
 	  // If vector was not filled (LO samples), not doing any weighting
 	  if ( data.syst_alphas.Weights.size() == 2 )
 	    w *= (ana.all_weights[2] = ana.get_alphas_weight(data.syst_alphas.Weights, syst.nSigmaAlphaS[syst.index], data.evt.LHA_PDF_ID));
-	  if (syst.index==0) ofile->count("w_alphas", w);
+	  if (syst.index==0) ofile->count_id(c_w_alphas, w);
 	  if (debug==-1) std::cout<<" alpha_s = "<<ana.get_alphas_weight(data.syst_alphas.Weights, syst.nSigmaAlphaS[syst.index], data.evt.LHA_PDF_ID);
 	  if (debug>1) std::cout<<"Analyzer::main: apply alphas weight ok"<<std::endl;
 
@@ -550,7 +932,7 @@ int main(int argc, char** argv) {
 	  // If numScale=0 is specified, not doing any weighting
 	  if ( syst.numScale[syst.index] >= 1 && syst.numScale[syst.index] <= 3 )
 	    w *= (ana.all_weights[3] = ana.get_scale_weight(data.syst_scale.Weights, syst.nSigmaScale[syst.index], syst.numScale[syst.index]));
-	  if (syst.index==0) ofile->count("w_scale", w);
+	  if (syst.index==0) ofile->count_id(c_w_scale, w);
 	  if (debug==-1) std::cout<<" scale = "<<ana.get_scale_weight(data.syst_scale.Weights, syst.nSigmaScale[syst.index], syst.numScale[syst.index]);
 	  // PDF weights
 	  // A set of 100 weights for the nominal PDF
@@ -559,7 +941,7 @@ int main(int argc, char** argv) {
 	    w *= (ana.all_weights[4] = data.syst_pdf.Weights[syst.numPdf[syst.index]-1]);
 	  else if ( syst.numPdf[syst.index] > data.syst_pdf.Weights.size() )
 	    utils::error("numPdf (syst) specified is larger than the number of PDF weights in the ntuple");
-	  if (syst.index==0) ofile->count("w_pdf", w);
+	  if (syst.index==0) ofile->count_id(c_w_pdf, w);
 	  if (debug==-1) std::cout<<" pdf = "<<(syst.numPdf[syst.index]>0 ? data.syst_pdf.Weights[syst.numPdf[syst.index]-1] : 1);
 	  if (debug>1) std::cout<<"Analyzer::main: apply pwd weight ok"<<std::endl;
 
@@ -576,20 +958,43 @@ int main(int argc, char** argv) {
 	  //  }
 	  //  if (debug>1) std::cout<<"Analyzer::main: apply special weights ok"<<std::endl;
 
-	  // Scale and Smear Jets and MET
-	  ana.rescale_smear_jet_met(data, settings.applySmearing, syst.index, syst.nSigmaJES[syst.index],
-				    syst.nSigmaJER[syst.index], syst.nSigmaRestMET[syst.index]);
-	  if (debug>1) std::cout<<"Analyzer::main: rescale_smear_jet_met ok"<<std::endl;
+	  syst_weight[syst.index] = w;
+	  syst_all_weights[syst.index] = ana.all_weights;
+	} // end systematics weights
+	timer.stop(t_weights);
 
-	  // Calculate variables that do not exist in the ntuple
-	  ana.calculate_common_variables(data, syst.index);
-	  if (debug>1) std::cout<<"Analyzer::main: calculate_common_variables ok"<<std::endl;
-	  ana.calculate_variables(data, syst.index);
-	  if (debug>1) std::cout<<"Analyzer::main: calculate_variables ok"<<std::endl;
+	// Loop and vary systematics
+	// Jets/MET are only rescaled (and variables recalculated) when the shift changes
+	unsigned int last_shape = 0, last_sfs = 0;
+	for (const auto& index : syst.order) {
+	  syst.index = index;
+	  bool new_shape = syst.index==0 || !syst.same_shape(syst.index, last_shape);
+	  w = syst_weight[syst.index];
+	  ana.all_weights = syst_all_weights[syst.index];
+
+	  if (new_shape) {
+	    // Scale and Smear Jets and MET
+	    timer.start(t_rescale_smear);
+	    ana.rescale_smear_jet_met(data, settings.applySmearing, syst.index, syst.nSigmaJES[syst.index],
+				      syst.nSigmaJER[syst.index], syst.nSigmaRestMET[syst.index]);
+	    timer.stop(t_rescale_smear);
+	    if (debug>1) std::cout<<"Analyzer::main: rescale_smear_jet_met ok"<<std::endl;
+
+	    // Calculate variables that do not exist in the ntuple
+	    timer.start(t_common_variables);
+	    ana.calculate_common_variables(data, syst.index);
+	    timer.stop(t_common_variables);
+	    if (debug>1) std::cout<<"Analyzer::main: calculate_common_variables ok"<<std::endl;
+	    timer.start(t_variables);
+	    ana.calculate_variables(data, syst.index);
+	    timer.stop(t_variables);
+	    if (debug>1) std::cout<<"Analyzer::main: calculate_variables ok"<<std::endl;
+	    last_shape = syst.index;
+	  }
 
 	  // Apply Trigger Efficiency Scale Factor
 	  w *= (ana.all_weights[5] = ana.calc_trigger_efficiency(data, syst.nSigmaTrigger[syst.index]));
-	  if (syst.index==0) ofile->count("w_trigger", w);
+	  if (syst.index==0) ofile->count_id(c_w_trigger, w);
 	  if (debug==-1) std::cout<<" trigger = "<<ana.calc_trigger_efficiency(data, syst.nSigmaTrigger[syst.index]);
 	  if (debug>1) std::cout<<"Analyzer::main: apply trigger weight ok"<<std::endl;
 
@@ -598,7 +1003,13 @@ int main(int argc, char** argv) {
 	    ana.sf_weight[region.first] = w;
 	  if (settings.applyScaleFactors) {
 	    // Analysis specific scale factors (region dependent)
-	    ana.apply_scale_factors(data, syst.index, syst.nSigmaSFs);
+	    // Only recalculated if the objects or the SF variations changed
+	    if (new_shape || !syst.same_sfs(syst.index, last_sfs)) {
+	      timer.start(t_scale_factors);
+	      ana.apply_scale_factors(data, syst.index, syst.nSigmaSFs);
+	      timer.stop(t_scale_factors);
+	      last_sfs = syst.index;
+	    }
 	    // Multiply weight with calculated SFs
 	    for (const auto& region : ana.scale_factors)
 	      for (const auto& sf : region.second)
@@ -610,13 +1021,7 @@ int main(int argc, char** argv) {
 	  // First cuts that are likely to be implemented in all analyses
 	  // eg. MET filters, baseline event selection etc.
 	  bool pass_all_baseline_cuts = true;
-	  if (syst.index == 0) {
-	    if (syst.index==0) ofile->count("NoCuts", w);
-	    for (const auto& cut : ana.baseline_cuts) {
-	      if ( !(pass_all_baseline_cuts = cut.func()) ) break; 
-	      if (syst.index==0) ofile->count(cut.name, w);
-	    }
-	  }
+	  if (syst.index == 0) pass_all_baseline_cuts = pass_baseline_cuts(0, ana.baseline_cuts.size());
 	  if (debug>1) std::cout<<"Analyzer::main: counting baseline events ok"<<std::endl;
 
 	  if (pass_all_baseline_cuts) {
@@ -625,30 +1030,41 @@ int main(int argc, char** argv) {
 	    // You specify there also which cut is applied for each histo
 	    // But all common baseline cuts will be already applied above
 	    if (!cmdline.noPlots) {
+	      timer.start(t_common_histos);
 	      ana.fill_common_histos(data, syst.index, w);
+	      timer.stop(t_common_histos);
 	      if (debug>1) std::cout<<"Analyzer::main: fill_common_histos ok"<<std::endl;
+	      timer.start(t_analysis_histos);
 	      ana.fill_analysis_histos(data, syst.index, w);
+	      timer.stop(t_analysis_histos);
 	      if (debug>1) std::cout<<"Analyzer::main: fill_analysis_histos ok"<<std::endl;
 	    }
 
 	    // Save counts for the analysis cuts in each search region (signal/control)
+	    if (syst.index==0) timer.start(t_analysis_cuts);
+	    size_t r = 0;
 	    if (syst.index==0) for (const auto& search_region : ana.analysis_cuts) {
 	      // First apply cuts
 	      bool pass_all_regional_cuts = true;
-	      for (const auto& cut : search_region.second) {
-		if ( !(pass_all_regional_cuts = cut.func()) ) break;
-		if (syst.index==0) ofile->count(std::string(1,search_region.first)+"_cut_"+cut.name, w);
+	      for (size_t i=0, n=search_region.second.size(); i<n; ++i) {
+		if ( !(pass_all_regional_cuts = search_region.second[i].func()) ) break;
+		if (syst.index==0) ofile->count_id(c_analysis_cuts[r][i], w);
 	      }
 	      // Then apply scale factors
 	      if (settings.applyScaleFactors && pass_all_regional_cuts) {
 		double sf_w = w;
-		for (size_t i=0, n=ana.scale_factors[search_region.first].size(); i<n; ++i) {
-		  sf_w *= ana.scale_factors[search_region.first][i];
-		  if (syst.index==0) ofile->count(std::string(1,search_region.first)+"_sf_"+std::to_string(i+1), sf_w);
+		const std::vector<double>& sfs = ana.scale_factors[search_region.first];
+		for (size_t i=0, n=sfs.size(); i<n; ++i) {
+		  sf_w *= sfs[i];
+		  // (a region can have more SFs than at the start, add a counter for those)
+		  if (i==c_scale_factors[r].size()) c_scale_factors[r].push_back(sf_counter(search_region.first, i));
+		  if (syst.index==0) ofile->count_id(c_scale_factors[r][i], sf_w);
 		  if (debug==-1) std::cout<<", "<<sf_w;
 		}
 	      }
+	      ++r;
 	    }
+	    if (syst.index==0) timer.stop(t_analysis_cuts);
 	    if (debug>1) std::cout<<"Analyzer::main: counting analysis events, scale factors ok"<<std::endl;
 	    if (debug==-1) std::cout<<"  w = "<<w<<std::endl;
 
@@ -659,18 +1075,60 @@ int main(int argc, char** argv) {
     } // end Background/Signal MC
     if (debug==-1) std::cout<<"---------------------------------------"<<std::endl<<std::endl;
 
+    timer.stop(t_event);
+
     // Measure speed (useful info for batch/parallel jobs)
-    ana.job_monitoring(entry, nevents, stream.filename());
+    ana.job_monitoring(ientry, nevents, stream->filename());
+    metrics.update(ientry, nevents, *stream);
     if (debug>1) std::cout<<"Analyzer::main: job_monitoring ok, end event"<<std::endl;
 
+    if (use_checkpoints && checkpoint_due(ientry+1)) write_checkpoint(ientry+1);
+
   } // end event loop
+  // A final checkpoint, so a resumed job only redoes the merging
+  if (use_checkpoints) write_checkpoint(nevents);
   if (debug) std::cout<<"Analyzer::main: event loop ok"<<std::endl;
+  if (debug) ana.common_variables.print_counts();
+
+  stream->close();
+
+  // ---------------------------------------------------------------------------
+  // -- Merge results of parallel workers                                     --
+  // ---------------------------------------------------------------------------
+
+  if (worker>0) {
+    TFile* f_worker = TFile::Open(worker_file("_worker"+std::to_string(worker)).c_str(), "RECREATE");
+    write_partial_results(f_worker);
+    f_worker->Close();
+    cout << flush;
+    _exit(0);
+  }
+  for (size_t i=0; i<worker_pids.size(); ++i) {
+    int status = 0;
+    waitpid(worker_pids[i], &status, 0);
+    std::string filename = worker_file("_worker"+std::to_string(i+1));
+    TFile* f_worker = TFile::Open(filename.c_str());
+    if (!WIFEXITED(status) || WEXITSTATUS(status)!=0 || !f_worker || f_worker->IsZombie())
+      utils::error("worker "+std::to_string(i+1)+" did not finish, output not found: "+filename);
+    add_partial_results(f_worker);
+    std::remove(filename.c_str());
+  }
+  if (debug) std::cout<<"Analyzer::main: merge workers ok"<<std::endl;
+
+  if (cmdline.timing) {
+    timer.write(out_dir);
+    timer.print();
+  }
 
-  stream.close();
   out_dir->cd();
   if (!cmdline.noPlots)
     ana.save_analysis_histos();
   ofile->close();
+
+  // Output is complete, checkpoints are no longer needed
+  if (use_checkpoints)
+    for (int i=0; i<cmdline.nThreads; ++i)
+      std::remove(worker_file("_checkpoint" + (i ? std::to_string(i) : std::string())).c_str());
   if (debug) std::cout<<"Analyzer::main: all ok"<<std::endl;
   return 0;
 }
@@ -20,6 +20,14 @@
 #include "GluinoXSec.h"
 #include "StopXSec.h"
 #include "Razor.h"
+#include "LumiMask.h"
+#include "MetricsStream.h"
+#include "SampleIndex.h"
+#include "PassMask.h"
+#include "FourVector.h"
+#include "DeltaRMatch.h"
+#include "DerivedVariables.h"
+#include "HemisphereCache.h"
 
 #include "BTagCalibrationStandalone.cpp"
 
@@ -63,14 +71,30 @@ public:
     delete sw_job_;
   }
 
-  typedef struct Cut { std::string name; std::function<bool()> func; } Cut;
+  // preselection: the cut uses only the preselection branches (no common variables),
+  // so it can be applied before the rest of the event is read (readPreselectionFirst)
+  typedef struct Cut { std::string name; std::function<bool()> func; bool preselection; } Cut;
   std::vector<Cut> baseline_cuts;
 
   // Functions used by the Analyzer
   void define_preselections(const DataStruct&);
 
+  // Common variables, and what they depend on (calculated only when needed)
+  void define_common_variables(DataStruct&);
+
   void calculate_common_variables(DataStruct&, const unsigned int&);
 
+  DerivedVariables common_variables;
+
+  // Calculated by calculate_common_variables (all by default), an analysis
+  // that reads only some of them can reduce the list
+  std::vector<std::string> common_variable_groups = { "leptons", "photons", "jetsAK4", "jetsAK8", "gen", "razor" };
+
+  // Friend tree of the skim with the variables calculated above
+  void init_derived_tree(TTree*);
+
+  void fill_derived_variables(DataStruct&);
+
   void init_common_histos();
 
   void fill_common_histos(DataStruct&, const unsigned int&, const double&);
@@ -88,6 +112,10 @@ public:
 
   double get_toppt_weight(DataStruct&, const double&);
 
+  double get_toppt_weight(const double&, const double&);
+
+  double get_toppt_nominal(DataStruct&);
+
   double get_pileup_weight(const int&, const double&);
 
   void rescale_smear_jet_met(DataStruct&, const bool&, const unsigned int&, const double&, const double&, const double&);
@@ -104,6 +132,22 @@ public:
 
   void job_monitoring(const int&, const int&, const std::string&, const float);
 
+  void set_random_seed(const unsigned int& seed) { rnd_.SetSeed(seed+1); } // 0 would mean a random (time based) seed
+
+  // Save/restore the state of the random generator (used for checkpoints)
+  void write_random_state(TDirectory* dir) { dir->WriteTObject(&rnd_, "random_state"); }
+
+  void read_random_state(TFile* f)
+  {
+    TRandom3* rnd = (TRandom3*)f->Get("random_state");
+    if (rnd == 0) utils::error("random_state not found in file " + std::string(f->GetName()));
+    rnd_ = *rnd;
+    delete rnd;
+  }
+
+  // Take the cross-section and total weights from the sample index instead of opening the files
+  void use_sample_index(const SampleIndex* index) { index_ = index; }
+
   void init_syst_input();
 
   double calc_top_tagging_sf(DataStruct&, const double&, const double&, const bool&);
@@ -149,6 +193,7 @@ private:
 
   TStopwatch *sw_1_, *sw_1k_, *sw_10k_, *sw_job_;
   TRandom3 rnd_;
+  const SampleIndex* index_ = 0;
   std::map<std::string, int> bad_files;
 
   BTagCalibration* btag_calib_full_;
@@ -161,6 +206,23 @@ private:
   TF1* puppisd_corrGEN_      = 0;
   TF1* puppisd_corrRECO_cen_ = 0;
   TF1* puppisd_corrRECO_for_ = 0;
+
+  // Groups of common variables (see define_common_variables)
+  void calc_leptons_(DataStruct&);
+  void calc_photons_(DataStruct&);
+  void calc_jetsAK4_(DataStruct&);
+  void calc_jetsAK8_(DataStruct&);
+  void calc_gen_(DataStruct&);
+  void calc_razor_(DataStruct&);
+
+  // Buffers of the derived tree (the rest is read from the globals)
+  // Objects: jetsAK4, jetsAK8, ele, mu, pho
+  static const size_t nDerivedObjects_ = 5;
+  double derived_MR_, derived_MTR_, derived_R_, derived_R2_;
+  float  derived_hemi_Pt_[2], derived_hemi_Eta_[2], derived_hemi_Phi_[2], derived_hemi_M_[2];
+  int    derived_size_[nDerivedObjects_];
+  std::vector<unsigned int> derived_mask_[nDerivedObjects_];
+  TBranch* b_derived_mask_[nDerivedObjects_];
 };
 
 // _____________________________________________________________
@@ -227,18 +289,18 @@ AnalysisBase::define_preselections(const DataStruct& data)
   // NGoodVtx defined in:
   // https://github.com/jkarancs/B2GTTrees/blob/v8.0.x_v2.1_Oct24/plugins/B2GEdmExtraVarProducer.cc#L528-L531
   // baseline_cuts.push_back({ .name="met_filter_NGoodVtx",          .func = [&data] { return data.evt.NGoodVtx>0; } });
-  baseline_cuts.push_back({ .name="Clean_goodVertices",      .func = [&data] { return data.filter.goodVertices; } });
+  baseline_cuts.push_back({ .name="Clean_goodVertices",      .func = [&data] { return data.filter.goodVertices; }, .preselection=true });
   
   // Other filters (in 80X MiniAODv2)
   // https://twiki.cern.ch/twiki/bin/view/CMS/MissingETOptionalFiltersRun2?rev=101#What_is_available_in_MiniAOD
-  baseline_cuts.push_back({ .name="Clean_CSC_Halo_Tight",    .func = [&data,this] { return isSignal ? 1 : data.filter.globalTightHalo2016Filter; } });
-  baseline_cuts.push_back({ .name="Clean_HBHE_Noise",        .func = [&data] { return data.filter.HBHENoiseFilter; } });
-  baseline_cuts.push_back({ .name="Clean_HBHE_IsoNoise",     .func = [&data] { return data.filter.HBHENoiseIsoFilter; } });
-  baseline_cuts.push_back({ .name="Clean_Ecal_Dead_Cell_TP", .func = [&data] { return data.filter.EcalDeadCellTriggerPrimitiveFilter; } });
-  baseline_cuts.push_back({ .name="Clean_EE_Bad_Sc",         .func = [&data,this] { return isData ? data.filter.eeBadScFilter : 1; } });
+  baseline_cuts.push_back({ .name="Clean_CSC_Halo_Tight",    .func = [&data,this] { return isSignal ? 1 : data.filter.globalTightHalo2016Filter; }, .preselection=true });
+  baseline_cuts.push_back({ .name="Clean_HBHE_Noise",        .func = [&data] { return data.filter.HBHENoiseFilter; }, .preselection=true });
+  baseline_cuts.push_back({ .name="Clean_HBHE_IsoNoise",     .func = [&data] { return data.filter.HBHENoiseIsoFilter; }, .preselection=true });
+  baseline_cuts.push_back({ .name="Clean_Ecal_Dead_Cell_TP", .func = [&data] { return data.filter.EcalDeadCellTriggerPrimitiveFilter; }, .preselection=true });
+  baseline_cuts.push_back({ .name="Clean_EE_Bad_Sc",         .func = [&data,this] { return isData ? data.filter.eeBadScFilter : 1; }, .preselection=true });
   // Not in MiniAODv2 (producer added)
-  baseline_cuts.push_back({ .name="Clean_Bad_Muon",          .func = [&data] { return data.filter.BadPFMuonFilter; } });
-  baseline_cuts.push_back({ .name="Clean_Bad_Charged",       .func = [&data] { return data.filter.BadChargedCandidateFilter; } });
+  baseline_cuts.push_back({ .name="Clean_Bad_Muon",          .func = [&data] { return data.filter.BadPFMuonFilter; }, .preselection=true });
+  baseline_cuts.push_back({ .name="Clean_Bad_Charged",       .func = [&data] { return data.filter.BadChargedCandidateFilter; }, .preselection=true });
 }
 
 
@@ -588,16 +650,17 @@ AnalysisBase::rescale_smear_jet_met(DataStruct& data, const bool& applySmearing,
   // Initialization (needed for later variations
   if (syst_index==0) {
     // Save the original values for later (before applying any systematics)
-    AK4_E            = data.jetsAK4.E;
-    AK4_Pt           = data.jetsAK4.Pt;
-    AK8_E            = data.jetsAK8.E;
-    AK8_Pt           = data.jetsAK8.Pt;
+    // (assign reuses the memory of the previous event)
+    AK4_E           .assign(data.jetsAK4.E.begin(),  data.jetsAK4.E.end());
+    AK4_Pt          .assign(data.jetsAK4.Pt.begin(), data.jetsAK4.Pt.end());
+    AK8_E           .assign(data.jetsAK8.E.begin(),  data.jetsAK8.E.end());
+    AK8_Pt          .assign(data.jetsAK8.Pt.begin(), data.jetsAK8.Pt.end());
 #if VER == 0
-    AK8_softDropMass = data.jetsAK8.softDropMass;
+    AK8_softDropMass.assign(data.jetsAK8.softDropMass.begin(), data.jetsAK8.softDropMass.end());
 #elif VER == 1
-    AK8_softDropMass = data.jetsAK8.softDropMassPuppi;
+    AK8_softDropMass.assign(data.jetsAK8.softDropMassPuppi.begin(), data.jetsAK8.softDropMassPuppi.end());
 #else
-    AK8_softDropMass = data.jetsAK8.corrSDMassPuppi;
+    AK8_softDropMass.assign(data.jetsAK8.corrSDMassPuppi.begin(), data.jetsAK8.corrSDMassPuppi.end());
 #endif
     //AK8_trimmedMass  = data.jetsAK8.trimmedMass;
     //AK8_prunedMass   = data.jetsAK8.prunedMass;
@@ -610,7 +673,7 @@ AnalysisBase::rescale_smear_jet_met(DataStruct& data, const bool& applySmearing,
 #if VER < 2
       AK8_softDropMassCorr = AK8_softDropMass;
 #else
-      AK8_softDropMassCorr = data.jetsAK8.uncorrSDMassPuppi;
+      AK8_softDropMassCorr.assign(data.jetsAK8.uncorrSDMassPuppi.begin(), data.jetsAK8.uncorrSDMassPuppi.end());
 #endif
     } else {
       AK8_softDropMassCorr.clear();
@@ -820,6 +883,9 @@ AnalysisBase::rescale_smear_jet_met(DataStruct& data, const bool& applySmearing,
   TVector3 shifted_met = met + dmet;
   data.met.Pt[0]  = shifted_met.Pt();
   data.met.Phi[0] = shifted_met.Phi();
+
+  // Only the variables depending on the jets/MET are recalculated
+  common_variables.invalidate("jets");
 }
 
 
@@ -856,11 +922,11 @@ std::vector<size_t > itJet;
 std::vector<size_t > itLooseBTag;
 std::vector<size_t > itMediumBTag;
 std::vector<size_t > itTightBTag;
-std::vector<bool> passLooseJet;
-std::vector<bool> passLooseJetNoLep;
-std::vector<bool> passLooseBTag;
-std::vector<bool> passMediumBTag;
-std::vector<bool> passTightBTag;
+PassMask passLooseJet;
+PassMask passLooseJetNoLep;
+PassMask passLooseBTag;
+PassMask passMediumBTag;
+PassMask passTightBTag;
 unsigned int nJet;
 unsigned int nJetNoLep;
 unsigned int nLooseBTag;
@@ -897,18 +963,18 @@ std::vector<float> softDropMassTop;
 #if VER == 0
 std::vector<double> maxSubjetCSV;
 #endif
-std::vector<bool> passSubjetBTag;
-std::vector<bool> passLooseJetAK8;
-std::vector<bool> passWMassTag;
-std::vector<bool> passLooseWTag;
-std::vector<bool> passTightWTag;
-std::vector<bool> passTightWAntiTag;
-std::vector<bool> passHadTopTag;
-std::vector<bool> passHadTopMassTag;
-std::vector<bool> passHadTop0BMassTag;
-std::vector<bool> passHadTop0BAntiTag;
-std::vector<bool> hasGenW;
-std::vector<bool> hasGenTop;
+PassMask passSubjetBTag;
+PassMask passLooseJetAK8;
+PassMask passWMassTag;
+PassMask passLooseWTag;
+PassMask passTightWTag;
+PassMask passTightWAntiTag;
+PassMask passHadTopTag;
+PassMask passHadTopMassTag;
+PassMask passHadTop0BMassTag;
+PassMask passHadTop0BAntiTag;
+PassMask hasGenW;
+PassMask hasGenTop;
 unsigned int nJetAK8;
 unsigned int nWMassTag;
 unsigned int nLooseWTag;
@@ -939,14 +1005,14 @@ std::vector<size_t > iEleTight;
 std::vector<size_t > iMuTight;
 std::vector<size_t > itEleTight;
 std::vector<size_t > itMuTight;
-std::vector<bool> passEleVeto;
-std::vector<bool> passMuVeto;
-std::vector<bool> passEleLoose;
-std::vector<bool> passMuLoose;
-std::vector<bool> passEleSelect;
-std::vector<bool> passMuSelect;
-std::vector<bool> passEleTight;
-std::vector<bool> passMuTight;
+PassMask passEleVeto;
+PassMask passMuVeto;
+PassMask passEleLoose;
+PassMask passMuLoose;
+PassMask passEleSelect;
+PassMask passMuSelect;
+PassMask passEleTight;
+PassMask passMuTight;
 std::vector<double> eleJetDR;
 std::vector<double> eleJetDPhi;
 std::vector<double> eleJetPt;
@@ -970,19 +1036,30 @@ unsigned int nLepSelect;
 unsigned int nLepTight;
 std::vector<size_t > iPhotonSelect;
 std::vector<size_t > itPhotonSelect;
-std::vector<bool> passPhotonSelect;
+PassMask passPhotonSelect;
 unsigned int nPhotonSelect;
 double MT, MT_vetolep;
 double MET_ll, MTR_ll, R_ll, R2_ll, minDeltaPhi_ll, M_ll;
 double MET_pho, MTR_pho, R_pho, R2_pho, minDeltaPhi_pho; 
 double dPhi_ll_met, dPhi_ll_jet;
 std::vector<TLorentzVector> hemis_AK4;
+HemisphereCache hemis_AK4_cache;
+
+// Four-vectors of the objects, made once per call of calculate_common_variables
+std::vector<FourVector> v4_ele, v4_mu, v4_pho, v4_gen, v4_AK4, v4_AK8;
+// DeltaR/DeltaPhi of all pairs between the collections
+DeltaRMatch match_AK4_tightlep, match_ele_AK4, match_mu_AK4, match_AK8_AK4, match_gen_AK8;
+// Leptons, photons and MET + lepton pair/photon used by the jet and Razor variables
+std::vector<FourVector> veto_leptons_noiso, veto_leptons, selected_leptons, tight_leptons, selected_photons;
+std::vector<float> r_iso_tight_leptons;
+FourVector lep_pair;
+TVector3 met_ll, met_pho;
 
 // gen particles
-std::vector<bool> passGenHadW;
-std::vector<bool> passGenTop;
-std::vector<bool> genHadWPassWTag;
-std::vector<bool> genTopPassTopTag;
+PassMask passGenHadW;
+PassMask passGenTop;
+PassMask genHadWPassWTag;
+PassMask genTopPassTopTag;
 std::vector<size_t > iGenHadW,   itGenHadW;
 std::vector<size_t > iGenTop,    itGenTop;
 std::vector<size_t > iGenMassW,   itGenMassW;
@@ -998,321 +1075,353 @@ int nTopTag;
 int nmTopTag;
 int npreTopTag;
 
+// Number of objects in a collection for the selection masks (0 if it is not read, like Loop())
+template <class Collection> size_t nobjects(const Collection& c) { return c.size==9999 ? 0 : c.size; }
+
+//_______________________________________________________
+//       Common variables, calculated when needed
+
+// Each group of variables is calculated only when something it depends on changed:
+// "event" (the next event is read) or "jets" (jets and MET, changed by rescale_smear_jet_met)
+// So eg. the lepton IDs are calculated once per event, not for each systematic variation
+void
+AnalysisBase::define_common_variables(DataStruct& data)
+{
+  common_variables.define("event");
+  common_variables.define("jets",    {"event"});
+  // Leptons (also AK8 substructure, MT and M_ll) do not depend on the jet energy
+  common_variables.define("leptons", {"event"},                            [this, &data] { calc_leptons_(data);  });
+  // Photons and MET + lepton pair/photon
+  common_variables.define("photons", {"jets", "leptons"},                  [this, &data] { calc_photons_(data);  });
+  common_variables.define("jetsAK4", {"jets", "leptons", "photons"},       [this, &data] { calc_jetsAK4_(data);  });
+  common_variables.define("jetsAK8", {"jets", "leptons", "jetsAK4"},       [this, &data] { calc_jetsAK8_(data);  });
+  common_variables.define("gen",     {"event", "jetsAK8"},                 [this, &data] { calc_gen_(data);      });
+  common_variables.define("razor",   {"jetsAK4", "leptons", "photons"},    [this, &data] { calc_razor_(data);    });
+}
+
 void
 AnalysisBase::calculate_common_variables(DataStruct& data, const unsigned int& syst_index)
 {
-  std::vector<TLorentzVector> veto_leptons_noiso, veto_leptons, selected_leptons, tight_leptons;
-  std::vector<float> r_iso_tight_leptons;
-  TLorentzVector lep_pair;
-  //std::vector<TLorentzVector> veto_muons_noiso, veto_muons, selected_muons;
-  //std::vector<bool> veto_lep_in_jet;
-  //std::vector<bool> veto_mu_in_jet, selected_mu_in_jet;
-
-  // It only makes sense to calculate certain variables only once if they don't depend on jet energy
-  if (syst_index == 0) {
+  // The nominal (first) call is for a new event, the others follow rescale_smear_jet_met
+  if (syst_index == 0) common_variables.invalidate("event");
+  else {
+    // The leptons are only used for the nominal (the systematic variations
+    // have no lepton-jet cleaning and MET_ll/MTR_ll are calculated without
+    // the lepton pair), the IDs (and M_ll etc.) are kept
+    veto_leptons_noiso .clear();
+    veto_leptons       .clear();
+    selected_leptons   .clear();
+    tight_leptons      .clear();
+    r_iso_tight_leptons.clear();
+    lep_pair = FourVector();
+  }
+  for (const auto& name : common_variable_groups) common_variables.get(name);
+}
 
-    // Loop on AK8 jets
-    tau21         .assign(data.jetsAK8.size, 9999);
-    tau31         .assign(data.jetsAK8.size, 9999);
-    tau32         .assign(data.jetsAK8.size, 9999);
+void
+AnalysisBase::calc_leptons_(DataStruct& data)
+{
+  veto_leptons_noiso.clear();
+  veto_leptons      .clear();
+  selected_leptons  .clear();
+  tight_leptons     .clear();
+  r_iso_tight_leptons.clear();
+  fillFourVectors(v4_ele, nobjects(data.ele), data.ele);
+  fillFourVectors(v4_mu,  nobjects(data.mu),  data.mu);
+  fillFourVectors(v4_pho, nobjects(data.pho), data.pho);
+  fillFourVectors(v4_gen, nobjects(data.gen), data.gen);
+
+  // Loop on AK8 jets
+  tau21         .assign(data.jetsAK8.size, 9999);
+  tau31         .assign(data.jetsAK8.size, 9999);
+  tau32         .assign(data.jetsAK8.size, 9999);
 #if VER == 0
-    maxSubjetCSV .assign(data.jetsAK8.size, 0);
+  maxSubjetCSV .assign(data.jetsAK8.size, 0);
 #endif
-    passSubjetBTag.assign(data.jetsAK8.size, 0);
-    nSubjetBTag = 0;
-    while(data.jetsAK8.Loop()) {
-      size_t i = data.jetsAK8.it;
-      // N-subjettiness
+  passSubjetBTag.assign(data.jetsAK8.size, 0);
+  nSubjetBTag = 0;
+  while(data.jetsAK8.Loop()) {
+    size_t i = data.jetsAK8.it;
+    // N-subjettiness
 #if VER == 0
-      if (data.jetsAK8.tau1[i]>0) tau21[i] = data.jetsAK8.tau2[i]/data.jetsAK8.tau1[i];
-      if (data.jetsAK8.tau1[i]>0) tau31[i] = data.jetsAK8.tau3[i]/data.jetsAK8.tau1[i];
-      if (data.jetsAK8.tau2[i]>0) tau32[i] = data.jetsAK8.tau3[i]/data.jetsAK8.tau2[i];
-      // Maximum Subjet btag discriminator
-      maxSubjetCSV[i] = -9999;
-      int i_sj0 = data.jetsAK8.vSubjetIndex0[i], i_sj1 = data.jetsAK8.vSubjetIndex1[i];
-      if (i_sj0 != -1) if (data.subjetsAK8.CSVv2[i_sj0] > maxSubjetCSV[i]) maxSubjetCSV[i] = data.subjetsAK8.CSVv2[i_sj0];
-      if (i_sj1 != -1) if (data.subjetsAK8.CSVv2[i_sj1] > maxSubjetCSV[i]) maxSubjetCSV[i] = data.subjetsAK8.CSVv2[i_sj1];
+    if (data.jetsAK8.tau1[i]>0) tau21[i] = data.jetsAK8.tau2[i]/data.jetsAK8.tau1[i];
+    if (data.jetsAK8.tau1[i]>0) tau31[i] = data.jetsAK8.tau3[i]/data.jetsAK8.tau1[i];
+    if (data.jetsAK8.tau2[i]>0) tau32[i] = data.jetsAK8.tau3[i]/data.jetsAK8.tau2[i];
+    // Maximum Subjet btag discriminator
+    maxSubjetCSV[i] = -9999;
+    int i_sj0 = data.jetsAK8.vSubjetIndex0[i], i_sj1 = data.jetsAK8.vSubjetIndex1[i];
+    if (i_sj0 != -1) if (data.subjetsAK8.CSVv2[i_sj0] > maxSubjetCSV[i]) maxSubjetCSV[i] = data.subjetsAK8.CSVv2[i_sj0];
+    if (i_sj1 != -1) if (data.subjetsAK8.CSVv2[i_sj1] > maxSubjetCSV[i]) maxSubjetCSV[i] = data.subjetsAK8.CSVv2[i_sj1];
 #if USE_BTAG == 1
-      if (passSubjetBTag[i] = (maxSubjetCSV[i] >= TOP_BTAG_CSV) ) nSubjetBTag++;
+    if (passSubjetBTag[i] = (maxSubjetCSV[i] >= TOP_BTAG_CSV) ) nSubjetBTag++;
 #else
-      if (passSubjetBTag[i] = (maxSubjetCSV[i] >= B_SUBJET_CSV_LOOSE_CUT) ) nSubjetBTag++;
+    if (passSubjetBTag[i] = (maxSubjetCSV[i] >= B_SUBJET_CSV_LOOSE_CUT) ) nSubjetBTag++;
 #endif
 #else
-      if (data.jetsAK8.tau1Puppi[i]>0) tau21[i] = data.jetsAK8.tau2Puppi[i]/data.jetsAK8.tau1Puppi[i];
-      if (data.jetsAK8.tau1Puppi[i]>0) tau31[i] = data.jetsAK8.tau3Puppi[i]/data.jetsAK8.tau1Puppi[i];
-      if (data.jetsAK8.tau2Puppi[i]>0) tau32[i] = data.jetsAK8.tau3Puppi[i]/data.jetsAK8.tau2Puppi[i];
-      // Maximum Subjet btag discriminator
+    if (data.jetsAK8.tau1Puppi[i]>0) tau21[i] = data.jetsAK8.tau2Puppi[i]/data.jetsAK8.tau1Puppi[i];
+    if (data.jetsAK8.tau1Puppi[i]>0) tau31[i] = data.jetsAK8.tau3Puppi[i]/data.jetsAK8.tau1Puppi[i];
+    if (data.jetsAK8.tau2Puppi[i]>0) tau32[i] = data.jetsAK8.tau3Puppi[i]/data.jetsAK8.tau2Puppi[i];
+#endif
+  }
+#if VER != 0
+  // Maximum Subjet btag discriminator
+  passSubjetBTag.select(nobjects(data.jetsAK8), [&data] (size_t i) {
 #if USE_BTAG == 1
-      if (passSubjetBTag[i] = (data.jetsAK8.maxSubjetCSVv2[i] >= TOP_BTAG_CSV) ) nSubjetBTag++;
+			  return data.jetsAK8.maxSubjetCSVv2[i] >= TOP_BTAG_CSV;
 #else
-      if (passSubjetBTag[i] = (data.jetsAK8.maxSubjetCSVv2[i] >= B_SUBJET_CSV_LOOSE_CUT) ) nSubjetBTag++;
+			  return data.jetsAK8.maxSubjetCSVv2[i] >= B_SUBJET_CSV_LOOSE_CUT;
 #endif
+			});
+  nSubjetBTag = passSubjetBTag.count();
 #endif
-    }
 
-    // Event Letpons
-    iEleVeto     .clear();
-    iEleLoose    .clear();
-    iEleSelect   .clear();
-    iEleTight    .clear();
-    itEleVeto    .assign(data.ele.size, (size_t)-1);
-    itEleLoose   .assign(data.ele.size, (size_t)-1);
-    itEleSelect  .assign(data.ele.size, (size_t)-1);
-    itEleTight   .assign(data.ele.size, (size_t)-1);
-    passEleVeto  .assign(data.ele.size, 0);
-    passEleLoose .assign(data.ele.size, 0);
-    passEleSelect.assign(data.ele.size, 0);
-    passEleTight .assign(data.ele.size, 0);
-    nEleVetoNoIso = nEleVeto = nEleLoose = nEleSelect = nEleTight = 0;
-    while(data.ele.Loop()) {
-      size_t i = data.ele.it;
-      TLorentzVector ele_v4; ele_v4.SetPtEtaPhiE(data.ele.Pt[i], data.ele.Eta[i], data.ele.Phi[i], data.ele.E[i]);
-      float pt = data.ele.Pt[i];
-      float abseta = std::abs(data.ele.Eta[i]);
-      float miniIso = data.ele.MiniIso[i]/data.ele.Pt[i];
-      float absd0 = std::abs(data.ele.Dxy[i]);
-      float absdz = std::abs(data.ele.Dz[i]);
-      float ipsig = std::abs(data.ele.DB[i])/data.ele.DBerr[i];
+  // Event Letpons
+  iEleVeto     .clear();
+  iEleLoose    .clear();
+  iEleSelect   .clear();
+  iEleTight    .clear();
+  itEleVeto    .assign(data.ele.size, (size_t)-1);
+  itEleLoose   .assign(data.ele.size, (size_t)-1);
+  itEleSelect  .assign(data.ele.size, (size_t)-1);
+  itEleTight   .assign(data.ele.size, (size_t)-1);
+  passEleVeto  .assign(data.ele.size, 0);
+  passEleLoose .assign(data.ele.size, 0);
+  passEleSelect.assign(data.ele.size, 0);
+  passEleTight .assign(data.ele.size, 0);
+  nEleVetoNoIso = nEleVeto = nEleLoose = nEleSelect = nEleTight = 0;
+  while(data.ele.Loop()) {
+    size_t i = data.ele.it;
+    const FourVector& ele_v4 = v4_ele[i];
+    float pt = data.ele.Pt[i];
+    float abseta = std::abs(data.ele.Eta[i]);
+    float miniIso = data.ele.MiniIso[i]/data.ele.Pt[i];
+    float absd0 = std::abs(data.ele.Dxy[i]);
+    float absdz = std::abs(data.ele.Dz[i]);
+    float ipsig = std::abs(data.ele.DB[i])/data.ele.DBerr[i];
 #if USE_MVA_ID == 1
-      // https://twiki.cern.ch/twiki/bin/view/CMS/SUSLeptonSF?rev=210#Electrons
-      //VLoose WP, pT > 10 GeV. A/B values are -0.48/-0.85, -0.67/-0.91, -0.49/-0.83 for |eta| [0, 0.8], [0.8, 1.479], [1.479, 2.5]
-      //  In addition, for pT 5-10, the following values are used on the HZZ MVA: 0.46, -0.03, 0.06 for |eta| [0, 0.8], [0.8, 1.479], [1.479, 2.5] 
-      int categ = data.ele.vidMvaHZZcateg[i];
-      double mva = categ<3 ? data.ele.vidMvaHZZvalue[i] : data.ele.vidMvaGPvalue[i];
-      std::vector<double> cut = { 
-	// pt<10
-	0.46, -0.03, 0.06, 
-	// pt>=10
-	std::min(-0.48, std::max(-0.85 , -0.48 + (-0.85 - -0.48)/10.0*(pt-15))),
-	std::min(-0.67, std::max(-0.91 , -0.67 + (-0.91 - -0.67)/10.0*(pt-15))),
-	std::min(-0.49, std::max(-0.83 , -0.49 + (-0.83 - -0.49)/10.0*(pt-15)))
-      };
-      bool id_veto_noiso = (mva>cut[categ]);
+    // https://twiki.cern.ch/twiki/bin/view/CMS/SUSLeptonSF?rev=210#Electrons
+    //VLoose WP, pT > 10 GeV. A/B values are -0.48/-0.85, -0.67/-0.91, -0.49/-0.83 for |eta| [0, 0.8], [0.8, 1.479], [1.479, 2.5]
+    //  In addition, for pT 5-10, the following values are used on the HZZ MVA: 0.46, -0.03, 0.06 for |eta| [0, 0.8], [0.8, 1.479], [1.479, 2.5] 
+    int categ = data.ele.vidMvaHZZcateg[i];
+    double mva = categ<3 ? data.ele.vidMvaHZZvalue[i] : data.ele.vidMvaGPvalue[i];
+    std::vector<double> cut = { 
+      // pt<10
+      0.46, -0.03, 0.06, 
+      // pt>=10
+      std::min(-0.48, std::max(-0.85 , -0.48 + (-0.85 - -0.48)/10.0*(pt-15))),
+      std::min(-0.67, std::max(-0.91 , -0.67 + (-0.91 - -0.67)/10.0*(pt-15))),
+      std::min(-0.49, std::max(-0.83 , -0.49 + (-0.83 - -0.49)/10.0*(pt-15)))
+    };
+    bool id_veto_noiso = (mva>cut[categ]);
 #else
-      bool id_veto_noiso = (data.ele.vidVetonoiso[i] == 1.0);
+    bool id_veto_noiso = (data.ele.vidVetonoiso[i] == 1.0);
 #endif
-      bool id_loose_noiso = (data.ele.vidLoosenoiso[i] == 1.0);
-      bool id_select_noiso = (data.ele.vidMediumnoiso[i] == 1.0);
-      bool id_tight  = (data.ele.vidTight[i] == 1.0);
-      //bool id_veto = (data.ele.vidVeto[i] == 1.0);
-      //bool id_select = (data.ele.vidTight[i] == 1.0);
-      // Veto
-      if (passEleVeto[i] = 
-	  ( id_veto_noiso &&
-	    pt      >= ELE_VETO_PT_CUT &&
-	    abseta  <  ELE_VETO_ETA_CUT && !(abseta>=1.442 && abseta< 1.556) &&
-	    absd0   <  ELE_VETO_IP_D0_CUT &&
-	    absdz   <  ELE_VETO_IP_DZ_CUT) ) {
-	veto_leptons_noiso.push_back(ele_v4);
-	nEleVetoNoIso++;
-	if (miniIso <  ELE_VETO_MINIISO_CUT) {
-	  iEleVeto.push_back(i);
-	  itEleVeto[i] = nEleVeto++;
-	  veto_leptons.push_back(ele_v4);
-	  //veto_lep_in_jet.push_back(data.ele.IsPartOfNearAK4Jet[i]);
-	}
-      }
-      // Loose
-      if (passEleLoose[i] = 
-	  ( id_loose_noiso &&
-	    pt        >= ELE_LOOSE_PT_CUT &&
-	    abseta    <  ELE_LOOSE_ETA_CUT && !(abseta>=1.442 && abseta< 1.556) &&
-	    miniIso   <  ELE_LOOSE_MINIISO_CUT &&
-	    absd0     <  ELE_LOOSE_IP_D0_CUT &&
-	    absdz     <  ELE_LOOSE_IP_DZ_CUT) ) {
-	iEleLoose.push_back(i);
-	itEleLoose[i] = nEleLoose++;
-      }
-      // Select
-      if (passEleSelect[i] = 
-	  ( id_select_noiso &&
-	    pt        >= ELE_SELECT_PT_CUT &&
-	    abseta    <  ELE_SELECT_ETA_CUT && !(abseta>=1.442 && abseta< 1.556) &&
-	    miniIso   <  ELE_SELECT_MINIISO_CUT &&
-	    absd0     <  ELE_SELECT_IP_D0_CUT &&
-	    absdz     <  ELE_SELECT_IP_DZ_CUT) ) {
-	selected_leptons.push_back(ele_v4);
-	iEleSelect.push_back(i);
-	itEleSelect[i] = nEleSelect++;
-      }
-      // Tight
-      if (passEleTight[i] = 
-	  ( id_tight &&
-	    pt        >= ELE_TIGHT_PT_CUT &&
-	    abseta    <  ELE_TIGHT_ETA_CUT && !(abseta>=1.442 && abseta< 1.556) &&
-	    absd0     <  ELE_TIGHT_IP_D0_CUT &&
-	    absdz     <  ELE_TIGHT_IP_DZ_CUT &&
-	    ipsig     <  ELE_TIGHT_IP_SIG_CUT) ) {
-	tight_leptons.push_back(ele_v4);
-	iEleTight.push_back(i);
-	itEleTight[i] = nEleTight++;
-	float r_iso = std::max(0.05, std::min(0.2, 10./pt));
-	r_iso_tight_leptons.push_back(r_iso);
+    bool id_loose_noiso = (data.ele.vidLoosenoiso[i] == 1.0);
+    bool id_select_noiso = (data.ele.vidMediumnoiso[i] == 1.0);
+    bool id_tight  = (data.ele.vidTight[i] == 1.0);
+    //bool id_veto = (data.ele.vidVeto[i] == 1.0);
+    //bool id_select = (data.ele.vidTight[i] == 1.0);
+    // Veto
+    if (passEleVeto[i] = 
+	( id_veto_noiso &&
+	  pt      >= ELE_VETO_PT_CUT &&
+	  abseta  <  ELE_VETO_ETA_CUT && !(abseta>=1.442 && abseta< 1.556) &&
+	  absd0   <  ELE_VETO_IP_D0_CUT &&
+	  absdz   <  ELE_VETO_IP_DZ_CUT) ) {
+      veto_leptons_noiso.push_back(ele_v4);
+      nEleVetoNoIso++;
+      if (miniIso <  ELE_VETO_MINIISO_CUT) {
+	iEleVeto.push_back(i);
+	itEleVeto[i] = nEleVeto++;
+	veto_leptons.push_back(ele_v4);
+	//veto_lep_in_jet.push_back(data.ele.IsPartOfNearAK4Jet[i]);
       }
     }
-
-    // Number of Veto/Select Muons
-    iMuVeto      .clear();
-    iMuLoose     .clear();
-    iMuSelect    .clear();
-    iMuTight     .clear();
-    itMuVeto     .assign(data.mu.size,  (size_t)-1);
-    itMuLoose    .assign(data.mu.size,  (size_t)-1);
-    itMuSelect   .assign(data.mu.size,  (size_t)-1);
-    itMuTight    .assign(data.mu.size,  (size_t)-1);
-    passMuVeto   .assign(data.mu.size,  0);
-    passMuLoose  .assign(data.mu.size,  0);
-    passMuSelect .assign(data.mu.size,  0);
-    passMuTight  .assign(data.mu.size,  0);
-    nMuVetoNoIso = nMuVeto = nMuLoose = nMuSelect = nMuTight = 0;
-    while(data.mu.Loop()) {
-      size_t i = data.mu.it;
-      TLorentzVector mu_v4; mu_v4.SetPtEtaPhiE(data.mu.Pt[i], data.mu.Eta[i], data.mu.Phi[i], data.mu.E[i]);
-      float pt = data.mu.Pt[i];
-      float abseta = std::abs(data.mu.Eta[i]);
-      float miniIso = data.mu.MiniIso[i]/data.mu.Pt[i];
-      float relIso = data.mu.Iso04[i];
-      float absd0 = std::abs(data.mu.Dxy[i]);
-      float absdz = std::abs(data.mu.Dz[i]);
-      float ipsig = std::abs(data.mu.DB[i])/data.mu.DBerr[i];
-      bool id_veto_noiso   = (data.mu.IsLooseMuon[i] == 1.0);
-      bool id_loose_noiso  = (data.mu.IsLooseMuon[i] == 1.0);
-      bool id_select_noiso = (data.mu.IsMediumMuon[i] == 1.0);
-      bool id_tight_noiso  = (data.mu.IsTightMuon[i] == 1.0);
-      // Veto
-      if (passMuVeto[i] =
-	  (id_veto_noiso &&
-	   pt      >= MU_VETO_PT_CUT &&
-	   abseta  <  MU_VETO_ETA_CUT &&
-	   absd0   <  MU_VETO_IP_D0_CUT &&
-	   absdz   <  MU_VETO_IP_DZ_CUT) ) {
-	veto_leptons_noiso.push_back(mu_v4);
-	//veto_muons_noiso.push_back(mu_v4);
-	nMuVetoNoIso++;
-	if (miniIso <  MU_VETO_MINIISO_CUT) {
-	  iMuVeto.push_back(i);
-	  itMuVeto[i] = nMuVeto++;
-	  veto_leptons.push_back(mu_v4);
-	  //veto_muons.push_back(mu_v4);
-	  //veto_lep_in_jet.push_back(data.mu.IsPartOfNearAK4Jet[i]);
-	  //veto_mu_in_jet.push_back(data.mu.IsPartOfNearAK4Jet[i]);
-	}
-      }
-      // Loose
-      if (passMuLoose[i] =
-	  ( id_loose_noiso &&
-	    pt      >= MU_LOOSE_PT_CUT &&
-	    abseta  <  MU_LOOSE_ETA_CUT &&
-	    miniIso <  MU_LOOSE_MINIISO_CUT &&
-	    absd0   <  MU_LOOSE_IP_D0_CUT &&
-	    absdz   <  MU_LOOSE_IP_DZ_CUT) ) {
-	iMuLoose.push_back(i);
-	itMuLoose[i] = nMuLoose++;
-      }
-      // Select
-      if (passMuSelect[i] =
-	  ( id_select_noiso &&
-	    pt      >= MU_SELECT_PT_CUT &&
-	    abseta  <  MU_SELECT_ETA_CUT &&
-	    miniIso <  MU_SELECT_MINIISO_CUT &&
-	    absd0   <  MU_SELECT_IP_D0_CUT &&
-	    absdz   <  MU_SELECT_IP_DZ_CUT) ) {
-	selected_leptons.push_back(mu_v4);
-	//selected_muons.push_back(mu_v4);
-	iMuSelect.push_back(i);
-	itMuSelect[i] = nMuSelect++;
-	//selected_mu_in_jet.push_back(data.mu.IsPartOfNearAK4Jet[i]);
-      }
-      // Tight
-      if (passMuTight[i] =
-	  ( id_tight_noiso &&
-	    pt      >= MU_TIGHT_PT_CUT &&
-	    abseta  <  MU_TIGHT_ETA_CUT &&
-	    relIso  <  MU_TIGHT_RELISO_CUT &&
-	    absd0   <  MU_TIGHT_IP_D0_CUT &&
-	    absdz   <  MU_TIGHT_IP_DZ_CUT &&
-	    ipsig   <  MU_TIGHT_IP_SIG_CUT) ) {
-	tight_leptons.push_back(mu_v4);
-	iMuTight.push_back(i);
-	itMuTight[i] = nMuTight++;
-	float r_iso = std::max(0.05, std::min(0.2, 10./pt));
-	r_iso_tight_leptons.push_back(r_iso);
-      }
-    } // end of muon loop
-
-    nLepVetoNoIso = nEleVetoNoIso + nMuVetoNoIso;
-    nLepVeto      = nEleVeto   + nMuVeto;
-    nLepLoose     = nEleLoose  + nMuLoose;
-    nLepSelect    = nEleSelect + nMuSelect;
-    nLepTight     = nEleTight  + nMuTight;
-
-    // MT
-    MT = 9999;
-    if (nLepSelect==1) {
-      if (nEleSelect==1) {
-	MT = sqrt( 2*data.ele.Pt[iEleSelect[0]]*data.met.Pt[0] * (1 - std::cos(data.met.Phi[0]-data.ele.Phi[iEleSelect[0]])) );
-      } else if (nMuSelect==1) {
-	MT = sqrt( 2*data.mu.Pt[iMuSelect[0]]*data.met.Pt[0] * (1 - std::cos(data.met.Phi[0]-data.mu.Phi[iMuSelect[0]])) );
-      }
+    // Loose
+    if (passEleLoose[i] = 
+	( id_loose_noiso &&
+	  pt        >= ELE_LOOSE_PT_CUT &&
+	  abseta    <  ELE_LOOSE_ETA_CUT && !(abseta>=1.442 && abseta< 1.556) &&
+	  miniIso   <  ELE_LOOSE_MINIISO_CUT &&
+	  absd0     <  ELE_LOOSE_IP_D0_CUT &&
+	  absdz     <  ELE_LOOSE_IP_DZ_CUT) ) {
+      iEleLoose.push_back(i);
+      itEleLoose[i] = nEleLoose++;
     }
-    MT_vetolep = 9999;
-    if (nLepVeto==1) {
-      if (nEleVeto==1) {
-	MT_vetolep = sqrt( 2*data.ele.Pt[iEleVeto[0]]*data.met.Pt[0] * (1 - std::cos(data.met.Phi[0]-data.ele.Phi[iEleVeto[0]])) );
-      } else if (nMuVeto==1) {
-	MT_vetolep = sqrt( 2*data.mu.Pt[iMuVeto[0]]*data.met.Pt[0] * (1 - std::cos(data.met.Phi[0]-data.mu.Phi[iMuVeto[0]])) );
-      }
+    // Select
+    if (passEleSelect[i] = 
+	( id_select_noiso &&
+	  pt        >= ELE_SELECT_PT_CUT &&
+	  abseta    <  ELE_SELECT_ETA_CUT && !(abseta>=1.442 && abseta< 1.556) &&
+	  miniIso   <  ELE_SELECT_MINIISO_CUT &&
+	  absd0     <  ELE_SELECT_IP_D0_CUT &&
+	  absdz     <  ELE_SELECT_IP_DZ_CUT) ) {
+      selected_leptons.push_back(ele_v4);
+      iEleSelect.push_back(i);
+      itEleSelect[i] = nEleSelect++;
     }
-    
-    // M_ll, dPhi_ll_met
-    M_ll = -9999;
-    dPhi_ll_met = 9999;
-    lep_pair.SetPxPyPzE(0,0,0,0);
-    if (nLepSelect==2) {
-      TLorentzVector lep1, lep2;
-      if (nEleSelect==2) {
-	lep1.SetPtEtaPhiE(data.ele.Pt[iEleSelect[0]], data.ele.Eta[iEleSelect[0]], data.ele.Phi[iEleSelect[0]], data.ele.E[iEleSelect[0]]);
-	lep2.SetPtEtaPhiE(data.ele.Pt[iEleSelect[1]], data.ele.Eta[iEleSelect[1]], data.ele.Phi[iEleSelect[1]], data.ele.E[iEleSelect[1]]);
-	lep_pair = lep1+lep2;
-	M_ll = lep_pair.M();
-	dPhi_ll_met = std::abs(TVector2::Phi_mpi_pi(lep_pair.Phi() - data.met.Phi[0]));
-      } else if (nMuSelect==2) {
-	lep1.SetPtEtaPhiE(data.mu.Pt[iMuSelect[0]], data.mu.Eta[iMuSelect[0]], data.mu.Phi[iMuSelect[0]], data.mu.E[iMuSelect[0]]);
-	lep2.SetPtEtaPhiE(data.mu.Pt[iMuSelect[1]], data.mu.Eta[iMuSelect[1]], data.mu.Phi[iMuSelect[1]], data.mu.E[iMuSelect[1]]);
-	lep_pair = lep1+lep2;
-	M_ll = lep_pair.M();
-	dPhi_ll_met = std::abs(TVector2::Phi_mpi_pi(lep_pair.Phi() - data.met.Phi[0]));
-      }
+    // Tight
+    if (passEleTight[i] = 
+	( id_tight &&
+	  pt        >= ELE_TIGHT_PT_CUT &&
+	  abseta    <  ELE_TIGHT_ETA_CUT && !(abseta>=1.442 && abseta< 1.556) &&
+	  absd0     <  ELE_TIGHT_IP_D0_CUT &&
+	  absdz     <  ELE_TIGHT_IP_DZ_CUT &&
+	  ipsig     <  ELE_TIGHT_IP_SIG_CUT) ) {
+      tight_leptons.push_back(ele_v4);
+      iEleTight.push_back(i);
+      itEleTight[i] = nEleTight++;
+      float r_iso = std::max(0.05, std::min(0.2, 10./pt));
+      r_iso_tight_leptons.push_back(r_iso);
     }
-  } // end if (syst_index==0)
+  }
 
-  // Event Letpons
-  std::vector<TLorentzVector> selected_photons;
-  iPhotonSelect   .clear();
-  itPhotonSelect  .assign(data.pho.size, (size_t)-1);
-  passPhotonSelect.assign(data.pho.size, 0);
-  nPhotonSelect = 0;
-  while(data.pho.Loop()) {
-    size_t i = data.pho.it;
-    TLorentzVector pho_v4; pho_v4.SetPtEtaPhiE(data.pho.Pt[i], data.pho.Eta[i], data.pho.Phi[i], data.pho.E[i]);
-    float pt = data.pho.Pt[i];
-    float abseta = std::abs(data.pho.Eta[i]);
-    bool ele_veto = (data.pho.ElectronVeto[i]==1);
-    bool id_select = data.pho.PassMediumID[i];
+  // Number of Veto/Select Muons
+  iMuVeto      .clear();
+  iMuLoose     .clear();
+  iMuSelect    .clear();
+  iMuTight     .clear();
+  itMuVeto     .assign(data.mu.size,  (size_t)-1);
+  itMuLoose    .assign(data.mu.size,  (size_t)-1);
+  itMuSelect   .assign(data.mu.size,  (size_t)-1);
+  itMuTight    .assign(data.mu.size,  (size_t)-1);
+  passMuVeto   .assign(data.mu.size,  0);
+  passMuLoose  .assign(data.mu.size,  0);
+  passMuSelect .assign(data.mu.size,  0);
+  passMuTight  .assign(data.mu.size,  0);
+  nMuVetoNoIso = nMuVeto = nMuLoose = nMuSelect = nMuTight = 0;
+  while(data.mu.Loop()) {
+    size_t i = data.mu.it;
+    const FourVector& mu_v4 = v4_mu[i];
+    float pt = data.mu.Pt[i];
+    float abseta = std::abs(data.mu.Eta[i]);
+    float miniIso = data.mu.MiniIso[i]/data.mu.Pt[i];
+    float relIso = data.mu.Iso04[i];
+    float absd0 = std::abs(data.mu.Dxy[i]);
+    float absdz = std::abs(data.mu.Dz[i]);
+    float ipsig = std::abs(data.mu.DB[i])/data.mu.DBerr[i];
+    bool id_veto_noiso   = (data.mu.IsLooseMuon[i] == 1.0);
+    bool id_loose_noiso  = (data.mu.IsLooseMuon[i] == 1.0);
+    bool id_select_noiso = (data.mu.IsMediumMuon[i] == 1.0);
+    bool id_tight_noiso  = (data.mu.IsTightMuon[i] == 1.0);
+    // Veto
+    if (passMuVeto[i] =
+	(id_veto_noiso &&
+	 pt      >= MU_VETO_PT_CUT &&
+	 abseta  <  MU_VETO_ETA_CUT &&
+	 absd0   <  MU_VETO_IP_D0_CUT &&
+	 absdz   <  MU_VETO_IP_DZ_CUT) ) {
+      veto_leptons_noiso.push_back(mu_v4);
+      //veto_muons_noiso.push_back(mu_v4);
+      nMuVetoNoIso++;
+      if (miniIso <  MU_VETO_MINIISO_CUT) {
+	iMuVeto.push_back(i);
+	itMuVeto[i] = nMuVeto++;
+	veto_leptons.push_back(mu_v4);
+	//veto_muons.push_back(mu_v4);
+	//veto_lep_in_jet.push_back(data.mu.IsPartOfNearAK4Jet[i]);
+	//veto_mu_in_jet.push_back(data.mu.IsPartOfNearAK4Jet[i]);
+      }
+    }
+    // Loose
+    if (passMuLoose[i] =
+	( id_loose_noiso &&
+	  pt      >= MU_LOOSE_PT_CUT &&
+	  abseta  <  MU_LOOSE_ETA_CUT &&
+	  miniIso <  MU_LOOSE_MINIISO_CUT &&
+	  absd0   <  MU_LOOSE_IP_D0_CUT &&
+	  absdz   <  MU_LOOSE_IP_DZ_CUT) ) {
+      iMuLoose.push_back(i);
+      itMuLoose[i] = nMuLoose++;
+    }
     // Select
-    if (passPhotonSelect[i] = 
-	( id_select &&
-	  ele_veto &&
-	  pt        >= PHOTON_SELECT_PT_CUT &&
-	  abseta    <  PHOTON_SELECT_ETA_CUT) ) {
-      selected_photons.push_back(pho_v4);
-      iPhotonSelect.push_back(i);
-      itPhotonSelect[i] = nPhotonSelect++;
+    if (passMuSelect[i] =
+	( id_select_noiso &&
+	  pt      >= MU_SELECT_PT_CUT &&
+	  abseta  <  MU_SELECT_ETA_CUT &&
+	  miniIso <  MU_SELECT_MINIISO_CUT &&
+	  absd0   <  MU_SELECT_IP_D0_CUT &&
+	  absdz   <  MU_SELECT_IP_DZ_CUT) ) {
+      selected_leptons.push_back(mu_v4);
+      //selected_muons.push_back(mu_v4);
+      iMuSelect.push_back(i);
+      itMuSelect[i] = nMuSelect++;
+      //selected_mu_in_jet.push_back(data.mu.IsPartOfNearAK4Jet[i]);
+    }
+    // Tight
+    if (passMuTight[i] =
+	( id_tight_noiso &&
+	  pt      >= MU_TIGHT_PT_CUT &&
+	  abseta  <  MU_TIGHT_ETA_CUT &&
+	  relIso  <  MU_TIGHT_RELISO_CUT &&
+	  absd0   <  MU_TIGHT_IP_D0_CUT &&
+	  absdz   <  MU_TIGHT_IP_DZ_CUT &&
+	  ipsig   <  MU_TIGHT_IP_SIG_CUT) ) {
+      tight_leptons.push_back(mu_v4);
+      iMuTight.push_back(i);
+      itMuTight[i] = nMuTight++;
+      float r_iso = std::max(0.05, std::min(0.2, 10./pt));
+      r_iso_tight_leptons.push_back(r_iso);
+    }
+  } // end of muon loop
+
+  nLepVetoNoIso = nEleVetoNoIso + nMuVetoNoIso;
+  nLepVeto      = nEleVeto   + nMuVeto;
+  nLepLoose     = nEleLoose  + nMuLoose;
+  nLepSelect    = nEleSelect + nMuSelect;
+  nLepTight     = nEleTight  + nMuTight;
+
+  // MT
+  MT = 9999;
+  if (nLepSelect==1) {
+    if (nEleSelect==1) {
+      MT = sqrt( 2*data.ele.Pt[iEleSelect[0]]*data.met.Pt[0] * (1 - std::cos(data.met.Phi[0]-data.ele.Phi[iEleSelect[0]])) );
+    } else if (nMuSelect==1) {
+      MT = sqrt( 2*data.mu.Pt[iMuSelect[0]]*data.met.Pt[0] * (1 - std::cos(data.met.Phi[0]-data.mu.Phi[iMuSelect[0]])) );
+    }
+  }
+  MT_vetolep = 9999;
+  if (nLepVeto==1) {
+    if (nEleVeto==1) {
+      MT_vetolep = sqrt( 2*data.ele.Pt[iEleVeto[0]]*data.met.Pt[0] * (1 - std::cos(data.met.Phi[0]-data.ele.Phi[iEleVeto[0]])) );
+    } else if (nMuVeto==1) {
+      MT_vetolep = sqrt( 2*data.mu.Pt[iMuVeto[0]]*data.met.Pt[0] * (1 - std::cos(data.met.Phi[0]-data.mu.Phi[iMuVeto[0]])) );
+    }
+  }
+  
+  // M_ll, dPhi_ll_met
+  M_ll = -9999;
+  dPhi_ll_met = 9999;
+  lep_pair = FourVector();
+  if (nLepSelect==2) {
+    if (nEleSelect==2) {
+      lep_pair = v4_ele[iEleSelect[0]]+v4_ele[iEleSelect[1]];
+      M_ll = lep_pair.M();
+      dPhi_ll_met = std::abs(TVector2::Phi_mpi_pi(lep_pair.Phi() - data.met.Phi[0]));
+    } else if (nMuSelect==2) {
+      lep_pair = v4_mu[iMuSelect[0]]+v4_mu[iMuSelect[1]];
+      M_ll = lep_pair.M();
+      dPhi_ll_met = std::abs(TVector2::Phi_mpi_pi(lep_pair.Phi() - data.met.Phi[0]));
     }
   }
+}
+
+void
+AnalysisBase::calc_photons_(DataStruct& data)
+{
+  // Event Letpons
+  selected_photons.clear();
+  // Select
+  passPhotonSelect.select(nobjects(data.pho), [&data] (size_t i) {
+			    return ( (data.pho.PassMediumID[i] != 0) &
+				     (data.pho.ElectronVeto[i] == 1) &
+				     (data.pho.Pt[i]           >= PHOTON_SELECT_PT_CUT) &
+				     (std::abs(data.pho.Eta[i]) <  PHOTON_SELECT_ETA_CUT) );
+			  });
+  nPhotonSelect = passPhotonSelect.indices(iPhotonSelect, itPhotonSelect);
+  for (size_t i : passPhotonSelect) selected_photons.push_back(v4_pho[i]);
 
   // Add the lepton pair to MET
-  TVector3 met_ll;
   met_ll.SetPtEtaPhi(data.met.Pt[0], 0, data.met.Phi[0]);
   if (M_ll!=-9999) {
     TVector3 lep_pair_met;
@@ -1321,102 +1430,90 @@ AnalysisBase::calculate_common_variables(DataStruct& data, const unsigned int& s
   }
 
   // Add the photon to MET
-  TVector3 met_pho;
   met_pho.SetPtEtaPhi(data.met.Pt[0], 0, data.met.Phi[0]);
   if (nPhotonSelect==1) {
     TVector3 pho_met;
     pho_met.SetPtEtaPhi(selected_photons[0].Pt(), 0, selected_photons[0].Phi());
     met_pho += pho_met;
   }
+}
+
+void
+AnalysisBase::calc_jetsAK4_(DataStruct& data)
+{
+  fillFourVectors(v4_AK4, nobjects(data.jetsAK4), data.jetsAK4);
 
   // Rest of the vairables need to be recalculated each time the jet energy is changed
   // eg. Jet selection, W/top tags, HT (obviously), etc. that depends on jet pt
 
   // AK4 jets
+  // Jet ID and b tagging: masks of all jets at once, the counts and indices follow from them
+  const size_t nAK4 = nobjects(data.jetsAK4);
+  passLooseJet  .select(nAK4, [&data] (size_t i) {
+			  return ( (data.jetsAK4.looseJetID[i] == 1) &
+				   (data.jetsAK4.Pt[i]         >= JET_AK4_PT_CUT) &
+				   (std::abs(data.jetsAK4.Eta[i])  <  JET_AK4_ETA_CUT) );
+			});
+  passLooseBTag .select(nAK4, [&data] (size_t i) { return data.jetsAK4.CSVv2[i] >= B_CSV_LOOSE_CUT;  });
+  passMediumBTag.select(nAK4, [&data] (size_t i) { return data.jetsAK4.CSVv2[i] >= B_CSV_MEDIUM_CUT; });
+  passTightBTag .select(nAK4, [&data] (size_t i) { return data.jetsAK4.CSVv2[i] >= B_CSV_TIGHT_CUT;  });
+  passLooseBTag  &= passLooseJet;
+  passMediumBTag &= passLooseJet;
+  passTightBTag  &= passLooseJet;
+  nJet        = passLooseJet.count();
+  nLooseBTag  = passLooseBTag .indices(iLooseBTag,  itLooseBTag);
+  nMediumBTag = passMediumBTag.indices(iMediumBTag, itMediumBTag);
+  nTightBTag  = passTightBTag .indices(iTightBTag,  itTightBTag);
+
   iJet       .clear();
-  iLooseBTag .clear();
-  iMediumBTag.clear();
-  iTightBTag .clear();
-  itJet              .assign(data.jetsAK4.size, (size_t)-1);
-  itLooseBTag        .assign(data.jetsAK4.size, (size_t)-1);
-  itMediumBTag       .assign(data.jetsAK4.size, (size_t)-1);
-  itTightBTag        .assign(data.jetsAK4.size, (size_t)-1);
-  passLooseJet       .assign(data.jetsAK4.size, 0);
-  passLooseJetNoLep  .assign(data.jetsAK4.size, 0);
-  passLooseBTag      .assign(data.jetsAK4.size, 0);
-  passMediumBTag     .assign(data.jetsAK4.size, 0);
-  passTightBTag      .assign(data.jetsAK4.size, 0);
-  nJetNoLep = nJet = 0;
-  nLooseBTag  = 0;
-  nMediumBTag = 0;
-  nTightBTag  = 0;
+  itJet              .assign(nAK4, (size_t)-1);
+  passLooseJetNoLep  .assign(nAK4, 0);
+  nJetNoLep = 0;
   AK4_Ht = AK4_HtOnline = AK4_HtNoLep = 0;
   minDeltaPhi = minDeltaPhi_ll = minDeltaPhi_pho = dPhi_ll_jet = 9999;
   //std::vector<bool> add_lepton_to_ht(veto_leptons.size(),1);
   //std::vector<bool> remove_muon_from_ht(selected_muons.size(),0);
-  while(data.jetsAK4.Loop()) {
-    size_t i = data.jetsAK4.it;
-    TLorentzVector jet_v4; jet_v4.SetPtEtaPhiE(data.jetsAK4.Pt[i], data.jetsAK4.Eta[i], data.jetsAK4.Phi[i], data.jetsAK4.E[i]);
-    // Jet ID
-    if ( passLooseJet[i] = 
-	 ( data.jetsAK4.looseJetID[i] == 1 &&
-	   data.jetsAK4.Pt[i]         >= JET_AK4_PT_CUT &&
-	   std::abs(data.jetsAK4.Eta[i])  <  JET_AK4_ETA_CUT ) ) {
-      nJet++;
-
-      // B tagging
-      if (passLooseBTag[i]  = (data.jetsAK4.CSVv2[i] >= B_CSV_LOOSE_CUT ) ) {
-	iLooseBTag.push_back(i);
-	itLooseBTag[i] = nLooseBTag++;
-      }
-      if (passMediumBTag[i] = (data.jetsAK4.CSVv2[i] >= B_CSV_MEDIUM_CUT) ) {
-	iMediumBTag.push_back(i);
-	itMediumBTag[i] = nMediumBTag++;
-      }
-      if (passTightBTag[i]  = (data.jetsAK4.CSVv2[i] >= B_CSV_TIGHT_CUT ) ) {
-	iTightBTag.push_back(i);
-	itTightBTag[i] = nTightBTag++;
+  size_t iLooseJet = 0;
+  match_AK4_tightlep.match(v4_AK4, tight_leptons);
+  for (size_t i : passLooseJet) {
+    AK4_Ht += data.jetsAK4.Pt[i];
+
+    // minDeltaPhi
+    if (++iLooseJet<=4) {
+      double dphi = std::abs(TVector2::Phi_mpi_pi(data.met.Phi[0] - data.jetsAK4.Phi[i]));
+      if (dphi<minDeltaPhi) minDeltaPhi = dphi;
+      // with added lepton pair
+      double dphi_metll = std::abs(TVector2::Phi_mpi_pi(met_ll.Phi() - data.jetsAK4.Phi[i]));
+      if (dphi_metll<minDeltaPhi_ll) minDeltaPhi_ll = dphi_metll;
+      // with added photon
+      double dphi_metpho = std::abs(TVector2::Phi_mpi_pi(met_pho.Phi() - data.jetsAK4.Phi[i]));
+      if (dphi_metpho<minDeltaPhi_pho) minDeltaPhi_pho = dphi_metpho;
+      // jet lep-pair angle
+      if (M_ll!=-9999) {
+	double dphi_ll = std::abs(TVector2::Phi_mpi_pi(lep_pair.Phi() - data.jetsAK4.Phi[i]));
+	if (dphi_ll<dPhi_ll_jet) dPhi_ll_jet = dphi_ll;
       }
+    }
 
-      AK4_Ht += data.jetsAK4.Pt[data.jetsAK4.it];
-
-      // minDeltaPhi
-      if (nJet<=4) {
-	double dphi = std::abs(TVector2::Phi_mpi_pi(data.met.Phi[0] - data.jetsAK4.Phi[i]));
-	if (dphi<minDeltaPhi) minDeltaPhi = dphi;
-	// with added lepton pair
-	double dphi_metll = std::abs(TVector2::Phi_mpi_pi(met_ll.Phi() - data.jetsAK4.Phi[i]));
-	if (dphi_metll<minDeltaPhi_ll) minDeltaPhi_ll = dphi_metll;
-	// with added photon
-	double dphi_metpho = std::abs(TVector2::Phi_mpi_pi(met_pho.Phi() - data.jetsAK4.Phi[i]));
-	if (dphi_metpho<minDeltaPhi_pho) minDeltaPhi_pho = dphi_metpho;
-	// jet lep-pair angle
-	if (M_ll!=-9999) {
-	  double dphi_ll = std::abs(TVector2::Phi_mpi_pi(lep_pair.Phi() - data.jetsAK4.Phi[i]));
-	  if (dphi_ll<dPhi_ll_jet) dPhi_ll_jet = dphi_ll;
-	}
-      }
+    // Exclude jets that have tight leptons in the isolation cone for the DeltaPhi calculation
+    float minDR = 9999;
+    float r_iso = -9999;
+    int ilep = match_AK4_tightlep.nearest(i);
+    if (ilep!=-1) {
+      minDR = match_AK4_tightlep.dR(i, ilep);
+      r_iso = r_iso_tight_leptons[ilep];
+    }
 
-      // Exclude jets that have tight leptons in the isolation cone for the DeltaPhi calculation
-      float minDR = 9999;
-      float r_iso = -9999;
-      for (size_t i=0, n=tight_leptons.size(); i<n; ++i) {
-	double DR = tight_leptons[i].DeltaR(jet_v4);
-	if (DR<minDR) {
-	  minDR=DR;
-	  r_iso = r_iso_tight_leptons[i];
-	}
-      }
+    if (passLooseJetNoLep[i] = (minDR>=r_iso)) {
+      iJet.push_back(i);
+      itJet[i] = nJetNoLep++;
+      AK4_HtNoLep += data.jetsAK4.Pt[i];
+    }
+  } // End Jet Selection
 
-      if (passLooseJetNoLep[i] = (minDR>=r_iso)) {
-	iJet.push_back(i);
-	itJet[i] = nJetNoLep++;
-	AK4_HtNoLep += data.jetsAK4.Pt[data.jetsAK4.it];
-      }
-	
-    } // End Jet Selection
-    
-    // Online jet selection for HT (+ testing Additional Loose Jet ID)
+  // Online jet selection for HT (+ testing Additional Loose Jet ID)
+  while(data.jetsAK4.Loop()) {
+    size_t i = data.jetsAK4.it;
     if ( //data.jetsAK4.looseJetID[i] == 1 &&
 	data.jetsAK4.Pt[i]         >  30 &&
 	std::abs(data.jetsAK4.Eta[i])  <  3.0 ) {
@@ -1453,44 +1550,30 @@ AnalysisBase::calculate_common_variables(DataStruct& data, const unsigned int& s
   eleJetDR     .assign(data.ele.size,  9999);
   eleJetDPhi   .assign(data.ele.size,  9999);
   eleJetPt     .assign(data.ele.size, -9999);
+  match_ele_AK4.match(v4_ele, v4_AK4);
   while(data.ele.Loop()) {
     size_t i = data.ele.it;
-    TLorentzVector ele_v4; ele_v4.SetPtEtaPhiE(data.ele.Pt[i], data.ele.Eta[i], data.ele.Phi[i], data.ele.E[i]);
     // Nearest jet info
-    while(data.jetsAK4.Loop()) {
-      size_t j = data.jetsAK4.it;
-      if (passLooseJet[j]) {
-	TLorentzVector jet_v4; jet_v4.SetPtEtaPhiE(data.jetsAK4.Pt[j], data.jetsAK4.Eta[j], data.jetsAK4.Phi[j], data.jetsAK4.E[j]);
-	double dR = ele_v4.DeltaR(jet_v4);
-	if (dR<eleJetDR[i]) {
-	  eleJetDR[i] = dR;
-	  eleJetPt[i] = data.jetsAK4.Pt[j];
-	}
-	double dPhi = std::abs(ele_v4.DeltaPhi(jet_v4));
-	if (dPhi<eleJetDPhi[i]) eleJetDPhi[i] = dPhi;
-      }
+    int j = match_ele_AK4.nearest(i, &passLooseJet);
+    if (j!=-1) {
+      eleJetDR[i] = match_ele_AK4.dR(i, j);
+      eleJetPt[i] = data.jetsAK4.Pt[j];
     }
+    eleJetDPhi[i] = match_ele_AK4.minDPhi(i, &passLooseJet);
   }
   muJetDR     .assign(data.mu.size,  9999);
   muJetDPhi   .assign(data.mu.size,  9999);
   muJetPt     .assign(data.mu.size, -9999);
+  match_mu_AK4.match(v4_mu, v4_AK4);
   while(data.mu.Loop()) {
     size_t i = data.mu.it;
-    TLorentzVector mu_v4; mu_v4.SetPtEtaPhiE(data.mu.Pt[i], data.mu.Eta[i], data.mu.Phi[i], data.mu.E[i]);
     // Nearest jet info
-    while(data.jetsAK4.Loop()) {
-      size_t j = data.jetsAK4.it;
-      if (passLooseJet[j]) {
-	TLorentzVector jet_v4; jet_v4.SetPtEtaPhiE(data.jetsAK4.Pt[j], data.jetsAK4.Eta[j], data.jetsAK4.Phi[j], data.jetsAK4.E[j]);
-	double dR = mu_v4.DeltaR(jet_v4);
-	if (dR<muJetDR[i]) {
-	  muJetDR[i] = dR;
-	  muJetPt[i] = data.jetsAK4.Pt[j];
-	}
-	double dPhi = std::abs(mu_v4.DeltaPhi(jet_v4));
-	if (dPhi<muJetDPhi[i]) muJetDPhi[i] = dPhi;
-      }
+    int j = match_mu_AK4.nearest(i, &passLooseJet);
+    if (j!=-1) {
+      muJetDR[i] = match_mu_AK4.dR(i, j);
+      muJetPt[i] = data.jetsAK4.Pt[j];
     }
+    muJetDPhi[i] = match_mu_AK4.minDPhi(i, &passLooseJet);
   }
 
 
@@ -1500,7 +1583,13 @@ AnalysisBase::calculate_common_variables(DataStruct& data, const unsigned int& s
 
   //for (size_t imu=0, nmu=selected_muons.size(); imu<nmu; ++imu)
   //  if (remove_muon_from_ht[imu]) AK4_Ht -= selected_muons[imu].Pt();
-  
+}
+
+void
+AnalysisBase::calc_jetsAK8_(DataStruct& data)
+{
+  fillFourVectors(v4_AK8, nobjects(data.jetsAK8), data.jetsAK8);
+
   // AK8 jets
   iJetAK8         .clear();
   iWMassTag       .clear();
@@ -1543,9 +1632,9 @@ AnalysisBase::calculate_common_variables(DataStruct& data, const unsigned int& s
   nHadTop0BAntiTag = 0;
   AK8_Ht   = 0;
   minDeltaR_W_b = 9999;
+  match_AK8_AK4.match(v4_AK8, v4_AK4);
   while(data.jetsAK8.Loop()) {
     size_t i = data.jetsAK8.it;
-    TLorentzVector AK8_v4; AK8_v4.SetPtEtaPhiE(data.jetsAK8.Pt[i], data.jetsAK8.Eta[i], data.jetsAK8.Phi[i], data.jetsAK8.E[i]);
       // For W   tagging in MC we use: GEN/RECO corrected +scaled+smeared softdrop mass
       // For top tagging in MC we use: L1L2L3 subjet corrected +scaled+smeared softdrop mass
 #if VER == 0
@@ -1594,14 +1683,8 @@ AnalysisBase::calculate_common_variables(DataStruct& data, const unsigned int& s
 	  iTightWTag.push_back(i);
 	  itTightWTag[i] = nTightWTag++;
 	  // DR between W and b
-	  while(data.jetsAK4.Loop()) {
-	    size_t i = data.jetsAK4.it;
-	    TLorentzVector AK4_v4; AK4_v4.SetPtEtaPhiE(data.jetsAK4.Pt[i], data.jetsAK4.Eta[i], data.jetsAK4.Phi[i], data.jetsAK4.E[i]);
-	    if (passMediumBTag[i]) {
-	      double dR = AK4_v4.DeltaR(AK8_v4);
-	      if (dR<minDeltaR_W_b) minDeltaR_W_b = dR;
-	    }
-	  }
+	  double dR = match_AK8_AK4.minDR(i, &passMediumBTag);
+	  if (dR<minDeltaR_W_b) minDeltaR_W_b = dR;
 	} else {
 	  passTightWAntiTag[i] = 1;
 	  iTightWAntiTag.push_back(i);
@@ -1628,14 +1711,8 @@ AnalysisBase::calculate_common_variables(DataStruct& data, const unsigned int& s
 	  }
 #if USE_BTAG == 1
 	} else {
-    while(data.jetsAK4.Loop()) {
-      size_t i = data.jetsAK4.it;
-      TLorentzVector AK4_v4; AK4_v4.SetPtEtaPhiE(data.jetsAK4.Pt[i], data.jetsAK4.Eta[i], data.jetsAK4.Phi[i], data.jetsAK4.E[i]);
-      if (passMediumBTag[i]) {
-        double dR = AK4_v4.DeltaR(AK8_v4);
-        if (dR<minDeltaR_W_b) minDeltaR_W_b = dR;
-      }    
-    }    
+    double dR = match_AK8_AK4.minDR(i, &passMediumBTag);
+    if (dR<minDeltaR_W_b) minDeltaR_W_b = dR;
     if(minDeltaR_W_b > 0.8) {
       passHadTop0BMassTag[i] = 1; 
       itHadTop0BMassTag[i] = nHadTop0BMassTag++;
@@ -1659,7 +1736,11 @@ AnalysisBase::calculate_common_variables(DataStruct& data, const unsigned int& s
     }
 
   } // End AK8 Jet Loop
-  
+}
+
+void
+AnalysisBase::calc_gen_(DataStruct& data)
+{
   // Loop on generator particles
   iGenHadW   .clear();
   iGenTop    .clear();
@@ -1680,17 +1761,13 @@ AnalysisBase::calculate_common_variables(DataStruct& data, const unsigned int& s
   float dR1;
   //bool passWTag = 0;
   //bool passpreWTag = 0;
-  TLorentzVector wtag_v4;
-  TLorentzVector genw_v4;
-  TLorentzVector genb_v4; 
-  std::vector<TLorentzVector> selected_genw_v4;
-  std::vector<TLorentzVector> selected_genb_v4;
+  std::vector<size_t> selected_genw;
+  std::vector<size_t> selected_genb;
   //bool passTopTag = 0;
   //bool passpreTopTag = 0;
-  TLorentzVector gentop_v4;
-  TLorentzVector jet_v4;
   hasGenW            .assign(data.jetsAK8.size, 0);
   hasGenTop          .assign(data.jetsAK8.size, 0);
+  match_gen_AK8.match(v4_gen, v4_AK8);
   while(data.gen.Loop()) {
     size_t i = data.gen.it;
     // Select only final version of the particles (their daughters have different IDs)
@@ -1699,8 +1776,7 @@ AnalysisBase::calculate_common_variables(DataStruct& data, const unsigned int& s
       if (fabs(data.gen.Eta[i])<2.4) {
         // gen bs
         if(abs(data.gen.ID[i])==5&&data.gen.Pt[i]>0) {
-          genb_v4.SetPtEtaPhiE(data.gen.Pt[i], data.gen.Eta[i], data.gen.Phi[i], data.gen.E[i]);
-          selected_genb_v4.push_back(genb_v4);
+          selected_genb.push_back(i);
         }
         
 	// gen Ws
@@ -1712,12 +1788,10 @@ AnalysisBase::calculate_common_variables(DataStruct& data, const unsigned int& s
           itGenHadW[i] = nGenHadW++;
           //passWTag = 0;
           //passpreWTag = 0;
-          genw_v4.SetPtEtaPhiE(data.gen.Pt[i], data.gen.Eta[i], data.gen.Phi[i], data.gen.E[i]);
-          selected_genw_v4.push_back(genw_v4);
+          selected_genw.push_back(i);
           while(data.jetsAK8.Loop()) {
             size_t j = data.jetsAK8.it;
-            wtag_v4.SetPtEtaPhiE(data.jetsAK8.Pt[j], data.jetsAK8.Eta[j], data.jetsAK8.Phi[j], data.jetsAK8.E[j]);
-            dR = genw_v4.DeltaR(wtag_v4);
+            dR = match_gen_AK8.dR(i, j);
             if (dR<0.8) {
               hasGenW[j] = true;
               if (passTightWTag[j]) {
@@ -1749,11 +1823,9 @@ AnalysisBase::calculate_common_variables(DataStruct& data, const unsigned int& s
 
           //passTopTag = 0;
           //passpreTopTag = 0;
-          gentop_v4.SetPtEtaPhiE(data.gen.Pt[i], data.gen.Eta[i], data.gen.Phi[i], data.gen.E[i]);
           while(data.jetsAK8.Loop()) {
             size_t j = data.jetsAK8.it;
-            jet_v4.SetPtEtaPhiE(data.jetsAK8.Pt[j], data.jetsAK8.Eta[j], data.jetsAK8.Phi[j], data.jetsAK8.E[j]);
-            dR = gentop_v4.DeltaR(jet_v4);
+            dR = match_gen_AK8.dR(i, j);
             if (dR<0.8) {
               hasGenTop[j] = true;
               npreTopTag++;
@@ -1772,25 +1844,22 @@ AnalysisBase::calculate_common_variables(DataStruct& data, const unsigned int& s
       }
     }
   }
-  for(size_t i=0;i<selected_genw_v4.size();++i){
-    for(size_t k=0;k<selected_genb_v4.size();++k){
+  for(size_t i=0;i<selected_genw.size();++i){
+    for(size_t k=0;k<selected_genb.size();++k){
       while(data.jetsAK8.Loop()) {
 	size_t j = data.jetsAK8.it;
-	wtag_v4.SetPtEtaPhiE(data.jetsAK8.Pt[j], data.jetsAK8.Eta[j], data.jetsAK8.Phi[j], data.jetsAK8.E[j]);
-	//dR = wtag_v4.DeltaR(selected_genw_v4[i]);
-	dR = selected_genw_v4[i].DeltaR(wtag_v4);
+	dR = match_gen_AK8.dR(selected_genw[i], j);
 	if (dR<0.8) {
 	  if (passWMassTag[j]) {
 	    nmWTag=1;
-	    dR1 = selected_genb_v4[k].DeltaR(wtag_v4);
+	    dR1 = match_gen_AK8.dR(selected_genb[k], j);
 	    if (dR1<0.8) nmWTag=-1;
 	    else{iGenMassW.push_back(j); itGenMassW[j] = nGenMassW++;}
 	  }
 	  if (passTightWTag[j]) {
 	    //passWTag = 1;
 	    nWTag=1;
-	    //dR1 = wtag_v4.DeltaR(selected_genb_v4[k]);
-	    dR1 = selected_genb_v4[k].DeltaR(wtag_v4);
+	    dR1 = match_gen_AK8.dR(selected_genb[k], j);
 	    if (dR1<0.8) nWTag=-1;
 	    else{ 
 	      //iGenHadW.push_back(j); 
@@ -1803,7 +1872,11 @@ AnalysisBase::calculate_common_variables(DataStruct& data, const unsigned int& s
       }
     }
   }
+}
 
+void
+AnalysisBase::calc_razor_(DataStruct& data)
+{
   //if (syst_index==0&&applySmearing) {
   //  data.evt.MR  = data.evt.MR_Smear;
   //  data.evt.MTR = data.evt.MTR_Smear;
@@ -1814,16 +1887,13 @@ AnalysisBase::calculate_common_variables(DataStruct& data, const unsigned int& s
   // Recalculation of Razor variables
   // Has to be done after jet uncertainties applied
   // Get selected AK4 jets (input for megajets)
-  std::vector<TLorentzVector> selected_jets_AK4;
-  while(data.jetsAK4.Loop()) {
-    size_t i = data.jetsAK4.it;
-    TLorentzVector jet_v4; jet_v4.SetPtEtaPhiE(data.jetsAK4.Pt[i], data.jetsAK4.Eta[i], data.jetsAK4.Phi[i], data.jetsAK4.E[i]);
-    // Pass jet selection criteria
-    if (passLooseJet[i]) selected_jets_AK4.push_back(jet_v4);
-  }
+  std::vector<FourVector> selected_jets_AK4;
+  // Pass jet selection criteria
+  for (size_t i : passLooseJet) selected_jets_AK4.push_back(v4_AK4[i]);
+  // Megajets and MR are only recalculated if the selected jets changed
+  hemis_AK4 = hemis_AK4_cache.hemis(selected_jets_AK4);
   // Razor variables
-  if (selected_jets_AK4.size() < 2) {
-    hemis_AK4.clear();
+  if (hemis_AK4.size() != 2) {
     data.evt.MR  = -9999;
     data.evt.MTR = -9999;
     data.evt.R   = -9999;
@@ -1832,8 +1902,7 @@ AnalysisBase::calculate_common_variables(DataStruct& data, const unsigned int& s
   } else {
     TVector3 shifted_met;
     shifted_met.SetPtEtaPhi(data.met.Pt[0], 0, data.met.Phi[0]);
-    hemis_AK4 = Razor::CombineJets(selected_jets_AK4);
-    data.evt.MR  = Razor::CalcMR(hemis_AK4[0], hemis_AK4[1]);
+    data.evt.MR  = hemis_AK4_cache.MR();
     data.evt.MTR = Razor::CalcMTR(hemis_AK4[0], hemis_AK4[1], shifted_met);
     data.evt.R   = data.evt.MTR/data.evt.MR;
     data.evt.R2  = data.evt.R*data.evt.R;
@@ -1844,15 +1913,6 @@ AnalysisBase::calculate_common_variables(DataStruct& data, const unsigned int& s
   MTR_ll = MTR_pho = -9999;
   R_ll   = R_pho   = -9999;
   R2_ll  = R2_pho  = -9999;
-  if (hemis_AK4.size()!=2) {
-    std::vector<TLorentzVector> selected_jets_AK4;
-    while(data.jetsAK4.Loop()) {
-      size_t i = data.jetsAK4.it;
-      TLorentzVector jet_v4; jet_v4.SetPtEtaPhiE(data.jetsAK4.Pt[i], data.jetsAK4.Eta[i], data.jetsAK4.Phi[i], data.jetsAK4.E[i]);
-      if (passLooseJet[i]) selected_jets_AK4.push_back(jet_v4);
-    }
-    if (selected_jets_AK4.size()>=2) hemis_AK4 = Razor::CombineJets(selected_jets_AK4);
-  }
   if (hemis_AK4.size()==2) {
     if (M_ll!=-9999) {
       MET_ll = met_ll.Pt();
@@ -1869,6 +1929,110 @@ AnalysisBase::calculate_common_variables(DataStruct& data, const unsigned int& s
   }
 }
 
+//_______________________________________________________
+//       Derived variables saved next to the skim
+
+// Friend tree "derived", with one entry for each skimmed event:
+// - Razor variables and the megajets recalculated with the selected jets
+// - Tag counts
+// - A pass mask for each object, bits in the order of the selections below
+void
+AnalysisBase::init_derived_tree(TTree* tree)
+{
+  tree->Branch("MR",        &derived_MR_,  "MR/D");
+  tree->Branch("MTR",       &derived_MTR_, "MTR/D");
+  tree->Branch("R",         &derived_R_,   "R/D");
+  tree->Branch("R2",        &derived_R2_,  "R2/D");
+  tree->Branch("dPhiRazor", &dPhiRazor,    "dPhiRazor/D");
+  tree->Branch("hemi_Pt",   derived_hemi_Pt_,  "hemi_Pt[2]/F");
+  tree->Branch("hemi_Eta",  derived_hemi_Eta_, "hemi_Eta[2]/F");
+  tree->Branch("hemi_Phi",  derived_hemi_Phi_, "hemi_Phi[2]/F");
+  tree->Branch("hemi_M",    derived_hemi_M_,   "hemi_M[2]/F");
+  tree->Branch("MT",          &MT,          "MT/D");
+  tree->Branch("AK4_Ht",      &AK4_Ht,      "AK4_Ht/D");
+  tree->Branch("AK8_Ht",      &AK8_Ht,      "AK8_Ht/D");
+  tree->Branch("minDeltaPhi", &minDeltaPhi, "minDeltaPhi/D");
+
+  std::vector<std::pair<std::string, unsigned int*> > counts = {
+    { "nJet",             &nJet             },
+    { "nJetNoLep",        &nJetNoLep        },
+    { "nLooseBTag",       &nLooseBTag       },
+    { "nMediumBTag",      &nMediumBTag      },
+    { "nTightBTag",       &nTightBTag       },
+    { "nJetAK8",          &nJetAK8          },
+    { "nWMassTag",        &nWMassTag        },
+    { "nLooseWTag",       &nLooseWTag       },
+    { "nTightWTag",       &nTightWTag       },
+    { "nTightWAntiTag",   &nTightWAntiTag   },
+    { "nSubjetBTag",      &nSubjetBTag      },
+    { "nHadTopMassTag",   &nHadTopMassTag   },
+    { "nHadTopTag",       &nHadTopTag       },
+    { "nHadTop0BMassTag", &nHadTop0BMassTag },
+    { "nHadTop0BAntiTag", &nHadTop0BAntiTag },
+    { "nEleVeto",         &nEleVeto         },
+    { "nEleLoose",        &nEleLoose        },
+    { "nEleSelect",       &nEleSelect       },
+    { "nEleTight",        &nEleTight        },
+    { "nMuVeto",          &nMuVeto          },
+    { "nMuLoose",         &nMuLoose         },
+    { "nMuSelect",        &nMuSelect        },
+    { "nMuTight",         &nMuTight         },
+    { "nLepVeto",         &nLepVeto         },
+    { "nLepSelect",       &nLepSelect       },
+    { "nLepTight",        &nLepTight        },
+    { "nPhotonSelect",    &nPhotonSelect    }
+  };
+  for (const auto& count : counts)
+    tree->Branch(count.first.c_str(), count.second, (count.first+"/i").c_str());
+
+  // The mask addresses are set before each fill (the vectors may move)
+  const char* objects[nDerivedObjects_] = { "jetsAK4", "jetsAK8", "ele", "mu", "pho" };
+  for (size_t i=0; i<nDerivedObjects_; ++i) {
+    std::string size = std::string(objects[i])+"_size", mask = std::string(objects[i])+"_passMask";
+    derived_mask_[i].reserve(100);
+    tree->Branch(size.c_str(), &derived_size_[i], (size+"/I").c_str());
+    b_derived_mask_[i] = tree->Branch(mask.c_str(), derived_mask_[i].data(), (mask+"["+size+"]/i").c_str());
+  }
+}
+
+// Call after calculate_common_variables, before the event is added to the skim
+void
+AnalysisBase::fill_derived_variables(DataStruct& data)
+{
+  derived_MR_  = data.evt.MR;
+  derived_MTR_ = data.evt.MTR;
+  derived_R_   = data.evt.R;
+  derived_R2_  = data.evt.R2;
+  for (size_t i=0; i<2; ++i) {
+    bool has_hemi = hemis_AK4.size()==2;
+    derived_hemi_Pt_[i]  = has_hemi ? hemis_AK4[i].Pt()  : -9999;
+    derived_hemi_Eta_[i] = has_hemi ? hemis_AK4[i].Eta() : -9999;
+    derived_hemi_Phi_[i] = has_hemi ? hemis_AK4[i].Phi() : -9999;
+    derived_hemi_M_[i]   = has_hemi ? hemis_AK4[i].M()   : -9999;
+  }
+
+  // Bit i of the mask is set if the object passes selection i
+  std::vector<std::vector<const PassMask*> > selections = {
+    { &passLooseJet, &passLooseJetNoLep, &passLooseBTag, &passMediumBTag, &passTightBTag },
+    { &passLooseJetAK8, &passWMassTag, &passLooseWTag, &passTightWTag, &passTightWAntiTag,
+      &passHadTopMassTag, &passHadTopTag, &passHadTop0BMassTag, &passHadTop0BAntiTag, &passSubjetBTag },
+    { &passEleVeto, &passEleLoose, &passEleSelect, &passEleTight },
+    { &passMuVeto,  &passMuLoose,  &passMuSelect,  &passMuTight  },
+    { &passPhotonSelect }
+  };
+  const size_t sizes[nDerivedObjects_] = { data.jetsAK4.size, data.jetsAK8.size, data.ele.size, data.mu.size, data.pho.size };
+  for (size_t i=0; i<nDerivedObjects_; ++i) {
+    std::vector<unsigned int>& mask = derived_mask_[i];
+    mask.assign(sizes[i], 0);
+    for (size_t bit=0, nbit=selections[i].size(); bit<nbit; ++bit) {
+      for (size_t j : *selections[i][bit]) if (j<sizes[i]) mask[j] |= 1u<<bit;
+    }
+    derived_size_[i] = sizes[i];
+    if (mask.capacity()==0) mask.reserve(1);
+    b_derived_mask_[i]->SetAddress(mask.data());
+  }
+}
+
 //_______________________________________________________
 //  Apply analysis cuts in the specified search region
 
@@ -2261,6 +2425,7 @@ AnalysisBase::fill_common_histos(DataStruct& d, const unsigned int& syst_index,
 double
 AnalysisBase::get_xsec_from_ntuple(const std::vector<std::string>& filenames, const std::string& treename)
 {
+  if (index_) return index_->xsec(filenames);
   float evt_XSec=0, prev_XSec=0;
   for (const auto& filename : filenames) {
     TFile *f = TFile::Open(filename.c_str());
@@ -2326,6 +2491,10 @@ double
 AnalysisBase::get_totweight_from_ntuple(const std::vector<std::string>& filenames, const std::string& histoname)
 {
   // Merging totweight histos
+  if (index_) {
+    index_->add_histo(filenames, 0, h_totweight);
+    return h_totweight->GetBinContent(1);
+  }
   for (const auto& filename : filenames) {
     TFile* f = TFile::Open(filename.c_str());
     h_totweight->Add((TH1D*)f->Get(histoname.c_str()));
@@ -2353,7 +2522,8 @@ AnalysisBase::calc_weightnorm_histo_from_ntuple(const std::vector<std::string>&
 
   // Merge totweight histos
   std::map<int, double> xsec_mother;
-  for (const auto& filename : filenames) {
+  if (index_) index_->add_histo(filenames, 1+signal_index, vh_totweight_signal[signal_index]);
+  else for (const auto& filename : filenames) {
     TFile* f = TFile::Open(filename.c_str());
     // Get total weight
     TH2D* totweight = (TH2D*)f->Get(vname_totweight[signal_index].c_str());
@@ -2488,7 +2658,7 @@ AnalysisBase::get_syst_weight(const double& weight_nominal, const double& uncert
 //_______________________________________________________
 //                  Top pt reweighting
 double
-AnalysisBase::get_toppt_weight(DataStruct& data, const double& nSigmaTopPt)
+AnalysisBase::get_toppt_nominal(DataStruct& data)
 {
   double w_nom = 1;//, n=0;
   while(data.gen.Loop()) {
@@ -2505,6 +2675,13 @@ AnalysisBase::get_toppt_weight(DataStruct& data, const double& nSigmaTopPt)
   }
   w_nom = std::sqrt(w_nom);
   //std::cout<<"N top = "<<n<<" w_nom = "<<w_nom<<std::endl<<std::endl;
+  return w_nom;
+}
+
+// Use this, when the variations are evaluated several times for the same event
+double
+AnalysisBase::get_toppt_weight(const double& w_nom, const double& nSigmaTopPt)
+{
   double w_toppt_up = 1;
   double w_toppt = std::sqrt(w_nom);
   double w_toppt_down = w_nom; // Nominal weight is typically below 1 (below top pt>123) --> use as down variation
@@ -2512,6 +2689,12 @@ AnalysisBase::get_toppt_weight(DataStruct& data, const double& nSigmaTopPt)
   return w;
 }
 
+double
+AnalysisBase::get_toppt_weight(DataStruct& data, const double& nSigmaTopPt)
+{
+  return get_toppt_weight(get_toppt_nominal(data), nSigmaTopPt);
+}
+
 //_______________________________________________________
 //                  Get pile-up weight
 double
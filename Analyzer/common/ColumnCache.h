@@ -0,0 +1,429 @@
+#ifndef COLUMNCACHE_H
+#define COLUMNCACHE_H
+//-----------------------------------------------------------------------------
+// File:        ColumnCache.h
+// Description: Columnar cache of the variables selected from an itreestream
+//              One cache file is kept for each input file (tree) in the
+//              cache directory, with one contiguous array per variable
+//              (values in the type of the selected variable), and an array
+//              of offsets (nentries+1) for vectors.
+//
+//              The first time a tree is read completely (all entries in
+//              order, with read), the values are recorded and the cache file
+//              is written. Later, the file is mapped into memory and the
+//              variables are copied from there, without reading the tree.
+//              A cache file is only used if the size, modification time and
+//              UUID of the input file, the tree and the list of selected
+//              variables (with their types) are the same as when it was made.
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "TFile.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "TUUID.h"
+
+#include "SoA.h"
+
+class ColumnCache {
+public:
+  ColumnCache(const std::string& dir) : dir_(dir) {}
+  ~ColumnCache() { close_(); }
+
+  // Called for each new tree: map its valid cache file, or start recording
+  void open(TTree*, SelectedData&);
+
+  // The values of the current tree come from the cache
+  bool mapped() const { return map_ != 0; }
+
+  // Copy the value of the entry to the selected variable (if mapped)
+  inline void get(Field* field, const int& entry) const
+  {
+    const Column& col = columns_[field->column];
+    if ( !col.isvector ) {
+      std::memcpy(field->address, col.data + (size_t)entry*col.elsize, col.elsize);
+    } else {
+      uint64_t first = col.offsets[entry], count = col.offsets[entry+1] - first;
+      col.resize(field->address, count);
+      if ( count ) std::memcpy(col.vdata(field->address), col.data + first*col.elsize, count*col.elsize);
+    }
+  }
+
+  // Record the variables of an entry that was completely read
+  // (the cache file is written after the last entry of the tree)
+  void record(const int&);
+
+  // Stop recording (entries read only partially or not in order)
+  void abandon();
+
+private:
+  // Buffer, that is moved to a temporary file if it gets large
+  struct Spool {
+    std::string path;
+    std::vector<char> buffer;
+    uint64_t bytes = 0;
+    void append(const void*, const size_t&);
+    void spill();
+    bool copy_to(FILE*);
+    void remove();
+  };
+
+  struct Column {
+    Field*   field;
+    bool     isvector;
+    size_t   elsize;
+    size_t   (*size)  (void*);
+    void*    (*vdata) (void*);
+    void     (*resize)(void*, const uint64_t&);
+    // Mapped
+    const char*     data;
+    const uint64_t* offsets;
+    // Recording
+    Spool    values;
+    Spool    counts;
+    uint64_t nvalues;
+  };
+
+  // Fixed part of the file header, followed by the key, the column table
+  // (4 numbers per column: data and offsets position and size), and the data
+  struct Header {
+    char     magic[8];
+    uint64_t nentries;
+    uint64_t ncolumns;
+    uint64_t keybytes;
+  };
+
+  static const size_t align_ = 64;
+
+  std::string dir_;
+  std::string file_;
+  std::string key_;
+  std::vector<Column> columns_;
+  uint64_t nentries_  = 0;
+  uint64_t nrecorded_ = 0;
+  bool     recording_ = false;
+  void*    map_       = 0;
+  size_t   mapsize_   = 0;
+
+  void close_();
+  bool map_file_();
+  void write_file_();
+};
+
+namespace
+{
+  // Vector access by source type
+  template <class T> size_t colsize(void* v)   { return reinterpret_cast<std::vector<T>*>(v)->size(); }
+  template <class T> void*  coldata(void* v)   { return reinterpret_cast<std::vector<T>*>(v)->data(); }
+  template <class T> void   colresize(void* v, const uint64_t& n) { reinterpret_cast<std::vector<T>*>(v)->resize(n); }
+
+  template <class T>
+  void setcolumntype(size_t& elsize, size_t (*&size)(void*), void* (*&vdata)(void*), void (*&resize)(void*, const uint64_t&))
+  {
+    elsize = sizeof(T);
+    size   = &colsize<T>;
+    vdata  = &coldata<T>;
+    resize = &colresize<T>;
+  }
+
+  // Fixed capacity columns (SoA.h), sized by their collection
+  size_t soasize(void* c)   { return reinterpret_cast<SoAColumnBase*>(c)->size(); }
+  void*  soadata(void* c)   { return reinterpret_cast<SoAColumnBase*>(c)->address(); }
+  void   soaresize(void*, const uint64_t&) {}
+
+  // 64 bit FNV-1a hash, used in the cache file name
+  uint64_t fnvhash(const std::string& str)
+  {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char& c : str) { hash ^= (unsigned char)c; hash *= 1099511628211ULL; }
+    return hash;
+  }
+}
+
+//_______________________________________________________
+//           Map the cache of the tree, or start recording
+void
+ColumnCache::open(TTree* tree, SelectedData& selecteddata)
+{
+  close_();
+  columns_.clear();
+  TFile* file = tree->GetCurrentFile();
+  if ( file == 0 ) return;
+
+  // Columns: all variables with a source address (not leaf counters only used internally)
+  std::stringstream columns;
+  for (SelectedData::iterator it=selecteddata.begin(); it!=selecteddata.end(); ++it) {
+    Field* field = it->second;
+    field->column = -1;
+    if ( field->address == 0 || field->branch == 0 ) continue;
+    Column col = Column();
+    col.field    = field;
+    col.isvector = field->isvector;
+    switch (field->srctype) {
+    case 'D': setcolumntype<double>        (col.elsize, col.size, col.vdata, col.resize); break;
+    case 'F': setcolumntype<float>         (col.elsize, col.size, col.vdata, col.resize); break;
+    case 'L': setcolumntype<long>          (col.elsize, col.size, col.vdata, col.resize); break;
+    case 'I': setcolumntype<int>           (col.elsize, col.size, col.vdata, col.resize); break;
+    case 'S': setcolumntype<short>         (col.elsize, col.size, col.vdata, col.resize); break;
+    case 'B': setcolumntype<char>          (col.elsize, col.size, col.vdata, col.resize); break;
+    case 'l': setcolumntype<unsigned long> (col.elsize, col.size, col.vdata, col.resize); break;
+    case 'i': setcolumntype<unsigned int>  (col.elsize, col.size, col.vdata, col.resize); break;
+    case 's': setcolumntype<unsigned short>(col.elsize, col.size, col.vdata, col.resize); break;
+    case 'b': setcolumntype<unsigned char> (col.elsize, col.size, col.vdata, col.resize); break;
+    case 'O':
+      if ( !field->isvector ) { col.elsize = sizeof(bool); break; }
+      // fall through: vector<bool> has no contiguous storage
+    default:
+      std::cout << "** Warning ** ColumnCache - variable " << field->fullname
+		<< " can not be cached (type " << field->srctype << "), reading the tree" << std::endl;
+      for (auto& c : columns_) c.field->column = -1;
+      columns_.clear();
+      return;
+    }
+    if ( field->iscolumn ) {
+      col.size   = &soasize;
+      col.vdata  = &soadata;
+      col.resize = &soaresize;
+    }
+    field->column = columns_.size();
+    columns_.push_back(col);
+    columns << field->fullname << ":" << field->srctype << (field->isvector ? "[]" : "") << "\n";
+  }
+
+  // Key of the input file and selection
+  std::string source = file->GetName();
+  FileStat_t stat;
+  long mtime = gSystem->GetPathInfo(source.c_str(), stat)==0 ? stat.fMtime : 0;
+  std::stringstream key;
+  key << "source: " << source << "\n"
+      << "size: " << file->GetSize() << "\n"
+      << "mtime: " << mtime << "\n"
+      << "modified: " << file->GetModificationDate().AsSQLString() << "\n"
+      << "uuid: " << file->GetUUID().AsString() << "\n"
+      << "tree: " << tree->GetName() << "\n"
+      << "entries: " << tree->GetEntries() << "\n"
+      << columns.str();
+  key_ = key.str();
+  nentries_ = tree->GetEntries();
+
+  std::string base = source.substr(source.rfind('/')+1);
+  if ( base.rfind(".root") != std::string::npos ) base.erase(base.rfind(".root"));
+  std::stringstream name;
+  name << dir_ << "/" << base << "_" << std::hex << fnvhash(source + "\n" + tree->GetName()) << ".colcache";
+  file_ = name.str();
+
+  if ( map_file_() ) return;
+
+  // Record values of the entries in spools
+  gSystem->mkdir(dir_.c_str(), kTRUE);
+  std::stringstream tmp;
+  tmp << file_ << ".tmp" << getpid();
+  for (size_t i=0; i<columns_.size(); ++i) {
+    Column& col = columns_[i];
+    col.values.path = tmp.str() + "_" + std::to_string(i) + "_values";
+    col.counts.path = tmp.str() + "_" + std::to_string(i) + "_offsets";
+    col.nvalues = 0;
+    if ( col.isvector ) col.counts.append(&col.nvalues, sizeof(uint64_t));
+  }
+  nrecorded_ = 0;
+  recording_ = true;
+}
+
+//_______________________________________________________
+//     Map the cache file if it matches the current key
+bool
+ColumnCache::map_file_()
+{
+  int fd = ::open(file_.c_str(), O_RDONLY);
+  if ( fd < 0 ) return false;
+  struct stat st;
+  st.st_size = 0;
+  Header header;
+  bool ok = fstat(fd, &st)==0 && (size_t)st.st_size >= sizeof(Header) &&
+    pread(fd, &header, sizeof(Header), 0) == (ssize_t)sizeof(Header) &&
+    std::memcmp(header.magic, "COLCACH1", 8)==0 && header.keybytes == key_.size() &&
+    header.ncolumns == columns_.size() && header.nentries == nentries_;
+  if ( ok ) {
+    std::string key(key_.size(), ' ');
+    ok = pread(fd, &key[0], key.size(), sizeof(Header)) == (ssize_t)key.size() && key == key_;
+  }
+  if ( ok ) {
+    map_ = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if ( map_ == MAP_FAILED ) { map_ = 0; ok = false; }
+  }
+  ::close(fd);
+  if ( !ok ) {
+    if ( st.st_size ) std::cout << "ColumnCache - cache " << file_ << " is out of date, remaking it" << std::endl;
+    return false;
+  }
+  mapsize_ = st.st_size;
+  madvise(map_, mapsize_, MADV_SEQUENTIAL);
+
+  const char* base = (const char*)map_;
+  const uint64_t* table = (const uint64_t*)(base + sizeof(Header) + key_.size());
+  for (size_t i=0; i<columns_.size(); ++i) {
+    if ( table[4*i] + table[4*i+1] > mapsize_ || table[4*i+2] + table[4*i+3] > mapsize_ ) {
+      std::cout << "** Warning ** ColumnCache - cache " << file_ << " is corrupt, remaking it" << std::endl;
+      close_();
+      return false;
+    }
+    columns_[i].data    = base + table[4*i];
+    columns_[i].offsets = (const uint64_t*)(base + table[4*i+2]);
+  }
+  std::cout << "ColumnCache - reading from " << file_ << std::endl;
+  return true;
+}
+
+//_______________________________________________________
+//                 Record an entry
+void
+ColumnCache::record(const int& entry)
+{
+  if ( !recording_ ) return;
+  if ( (uint64_t)entry != nrecorded_ ) { abandon(); return; }
+  for (auto& col : columns_) {
+    if ( !col.isvector ) {
+      col.values.append(col.field->address, col.elsize);
+    } else {
+      size_t n = col.size(col.field->address);
+      if ( n ) col.values.append(col.vdata(col.field->address), n*col.elsize);
+      col.nvalues += n;
+      col.counts.append(&col.nvalues, sizeof(uint64_t));
+    }
+  }
+  if ( ++nrecorded_ == nentries_ ) write_file_();
+}
+
+void
+ColumnCache::abandon()
+{
+  if ( !recording_ ) return;
+  recording_ = false;
+  for (auto& col : columns_) {
+    col.values.remove();
+    col.counts.remove();
+  }
+}
+
+//_______________________________________________________
+//    Write the cache file (temporary name, then renamed)
+void
+ColumnCache::write_file_()
+{
+  recording_ = false;
+  std::stringstream tmp;
+  tmp << file_ << ".tmp" << getpid();
+  FILE* f = fopen(tmp.str().c_str(), "wb");
+  bool ok = f != 0;
+  if ( ok ) {
+    Header header;
+    std::memcpy(header.magic, "COLCACH1", 8);
+    header.nentries = nentries_;
+    header.ncolumns = columns_.size();
+    header.keybytes = key_.size();
+    std::vector<uint64_t> table;
+    uint64_t pos = sizeof(Header) + key_.size() + 4*sizeof(uint64_t)*columns_.size();
+    for (const auto& col : columns_) {
+      pos = (pos + align_-1) / align_ * align_;
+      table.push_back(pos);
+      table.push_back(col.values.bytes);
+      pos += col.values.bytes;
+      pos = (pos + align_-1) / align_ * align_;
+      table.push_back(col.isvector ? pos : 0);
+      table.push_back(col.counts.bytes);
+      pos += col.counts.bytes;
+    }
+    ok = fwrite(&header, sizeof(Header), 1, f)==1 &&
+      fwrite(key_.data(), 1, key_.size(), f)==key_.size() &&
+      fwrite(table.data(), sizeof(uint64_t), table.size(), f)==table.size();
+    const char zeros[align_] = {};
+    for (auto& col : columns_) {
+      for (Spool* spool : { &col.values, &col.counts }) {
+	long padding = (align_ - ftell(f) % align_) % align_;
+	ok = ok && fwrite(zeros, 1, padding, f)==(size_t)padding && spool->copy_to(f);
+      }
+    }
+    ok = (fclose(f)==0) && ok;
+  }
+  for (auto& col : columns_) {
+    col.values.remove();
+    col.counts.remove();
+  }
+  if ( ok && std::rename(tmp.str().c_str(), file_.c_str())==0 ) {
+    std::cout << "ColumnCache - cache written to " << file_ << std::endl;
+  } else {
+    std::cout << "** Warning ** ColumnCache - unable to write cache " << file_ << std::endl;
+    std::remove(tmp.str().c_str());
+  }
+}
+
+void
+ColumnCache::close_()
+{
+  abandon();
+  if ( map_ ) munmap(map_, mapsize_);
+  map_ = 0;
+  mapsize_ = 0;
+  for (auto& col : columns_) {
+    col.data = 0;
+    col.offsets = 0;
+  }
+}
+
+//_______________________________________________________
+//                      Spools
+void
+ColumnCache::Spool::append(const void* data, const size_t& n)
+{
+  const char* p = (const char*)data;
+  buffer.insert(buffer.end(), p, p+n);
+  bytes += n;
+  if ( buffer.size() > (1<<20) ) spill();
+}
+
+void
+ColumnCache::Spool::spill()
+{
+  if ( buffer.empty() ) return;
+  FILE* f = fopen(path.c_str(), "ab");
+  if ( f == 0 || fwrite(buffer.data(), 1, buffer.size(), f) != buffer.size() ) {
+    std::cout << "** Error ** ColumnCache - unable to write " << path << std::endl;
+    exit(1);
+  }
+  fclose(f);
+  buffer.clear();
+}
+
+bool
+ColumnCache::Spool::copy_to(FILE* out)
+{
+  FILE* in = fopen(path.c_str(), "rb");
+  if ( in ) {
+    char chunk[1<<16];
+    size_t n;
+    while ( (n = fread(chunk, 1, sizeof(chunk), in)) > 0 )
+      if ( fwrite(chunk, 1, n, out) != n ) { fclose(in); return false; }
+    fclose(in);
+  }
+  return fwrite(buffer.data(), 1, buffer.size(), out) == buffer.size();
+}
+
+void
+ColumnCache::Spool::remove()
+{
+  std::remove(path.c_str());
+  std::vector<char>().swap(buffer);
+  bytes = 0;
+}
+
+#endif
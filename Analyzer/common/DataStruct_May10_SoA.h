@@ -0,0 +1,1386 @@
+#ifndef DataStruct_h
+#define DataStruct_h
+
+// Same as DataStruct_May10.h, except gen, pho, ele, mu, jetsAK4 and jetsAK8
+// are fixed capacity structures of arrays (common/SoA.h): each collection
+// has one aligned block of memory for all of its variables, which is not
+// reallocated when reading the events
+// (made with scripts/make_datastruct.py --soa May10)
+
+#define NOVAL_I -9999
+#define NOVAL_F -9999.0
+
+#include <vector>
+#include <iostream>
+#include "SoA.h"
+
+// Maximum number of objects in the collections stored as SoA columns
+#define SOA_CAPACITY 500
+
+inline void init_vec(std::vector<int>& vec) { vec.resize(500); for (int i=0; i<500; ++i) vec[i]=-9999; }
+inline void init_vec(std::vector<float>& vec) { vec.resize(500); for (int i=0; i<500; ++i) vec[i]=-9999; }
+inline void init_vec(std::vector<double>& vec) { vec.resize(500); for (int i=0; i<500; ++i) vec[i]=-9999; }
+inline void init_vec(std::vector<std::vector<int> >& vec) { vec.resize(1); vec[0].resize(500); for (int i=0; i<500; ++i) vec[0][i]=-9999; }
+
+class DataStruct {
+public:
+  DataStruct() {};
+  ~DataStruct() {};
+
+  class EventData {
+  public:
+    EventData() { init(); };
+    
+    unsigned int RunNumber;
+    unsigned int LumiBlock;
+    long EventNumber;
+    int NGoodVtx;
+    int LHA_PDF_ID;
+    int NIsoTrk;
+    float MR;
+    float MTR;
+    float R;
+    float R2;
+    float MR_Smear;
+    float MTR_Smear;
+    float XSec;
+    float Gen_Weight;
+    float Gen_Ht;
+    float SUSY_Stop_Mass;
+    float SUSY_Gluino_Mass;
+    float SUSY_LSP_Mass;
+    
+    void init() {
+      RunNumber=9999;
+      LumiBlock=9999;
+      EventNumber=9999;
+      NGoodVtx=NOVAL_I;
+      LHA_PDF_ID=NOVAL_I;
+      NIsoTrk=NOVAL_I;
+      MR=NOVAL_F;
+      MTR=NOVAL_F;
+      R=NOVAL_F;
+      R2=NOVAL_F;
+      MR_Smear=NOVAL_F;
+      MTR_Smear=NOVAL_F;
+      XSec=NOVAL_F;
+      Gen_Weight=NOVAL_F;
+      Gen_Ht=NOVAL_F;
+      SUSY_Stop_Mass=NOVAL_F;
+      SUSY_Gluino_Mass=NOVAL_F;
+      SUSY_LSP_Mass=NOVAL_F;
+    }
+    
+  } evt;
+  
+  class METData {
+  public:
+    METData() { init(); };
+    
+    unsigned int MuCleanOnly_size;
+    std::vector<float> MuCleanOnly_Pt;
+    std::vector<float> MuCleanOnly_Phi;
+    unsigned int size;
+    std::vector<float> Pt;
+    std::vector<float> Phi;
+    
+    void init() {
+      MuCleanOnly_size=9999;
+      init_vec(MuCleanOnly_Pt);
+      init_vec(MuCleanOnly_Phi);
+      size=9999;
+      init_vec(Pt);
+      init_vec(Phi);
+    }
+    
+  } met;
+  
+  class PuppiMETData {
+  public:
+    PuppiMETData() { init(); };
+    
+    unsigned int size;
+    std::vector<float> Pt;
+    std::vector<float> Phi;
+    
+    void init() {
+      size=9999;
+      init_vec(Pt);
+      init_vec(Phi);
+    }
+    
+  } puppimet;
+  
+  class PileupData {
+  public:
+    PileupData() { init(); };
+    
+    int NtrueInt;
+    
+    void init() {
+      NtrueInt=NOVAL_I;
+    }
+    
+  } pu;
+  
+  class VertexData {
+  public:
+    VertexData() { init(); };
+    
+    
+    void init() {
+    }
+    
+  } vtx;
+  
+  class SystScaleData {
+  public:
+    SystScaleData() { init(); };
+    
+    unsigned int size;
+    std::vector<float> Weights;
+    
+    unsigned int it;
+    
+    void init() {
+      it = -1;
+      size=9999;
+      init_vec(Weights);
+    }
+    
+    bool Loop() {
+      if (size==9999) return 0;
+      ++it;
+      if (it<size) {
+        return 1;
+      } else {
+        it=-1;
+        return 0;
+      }
+    }
+    
+  } syst_scale;
+  
+  class SystPDFData {
+  public:
+    SystPDFData() { init(); };
+    
+    unsigned int size;
+    std::vector<float> Weights;
+    
+    unsigned int it;
+    
+    void init() {
+      it = -1;
+      size=9999;
+      init_vec(Weights);
+    }
+    
+    bool Loop() {
+      if (size==9999) return 0;
+      ++it;
+      if (it<size) {
+        return 1;
+      } else {
+        it=-1;
+        return 0;
+      }
+    }
+    
+  } syst_pdf;
+  
+  class SystAlphaSData {
+  public:
+    SystAlphaSData() { init(); };
+    
+    unsigned int size;
+    std::vector<float> Weights;
+    
+    unsigned int it;
+    
+    void init() {
+      it = -1;
+      size=9999;
+      init_vec(Weights);
+    }
+    
+    bool Loop() {
+      if (size==9999) return 0;
+      ++it;
+      if (it<size) {
+        return 1;
+      } else {
+        it=-1;
+        return 0;
+      }
+    }
+    
+  } syst_alphas;
+  
+  class SystMETUncData {
+  public:
+    SystMETUncData() { init(); };
+    
+    unsigned int size;
+    std::vector<float> MuCleanOnly_Pt;
+    std::vector<float> MuCleanOnly_Phi;
+    std::vector<float> Pt;
+    std::vector<float> Phi;
+    
+    unsigned int it;
+    
+    void init() {
+      it = -1;
+      size=9999;
+      init_vec(MuCleanOnly_Pt);
+      init_vec(MuCleanOnly_Phi);
+      init_vec(Pt);
+      init_vec(Phi);
+    }
+    
+    bool Loop() {
+      if (size==9999) return 0;
+      ++it;
+      if (it<size) {
+        return 1;
+      } else {
+        it=-1;
+        return 0;
+      }
+    }
+    
+  } syst_met;
+  
+  class SystPuppiMETUncData {
+  public:
+    SystPuppiMETUncData() { init(); };
+    
+    unsigned int size;
+    std::vector<float> Pt;
+    std::vector<float> Phi;
+    
+    unsigned int it;
+    
+    void init() {
+      it = -1;
+      size=9999;
+      init_vec(Pt);
+      init_vec(Phi);
+    }
+    
+    bool Loop() {
+      if (size==9999) return 0;
+      ++it;
+      if (it<size) {
+        return 1;
+      } else {
+        it=-1;
+        return 0;
+      }
+    }
+    
+  } syst_puppimet;
+  
+  class FilterData {
+  public:
+    FilterData() { init(); };
+    
+    int BadPFMuonFilter;
+    int BadChargedCandidateFilter;
+    int HBHENoiseFilter;
+    int HBHENoiseIsoFilter;
+    int CSCTightHaloFilter;
+    int CSCTightHaloTrkMuUnvetoFilter;
+    int CSCTightHalo2015Filter;
+    int globalTightHalo2016Filter;
+    int globalSuperTightHalo2016Filter;
+    int HcalStripHaloFilter;
+    int hcalLaserEventFilter;
+    int EcalDeadCellTriggerPrimitiveFilter;
+    int EcalDeadCellBoundaryEnergyFilter;
+    int goodVertices;
+    int eeBadScFilter;
+    int ecalLaserCorrFilter;
+    int trkPOGFilters;
+    int chargedHadronTrackResolutionFilter;
+    int muonBadTrackFilter;
+    int trkPOG_manystripclus53X;
+    int trkPOG_toomanystripclus53X;
+    int trkPOG_logErrorTooManyClusters;
+    int METFilters;
+    int badMuons;
+    int duplicateMuons;
+    int noBadMuons;
+    
+    void init() {
+      BadPFMuonFilter=NOVAL_I;
+      BadChargedCandidateFilter=NOVAL_I;
+      HBHENoiseFilter=NOVAL_I;
+      HBHENoiseIsoFilter=NOVAL_I;
+      CSCTightHaloFilter=NOVAL_I;
+      CSCTightHaloTrkMuUnvetoFilter=NOVAL_I;
+      CSCTightHalo2015Filter=NOVAL_I;
+      globalTightHalo2016Filter=NOVAL_I;
+      globalSuperTightHalo2016Filter=NOVAL_I;
+      HcalStripHaloFilter=NOVAL_I;
+      hcalLaserEventFilter=NOVAL_I;
+      EcalDeadCellTriggerPrimitiveFilter=NOVAL_I;
+      EcalDeadCellBoundaryEnergyFilter=NOVAL_I;
+      goodVertices=NOVAL_I;
+      eeBadScFilter=NOVAL_I;
+      ecalLaserCorrFilter=NOVAL_I;
+      trkPOGFilters=NOVAL_I;
+      chargedHadronTrackResolutionFilter=NOVAL_I;
+      muonBadTrackFilter=NOVAL_I;
+      trkPOG_manystripclus53X=NOVAL_I;
+      trkPOG_toomanystripclus53X=NOVAL_I;
+      trkPOG_logErrorTooManyClusters=NOVAL_I;
+      METFilters=NOVAL_I;
+      badMuons=NOVAL_I;
+      duplicateMuons=NOVAL_I;
+      noBadMuons=NOVAL_I;
+    }
+    
+  } filter;
+  
+  class HLTData {
+  public:
+    HLTData() { init(); };
+    
+    int PFJet40;
+    int PFJet40_prescale;
+    int PFJet60;
+    int PFJet60_prescale;
+    int PFJet80;
+    int PFJet80_prescale;
+    int PFJet140;
+    int PFJet140_prescale;
+    int PFJet200;
+    int PFJet200_prescale;
+    int PFJet260;
+    int PFJet260_prescale;
+    int PFJet320;
+    int PFJet320_prescale;
+    int PFJet400;
+    int PFJet400_prescale;
+    int PFJet450;
+    int PFJet450_prescale;
+    int PFJet500;
+    int PFJet500_prescale;
+    int AK8PFJet40;
+    int AK8PFJet40_prescale;
+    int AK8PFJet60;
+    int AK8PFJet60_prescale;
+    int AK8PFJet80;
+    int AK8PFJet80_prescale;
+    int AK8PFJet140;
+    int AK8PFJet140_prescale;
+    int AK8PFJet200;
+    int AK8PFJet200_prescale;
+    int AK8PFJet260;
+    int AK8PFJet260_prescale;
+    int AK8PFJet320;
+    int AK8PFJet320_prescale;
+    int AK8PFJet360_TrimMass30;
+    int AK8PFJet360_TrimMass30_prescale;
+    int AK8PFJet400_TrimMass30;
+    int AK8PFJet400_TrimMass30_prescale;
+    int AK8PFJet400;
+    int AK8PFJet400_prescale;
+    int AK8PFJet450;
+    int AK8PFJet450_prescale;
+    int AK8PFJet500;
+    int AK8PFJet500_prescale;
+    int PFHT125;
+    int PFHT125_prescale;
+    int PFHT200;
+    int PFHT200_prescale;
+    int PFHT250;
+    int PFHT250_prescale;
+    int PFHT300;
+    int PFHT300_prescale;
+    int PFHT350;
+    int PFHT350_prescale;
+    int PFHT400;
+    int PFHT400_prescale;
+    int PFHT475;
+    int PFHT475_prescale;
+    int PFHT600;
+    int PFHT600_prescale;
+    int PFHT650;
+    int PFHT650_prescale;
+    int PFHT800;
+    int PFHT800_prescale;
+    int PFHT900;
+    int PFHT900_prescale;
+    int AK8PFHT650_TrimR0p1PT0p03Mass50;
+    int AK8PFHT650_TrimR0p1PT0p03Mass50_prescale;
+    int AK8PFHT700_TrimR0p1PT0p03Mass50;
+    int AK8PFHT700_TrimR0p1PT0p03Mass50_prescale;
+    int AK8PFHT750_TrimMass50;
+    int AK8PFHT750_TrimMass50_prescale;
+    int AK8PFHT800_TrimMass50;
+    int AK8PFHT800_TrimMass50_prescale;
+    int PFHT550_4JetPt50;
+    int PFHT550_4JetPt50_prescale;
+    int PFHT650_4JetPt50;
+    int PFHT650_4JetPt50_prescale;
+    int PFHT750_4JetPt50;
+    int PFHT750_4JetPt50_prescale;
+    int PFHT750_4JetPt70;
+    int PFHT750_4JetPt70_prescale;
+    int PFHT750_4JetPt80;
+    int PFHT750_4JetPt80_prescale;
+    int PFHT800_4JetPt50;
+    int PFHT800_4JetPt50_prescale;
+    int PFHT850_4JetPt50;
+    int PFHT850_4JetPt50_prescale;
+    int AK8DiPFJet250_200_TrimMass30;
+    int AK8DiPFJet250_200_TrimMass30_prescale;
+    int AK8DiPFJet280_200_TrimMass30;
+    int AK8DiPFJet280_200_TrimMass30_prescale;
+    int AK8DiPFJet300_200_TrimMass30;
+    int AK8DiPFJet300_200_TrimMass30_prescale;
+    int MET100;
+    int MET100_prescale;
+    int MET150;
+    int MET150_prescale;
+    int MET200;
+    int MET200_prescale;
+    int MET250;
+    int MET250_prescale;
+    int MET300;
+    int MET300_prescale;
+    int MET600;
+    int MET600_prescale;
+    int MET700;
+    int MET700_prescale;
+    int PFMET170_BeamHaloCleaned;
+    int PFMET170_BeamHaloCleaned_prescale;
+    int PFMET170_HBHECleaned;
+    int PFMET170_HBHECleaned_prescale;
+    int PFMET170_HBHE_BeamHaloCleaned;
+    int PFMET170_HBHE_BeamHaloCleaned_prescale;
+    int PFMET170_JetIdCleaned;
+    int PFMET170_JetIdCleaned_prescale;
+    int PFMET170_NoiseCleaned;
+    int PFMET170_NoiseCleaned_prescale;
+    int PFMET170_NotCleaned;
+    int PFMET170_NotCleaned_prescale;
+    int PFMETTypeOne190_HBHE_BeamHaloCleaned;
+    int PFMETTypeOne190_HBHE_BeamHaloCleaned_prescale;
+    int PFMET300;
+    int PFMET300_prescale;
+    int PFMET400;
+    int PFMET400_prescale;
+    int PFMET500;
+    int PFMET500_prescale;
+    int PFMET600;
+    int PFMET600_prescale;
+    int CaloMHTNoPU90_PFMET90_PFMHT90_IDTight_BTagCSV_p067;
+    int CaloMHTNoPU90_PFMET90_PFMHT90_IDTight_BTagCSV_p067_prescale;
+    int CaloMHTNoPU90_PFMET90_PFMHT90_IDTight;
+    int CaloMHTNoPU90_PFMET90_PFMHT90_IDTight_prescale;
+    int PFMET100_PFMHT100_IDTight_BeamHaloCleaned;
+    int PFMET100_PFMHT100_IDTight_BeamHaloCleaned_prescale;
+    int PFMET100_PFMHT100_IDTight;
+    int PFMET100_PFMHT100_IDTight_prescale;
+    int PFMET110_PFMHT110_IDTight;
+    int PFMET110_PFMHT110_IDTight_prescale;
+    int PFMET120_PFMHT120_IDTight;
+    int PFMET120_PFMHT120_IDTight_prescale;
+    int PFMET90_PFMHT90_IDTight;
+    int PFMET90_PFMHT90_IDTight_prescale;
+    int PFMETNoMu100_PFMHTNoMu100_IDTight;
+    int PFMETNoMu100_PFMHTNoMu100_IDTight_prescale;
+    int PFMETNoMu110_PFMHTNoMu110_IDTight;
+    int PFMETNoMu110_PFMHTNoMu110_IDTight_prescale;
+    int PFMETNoMu120_PFMHTNoMu120_IDTight;
+    int PFMETNoMu120_PFMHTNoMu120_IDTight_prescale;
+    int PFMETNoMu90_PFMHTNoMu90_IDTight;
+    int PFMETNoMu90_PFMHTNoMu90_IDTight_prescale;
+    int Mu17;
+    int Mu17_prescale;
+    int Mu20;
+    int Mu20_prescale;
+    int Mu27;
+    int Mu27_prescale;
+    int Mu50;
+    int Mu50_prescale;
+    int Mu55;
+    int Mu55_prescale;
+    int TkMu17;
+    int TkMu17_prescale;
+    int TkMu20;
+    int TkMu20_prescale;
+    int TkMu27;
+    int TkMu27_prescale;
+    int TkMu50;
+    int TkMu50_prescale;
+    int IsoMu18;
+    int IsoMu18_prescale;
+    int IsoMu20;
+    int IsoMu20_prescale;
+    int IsoMu22;
+    int IsoMu22_prescale;
+    int IsoMu24;
+    int IsoMu24_prescale;
+    int IsoMu27;
+    int IsoMu27_prescale;
+    int IsoTkMu18;
+    int IsoTkMu18_prescale;
+    int IsoTkMu20;
+    int IsoTkMu20_prescale;
+    int IsoTkMu22;
+    int IsoTkMu22_prescale;
+    int IsoTkMu24;
+    int IsoTkMu24_prescale;
+    int IsoTkMu27;
+    int IsoTkMu27_prescale;
+    int Ele17_CaloIdL_GsfTrkIdVL;
+    int Ele17_CaloIdL_GsfTrkIdVL_prescale;
+    int Ele22_eta2p1_WPLoose_Gsf;
+    int Ele22_eta2p1_WPLoose_Gsf_prescale;
+    int Ele23_WPLoose_Gsf;
+    int Ele23_WPLoose_Gsf_prescale;
+    int Ele24_eta2p1_WPLoose_Gsf;
+    int Ele24_eta2p1_WPLoose_Gsf_prescale;
+    int Ele25_WPTight_Gsf;
+    int Ele25_WPTight_Gsf_prescale;
+    int Ele25_eta2p1_WPLoose_Gsf;
+    int Ele25_eta2p1_WPLoose_Gsf_prescale;
+    int Ele25_eta2p1_WPTight_Gsf;
+    int Ele25_eta2p1_WPTight_Gsf_prescale;
+    int Ele27_WPLoose_Gsf;
+    int Ele27_WPLoose_Gsf_prescale;
+    int Ele27_WPTight_Gsf;
+    int Ele27_WPTight_Gsf_prescale;
+    int Ele27_eta2p1_WPLoose_Gsf;
+    int Ele27_eta2p1_WPLoose_Gsf_prescale;
+    int Ele27_eta2p1_WPTight_Gsf;
+    int Ele27_eta2p1_WPTight_Gsf_prescale;
+    int Ele30_WPTight_Gsf;
+    int Ele30_WPTight_Gsf_prescale;
+    int Ele30_eta2p1_WPLoose_Gsf;
+    int Ele30_eta2p1_WPLoose_Gsf_prescale;
+    int Ele30_eta2p1_WPTight_Gsf;
+    int Ele30_eta2p1_WPTight_Gsf_prescale;
+    int Ele32_WPTight_Gsf;
+    int Ele32_WPTight_Gsf_prescale;
+    int Ele32_eta2p1_WPLoose_Gsf;
+    int Ele32_eta2p1_WPLoose_Gsf_prescale;
+    int Ele32_eta2p1_WPTight_Gsf;
+    int Ele32_eta2p1_WPTight_Gsf_prescale;
+    int Ele35_WPLoose_Gsf;
+    int Ele35_WPLoose_Gsf_prescale;
+    int Ele45_WPLoose_Gsf;
+    int Ele45_WPLoose_Gsf_prescale;
+    int Ele105_CaloIdVT_GsfTrkIdT;
+    int Ele105_CaloIdVT_GsfTrkIdT_prescale;
+    int Ele115_CaloIdVT_GsfTrkIdT;
+    int Ele115_CaloIdVT_GsfTrkIdT_prescale;
+    int Ele145_CaloIdVT_GsfTrkIdT;
+    int Ele145_CaloIdVT_GsfTrkIdT_prescale;
+    int Ele200_CaloIdVT_GsfTrkIdT;
+    int Ele200_CaloIdVT_GsfTrkIdT_prescale;
+    int Ele250_CaloIdVT_GsfTrkIdT;
+    int Ele250_CaloIdVT_GsfTrkIdT_prescale;
+    int Ele300_CaloIdVT_GsfTrkIdT;
+    int Ele300_CaloIdVT_GsfTrkIdT_prescale;
+    int Mu30_eta2p1_PFJet150_PFJet50;
+    int Mu30_eta2p1_PFJet150_PFJet50_prescale;
+    int Mu40_eta2p1_PFJet200_PFJet50;
+    int Mu40_eta2p1_PFJet200_PFJet50_prescale;
+    int Ele35_CaloIdVT_GsfTrkIdT_PFJet150_PFJet50;
+    int Ele35_CaloIdVT_GsfTrkIdT_PFJet150_PFJet50_prescale;
+    int Ele45_CaloIdVT_GsfTrkIdT_PFJet200_PFJet50;
+    int Ele45_CaloIdVT_GsfTrkIdT_PFJet200_PFJet50_prescale;
+    
+    void init() {
+      PFJet40=NOVAL_I;
+      PFJet40_prescale=NOVAL_I;
+      PFJet60=NOVAL_I;
+      PFJet60_prescale=NOVAL_I;
+      PFJet80=NOVAL_I;
+      PFJet80_prescale=NOVAL_I;
+      PFJet140=NOVAL_I;
+      PFJet140_prescale=NOVAL_I;
+      PFJet200=NOVAL_I;
+      PFJet200_prescale=NOVAL_I;
+      PFJet260=NOVAL_I;
+      PFJet260_prescale=NOVAL_I;
+      PFJet320=NOVAL_I;
+      PFJet320_prescale=NOVAL_I;
+      PFJet400=NOVAL_I;
+      PFJet400_prescale=NOVAL_I;
+      PFJet450=NOVAL_I;
+      PFJet450_prescale=NOVAL_I;
+      PFJet500=NOVAL_I;
+      PFJet500_prescale=NOVAL_I;
+      AK8PFJet40=NOVAL_I;
+      AK8PFJet40_prescale=NOVAL_I;
+      AK8PFJet60=NOVAL_I;
+      AK8PFJet60_prescale=NOVAL_I;
+      AK8PFJet80=NOVAL_I;
+      AK8PFJet80_prescale=NOVAL_I;
+      AK8PFJet140=NOVAL_I;
+      AK8PFJet140_prescale=NOVAL_I;
+      AK8PFJet200=NOVAL_I;
+      AK8PFJet200_prescale=NOVAL_I;
+      AK8PFJet260=NOVAL_I;
+      AK8PFJet260_prescale=NOVAL_I;
+      AK8PFJet320=NOVAL_I;
+      AK8PFJet320_prescale=NOVAL_I;
+      AK8PFJet360_TrimMass30=NOVAL_I;
+      AK8PFJet360_TrimMass30_prescale=NOVAL_I;
+      AK8PFJet400_TrimMass30=NOVAL_I;
+      AK8PFJet400_TrimMass30_prescale=NOVAL_I;
+      AK8PFJet400=NOVAL_I;
+      AK8PFJet400_prescale=NOVAL_I;
+      AK8PFJet450=NOVAL_I;
+      AK8PFJet450_prescale=NOVAL_I;
+      AK8PFJet500=NOVAL_I;
+      AK8PFJet500_prescale=NOVAL_I;
+      PFHT125=NOVAL_I;
+      PFHT125_prescale=NOVAL_I;
+      PFHT200=NOVAL_I;
+      PFHT200_prescale=NOVAL_I;
+      PFHT250=NOVAL_I;
+      PFHT250_prescale=NOVAL_I;
+      PFHT300=NOVAL_I;
+      PFHT300_prescale=NOVAL_I;
+      PFHT350=NOVAL_I;
+      PFHT350_prescale=NOVAL_I;
+      PFHT400=NOVAL_I;
+      PFHT400_prescale=NOVAL_I;
+      PFHT475=NOVAL_I;
+      PFHT475_prescale=NOVAL_I;
+      PFHT600=NOVAL_I;
+      PFHT600_prescale=NOVAL_I;
+      PFHT650=NOVAL_I;
+      PFHT650_prescale=NOVAL_I;
+      PFHT800=NOVAL_I;
+      PFHT800_prescale=NOVAL_I;
+      PFHT900=NOVAL_I;
+      PFHT900_prescale=NOVAL_I;
+      AK8PFHT650_TrimR0p1PT0p03Mass50=NOVAL_I;
+      AK8PFHT650_TrimR0p1PT0p03Mass50_prescale=NOVAL_I;
+      AK8PFHT700_TrimR0p1PT0p03Mass50=NOVAL_I;
+      AK8PFHT700_TrimR0p1PT0p03Mass50_prescale=NOVAL_I;
+      AK8PFHT750_TrimMass50=NOVAL_I;
+      AK8PFHT750_TrimMass50_prescale=NOVAL_I;
+      AK8PFHT800_TrimMass50=NOVAL_I;
+      AK8PFHT800_TrimMass50_prescale=NOVAL_I;
+      PFHT550_4JetPt50=NOVAL_I;
+      PFHT550_4JetPt50_prescale=NOVAL_I;
+      PFHT650_4JetPt50=NOVAL_I;
+      PFHT650_4JetPt50_prescale=NOVAL_I;
+      PFHT750_4JetPt50=NOVAL_I;
+      PFHT750_4JetPt50_prescale=NOVAL_I;
+      PFHT750_4JetPt70=NOVAL_I;
+      PFHT750_4JetPt70_prescale=NOVAL_I;
+      PFHT750_4JetPt80=NOVAL_I;
+      PFHT750_4JetPt80_prescale=NOVAL_I;
+      PFHT800_4JetPt50=NOVAL_I;
+      PFHT800_4JetPt50_prescale=NOVAL_I;
+      PFHT850_4JetPt50=NOVAL_I;
+      PFHT850_4JetPt50_prescale=NOVAL_I;
+      AK8DiPFJet250_200_TrimMass30=NOVAL_I;
+      AK8DiPFJet250_200_TrimMass30_prescale=NOVAL_I;
+      AK8DiPFJet280_200_TrimMass30=NOVAL_I;
+      AK8DiPFJet280_200_TrimMass30_prescale=NOVAL_I;
+      AK8DiPFJet300_200_TrimMass30=NOVAL_I;
+      AK8DiPFJet300_200_TrimMass30_prescale=NOVAL_I;
+      MET100=NOVAL_I;
+      MET100_prescale=NOVAL_I;
+      MET150=NOVAL_I;
+      MET150_prescale=NOVAL_I;
+      MET200=NOVAL_I;
+      MET200_prescale=NOVAL_I;
+      MET250=NOVAL_I;
+      MET250_prescale=NOVAL_I;
+      MET300=NOVAL_I;
+      MET300_prescale=NOVAL_I;
+      MET600=NOVAL_I;
+      MET600_prescale=NOVAL_I;
+      MET700=NOVAL_I;
+      MET700_prescale=NOVAL_I;
+      PFMET170_BeamHaloCleaned=NOVAL_I;
+      PFMET170_BeamHaloCleaned_prescale=NOVAL_I;
+      PFMET170_HBHECleaned=NOVAL_I;
+      PFMET170_HBHECleaned_prescale=NOVAL_I;
+      PFMET170_HBHE_BeamHaloCleaned=NOVAL_I;
+      PFMET170_HBHE_BeamHaloCleaned_prescale=NOVAL_I;
+      PFMET170_JetIdCleaned=NOVAL_I;
+      PFMET170_JetIdCleaned_prescale=NOVAL_I;
+      PFMET170_NoiseCleaned=NOVAL_I;
+      PFMET170_NoiseCleaned_prescale=NOVAL_I;
+      PFMET170_NotCleaned=NOVAL_I;
+      PFMET170_NotCleaned_prescale=NOVAL_I;
+      PFMETTypeOne190_HBHE_BeamHaloCleaned=NOVAL_I;
+      PFMETTypeOne190_HBHE_BeamHaloCleaned_prescale=NOVAL_I;
+      PFMET300=NOVAL_I;
+      PFMET300_prescale=NOVAL_I;
+      PFMET400=NOVAL_I;
+      PFMET400_prescale=NOVAL_I;
+      PFMET500=NOVAL_I;
+      PFMET500_prescale=NOVAL_I;
+      PFMET600=NOVAL_I;
+      PFMET600_prescale=NOVAL_I;
+      CaloMHTNoPU90_PFMET90_PFMHT90_IDTight_BTagCSV_p067=NOVAL_I;
+      CaloMHTNoPU90_PFMET90_PFMHT90_IDTight_BTagCSV_p067_prescale=NOVAL_I;
+      CaloMHTNoPU90_PFMET90_PFMHT90_IDTight=NOVAL_I;
+      CaloMHTNoPU90_PFMET90_PFMHT90_IDTight_prescale=NOVAL_I;
+      PFMET100_PFMHT100_IDTight_BeamHaloCleaned=NOVAL_I;
+      PFMET100_PFMHT100_IDTight_BeamHaloCleaned_prescale=NOVAL_I;
+      PFMET100_PFMHT100_IDTight=NOVAL_I;
+      PFMET100_PFMHT100_IDTight_prescale=NOVAL_I;
+      PFMET110_PFMHT110_IDTight=NOVAL_I;
+      PFMET110_PFMHT110_IDTight_prescale=NOVAL_I;
+      PFMET120_PFMHT120_IDTight=NOVAL_I;
+      PFMET120_PFMHT120_IDTight_prescale=NOVAL_I;
+      PFMET90_PFMHT90_IDTight=NOVAL_I;
+      PFMET90_PFMHT90_IDTight_prescale=NOVAL_I;
+      PFMETNoMu100_PFMHTNoMu100_IDTight=NOVAL_I;
+      PFMETNoMu100_PFMHTNoMu100_IDTight_prescale=NOVAL_I;
+      PFMETNoMu110_PFMHTNoMu110_IDTight=NOVAL_I;
+      PFMETNoMu110_PFMHTNoMu110_IDTight_prescale=NOVAL_I;
+      PFMETNoMu120_PFMHTNoMu120_IDTight=NOVAL_I;
+      PFMETNoMu120_PFMHTNoMu120_IDTight_prescale=NOVAL_I;
+      PFMETNoMu90_PFMHTNoMu90_IDTight=NOVAL_I;
+      PFMETNoMu90_PFMHTNoMu90_IDTight_prescale=NOVAL_I;
+      Mu17=NOVAL_I;
+      Mu17_prescale=NOVAL_I;
+      Mu20=NOVAL_I;
+      Mu20_prescale=NOVAL_I;
+      Mu27=NOVAL_I;
+      Mu27_prescale=NOVAL_I;
+      Mu50=NOVAL_I;
+      Mu50_prescale=NOVAL_I;
+      Mu55=NOVAL_I;
+      Mu55_prescale=NOVAL_I;
+      TkMu17=NOVAL_I;
+      TkMu17_prescale=NOVAL_I;
+      TkMu20=NOVAL_I;
+      TkMu20_prescale=NOVAL_I;
+      TkMu27=NOVAL_I;
+      TkMu27_prescale=NOVAL_I;
+      TkMu50=NOVAL_I;
+      TkMu50_prescale=NOVAL_I;
+      IsoMu18=NOVAL_I;
+      IsoMu18_prescale=NOVAL_I;
+      IsoMu20=NOVAL_I;
+      IsoMu20_prescale=NOVAL_I;
+      IsoMu22=NOVAL_I;
+      IsoMu22_prescale=NOVAL_I;
+      IsoMu24=NOVAL_I;
+      IsoMu24_prescale=NOVAL_I;
+      IsoMu27=NOVAL_I;
+      IsoMu27_prescale=NOVAL_I;
+      IsoTkMu18=NOVAL_I;
+      IsoTkMu18_prescale=NOVAL_I;
+      IsoTkMu20=NOVAL_I;
+      IsoTkMu20_prescale=NOVAL_I;
+      IsoTkMu22=NOVAL_I;
+      IsoTkMu22_prescale=NOVAL_I;
+      IsoTkMu24=NOVAL_I;
+      IsoTkMu24_prescale=NOVAL_I;
+      IsoTkMu27=NOVAL_I;
+      IsoTkMu27_prescale=NOVAL_I;
+      Ele17_CaloIdL_GsfTrkIdVL=NOVAL_I;
+      Ele17_CaloIdL_GsfTrkIdVL_prescale=NOVAL_I;
+      Ele22_eta2p1_WPLoose_Gsf=NOVAL_I;
+      Ele22_eta2p1_WPLoose_Gsf_prescale=NOVAL_I;
+      Ele23_WPLoose_Gsf=NOVAL_I;
+      Ele23_WPLoose_Gsf_prescale=NOVAL_I;
+      Ele24_eta2p1_WPLoose_Gsf=NOVAL_I;
+      Ele24_eta2p1_WPLoose_Gsf_prescale=NOVAL_I;
+      Ele25_WPTight_Gsf=NOVAL_I;
+      Ele25_WPTight_Gsf_prescale=NOVAL_I;
+      Ele25_eta2p1_WPLoose_Gsf=NOVAL_I;
+      Ele25_eta2p1_WPLoose_Gsf_prescale=NOVAL_I;
+      Ele25_eta2p1_WPTight_Gsf=NOVAL_I;
+      Ele25_eta2p1_WPTight_Gsf_prescale=NOVAL_I;
+      Ele27_WPLoose_Gsf=NOVAL_I;
+      Ele27_WPLoose_Gsf_prescale=NOVAL_I;
+      Ele27_WPTight_Gsf=NOVAL_I;
+      Ele27_WPTight_Gsf_prescale=NOVAL_I;
+      Ele27_eta2p1_WPLoose_Gsf=NOVAL_I;
+      Ele27_eta2p1_WPLoose_Gsf_prescale=NOVAL_I;
+      Ele27_eta2p1_WPTight_Gsf=NOVAL_I;
+      Ele27_eta2p1_WPTight_Gsf_prescale=NOVAL_I;
+      Ele30_WPTight_Gsf=NOVAL_I;
+      Ele30_WPTight_Gsf_prescale=NOVAL_I;
+      Ele30_eta2p1_WPLoose_Gsf=NOVAL_I;
+      Ele30_eta2p1_WPLoose_Gsf_prescale=NOVAL_I;
+      Ele30_eta2p1_WPTight_Gsf=NOVAL_I;
+      Ele30_eta2p1_WPTight_Gsf_prescale=NOVAL_I;
+      Ele32_WPTight_Gsf=NOVAL_I;
+      Ele32_WPTight_Gsf_prescale=NOVAL_I;
+      Ele32_eta2p1_WPLoose_Gsf=NOVAL_I;
+      Ele32_eta2p1_WPLoose_Gsf_prescale=NOVAL_I;
+      Ele32_eta2p1_WPTight_Gsf=NOVAL_I;
+      Ele32_eta2p1_WPTight_Gsf_prescale=NOVAL_I;
+      Ele35_WPLoose_Gsf=NOVAL_I;
+      Ele35_WPLoose_Gsf_prescale=NOVAL_I;
+      Ele45_WPLoose_Gsf=NOVAL_I;
+      Ele45_WPLoose_Gsf_prescale=NOVAL_I;
+      Ele105_CaloIdVT_GsfTrkIdT=NOVAL_I;
+      Ele105_CaloIdVT_GsfTrkIdT_prescale=NOVAL_I;
+      Ele115_CaloIdVT_GsfTrkIdT=NOVAL_I;
+      Ele115_CaloIdVT_GsfTrkIdT_prescale=NOVAL_I;
+      Ele145_CaloIdVT_GsfTrkIdT=NOVAL_I;
+      Ele145_CaloIdVT_GsfTrkIdT_prescale=NOVAL_I;
+      Ele200_CaloIdVT_GsfTrkIdT=NOVAL_I;
+      Ele200_CaloIdVT_GsfTrkIdT_prescale=NOVAL_I;
+      Ele250_CaloIdVT_GsfTrkIdT=NOVAL_I;
+      Ele250_CaloIdVT_GsfTrkIdT_prescale=NOVAL_I;
+      Ele300_CaloIdVT_GsfTrkIdT=NOVAL_I;
+      Ele300_CaloIdVT_GsfTrkIdT_prescale=NOVAL_I;
+      Mu30_eta2p1_PFJet150_PFJet50=NOVAL_I;
+      Mu30_eta2p1_PFJet150_PFJet50_prescale=NOVAL_I;
+      Mu40_eta2p1_PFJet200_PFJet50=NOVAL_I;
+      Mu40_eta2p1_PFJet200_PFJet50_prescale=NOVAL_I;
+      Ele35_CaloIdVT_GsfTrkIdT_PFJet150_PFJet50=NOVAL_I;
+      Ele35_CaloIdVT_GsfTrkIdT_PFJet150_PFJet50_prescale=NOVAL_I;
+      Ele45_CaloIdVT_GsfTrkIdT_PFJet200_PFJet50=NOVAL_I;
+      Ele45_CaloIdVT_GsfTrkIdT_PFJet200_PFJet50_prescale=NOVAL_I;
+    }
+    
+  } hlt;
+  
+  class GenVars {
+  public:
+    GenVars() { init(); };
+    
+    SoAArena arena{SOA_CAPACITY};
+    unsigned int size;
+    SoAColumn<int> ID{arena, size};
+    SoAColumn<int> Status{arena, size};
+    SoAColumn<int> Mom0ID{arena, size};
+    SoAColumn<int> Mom0Status{arena, size};
+    SoAColumn<int> Mom1ID{arena, size};
+    SoAColumn<int> Mom1Status{arena, size};
+    SoAColumn<int> Dau0ID{arena, size};
+    SoAColumn<int> Dau0Status{arena, size};
+    SoAColumn<int> Dau1ID{arena, size};
+    SoAColumn<int> Dau1Status{arena, size};
+    SoAColumn<float> Pt{arena, size};
+    SoAColumn<float> Eta{arena, size};
+    SoAColumn<float> Phi{arena, size};
+    SoAColumn<float> E{arena, size};
+    SoAColumn<float> Mass{arena, size};
+    SoAColumn<float> Charge{arena, size};
+    
+    unsigned int it;
+    
+    void init() {
+      it = -1;
+      size=9999;
+      arena.fill();
+    }
+    
+    bool Loop() {
+      if (size==9999) return 0;
+      ++it;
+      if (it<size) {
+        return 1;
+      } else {
+        it=-1;
+        return 0;
+      }
+    }
+    
+  } gen;
+  
+  class PhotonVars {
+  public:
+    PhotonVars() { init(); };
+    
+    SoAArena arena{SOA_CAPACITY};
+    unsigned int size;
+    SoAColumn<float> Pt{arena, size};
+    SoAColumn<float> Eta{arena, size};
+    SoAColumn<float> Phi{arena, size};
+    SoAColumn<float> E{arena, size};
+    SoAColumn<float> Charge{arena, size};
+    SoAColumn<float> SCEta{arena, size};
+    SoAColumn<float> SCPhi{arena, size};
+    SoAColumn<float> SCRawE{arena, size};
+    SoAColumn<float> HasPixelSeed{arena, size};
+    SoAColumn<float> ElectronVeto{arena, size};
+    SoAColumn<float> SigmaIEtaIEta{arena, size};
+    SoAColumn<float> SigmaIEtaIPhi{arena, size};
+    SoAColumn<float> SigmaIPhiIPhi{arena, size};
+    SoAColumn<float> E1x5{arena, size};
+    SoAColumn<float> E5x5{arena, size};
+    SoAColumn<float> HoverE{arena, size};
+    SoAColumn<float> R9{arena, size};
+    SoAColumn<float> ChargedHadronIso{arena, size};
+    SoAColumn<float> PhotonIso{arena, size};
+    SoAColumn<float> NeutralHadronIso{arena, size};
+    SoAColumn<float> PhotonIsoEAcorrectedsp15{arena, size};
+    SoAColumn<float> NeutralHadronIsoEAcorrectedsp15{arena, size};
+    SoAColumn<float> PassLooseID{arena, size};
+    SoAColumn<float> PassMediumID{arena, size};
+    SoAColumn<float> PassTightID{arena, size};
+    SoAColumn<int> isPromptDirect{arena, size};
+    SoAColumn<int> isPromptFrag{arena, size};
+    SoAColumn<int> isFake{arena, size};
+    
+    unsigned int it;
+    
+    void init() {
+      it = -1;
+      size=9999;
+      arena.fill();
+    }
+    
+    bool Loop() {
+      if (size==9999) return 0;
+      ++it;
+      if (it<size) {
+        return 1;
+      } else {
+        it=-1;
+        return 0;
+      }
+    }
+    
+  } pho;
+  
+  class ElectronVars {
+  public:
+    ElectronVars() { init(); };
+    
+    SoAArena arena{SOA_CAPACITY};
+    unsigned int size;
+    SoAColumn<float> Pt{arena, size};
+    SoAColumn<float> Eta{arena, size};
+    SoAColumn<float> Phi{arena, size};
+    SoAColumn<float> E{arena, size};
+    SoAColumn<float> Charge{arena, size};
+    SoAColumn<float> Key{arena, size};
+    SoAColumn<float> Iso03{arena, size};
+    SoAColumn<float> Iso03db{arena, size};
+    SoAColumn<float> MiniIso{arena, size};
+    SoAColumn<float> Dxy{arena, size};
+    SoAColumn<float> Dz{arena, size};
+    SoAColumn<float> DB{arena, size};
+    SoAColumn<float> DBerr{arena, size};
+    SoAColumn<float> SCEta{arena, size};
+    SoAColumn<float> vidVeto{arena, size};
+    SoAColumn<float> vidLoose{arena, size};
+    SoAColumn<float> vidMedium{arena, size};
+    SoAColumn<float> vidTight{arena, size};
+    SoAColumn<float> vidHEEP{arena, size};
+    SoAColumn<float> vidVetonoiso{arena, size};
+    SoAColumn<float> vidLoosenoiso{arena, size};
+    SoAColumn<float> vidMediumnoiso{arena, size};
+    SoAColumn<float> vidTightnoiso{arena, size};
+    SoAColumn<float> vidHEEPnoiso{arena, size};
+    SoAColumn<float> vidMvaGPvalue{arena, size};
+    SoAColumn<float> vidMvaGPcateg{arena, size};
+    SoAColumn<float> vidMvaHZZvalue{arena, size};
+    SoAColumn<float> vidMvaHZZcateg{arena, size};
+    SoAColumn<int> IsPartOfNearAK4Jet{arena, size};
+    SoAColumn<int> IsPartOfNearAK8Jet{arena, size};
+    SoAColumn<int> IsPartOfNearSubjet{arena, size};
+    SoAColumn<float> DRNearGenEleFromSLTop{arena, size};
+    SoAColumn<float> PtNearGenEleFromSLTop{arena, size};
+    SoAColumn<float> PtNearGenTop{arena, size};
+    SoAColumn<float> LepAK4JetFrac{arena, size};
+    SoAColumn<float> LepAK8JetFrac{arena, size};
+    SoAColumn<float> LepSubjetFrac{arena, size};
+    SoAColumn<float> LepAK4JetMassDrop{arena, size};
+    SoAColumn<float> LepAK8JetMassDrop{arena, size};
+    SoAColumn<float> LepSubjetMassDrop{arena, size};
+    SoAColumn<float> AK4JetV1DR{arena, size};
+    SoAColumn<float> AK4JetV2DR{arena, size};
+    SoAColumn<float> AK4JetV3DR{arena, size};
+    SoAColumn<float> AK8JetV1DR{arena, size};
+    SoAColumn<float> AK8JetV2DR{arena, size};
+    SoAColumn<float> AK8JetV3DR{arena, size};
+    SoAColumn<float> SubjetV1DR{arena, size};
+    SoAColumn<float> SubjetV2DR{arena, size};
+    SoAColumn<float> SubjetV3DR{arena, size};
+    SoAColumn<float> AK4JetV1PtRel{arena, size};
+    SoAColumn<float> AK4JetV2PtRel{arena, size};
+    SoAColumn<float> AK4JetV3PtRel{arena, size};
+    SoAColumn<float> AK8JetV1PtRel{arena, size};
+    SoAColumn<float> AK8JetV2PtRel{arena, size};
+    SoAColumn<float> AK8JetV3PtRel{arena, size};
+    SoAColumn<float> SubjetV1PtRel{arena, size};
+    SoAColumn<float> SubjetV2PtRel{arena, size};
+    SoAColumn<float> SubjetV3PtRel{arena, size};
+    
+    unsigned int it;
+    
+    void init() {
+      it = -1;
+      size=9999;
+      arena.fill();
+    }
+    
+    bool Loop() {
+      if (size==9999) return 0;
+      ++it;
+      if (it<size) {
+        return 1;
+      } else {
+        it=-1;
+        return 0;
+      }
+    }
+    
+  } ele;
+  
+  class MuonVars {
+  public:
+    MuonVars() { init(); };
+    
+    SoAArena arena{SOA_CAPACITY};
+    unsigned int size;
+    SoAColumn<float> Pt{arena, size};
+    SoAColumn<float> Eta{arena, size};
+    SoAColumn<float> Phi{arena, size};
+    SoAColumn<float> E{arena, size};
+    SoAColumn<float> Charge{arena, size};
+    SoAColumn<float> Key{arena, size};
+    SoAColumn<float> Iso04{arena, size};
+    SoAColumn<float> MiniIso{arena, size};
+    SoAColumn<float> Dxy{arena, size};
+    SoAColumn<float> Dz{arena, size};
+    SoAColumn<float> DB{arena, size};
+    SoAColumn<float> DBerr{arena, size};
+    SoAColumn<float> IsSoftMuon{arena, size};
+    SoAColumn<float> IsLooseMuon{arena, size};
+    SoAColumn<float> IsMediumMuon{arena, size};
+    SoAColumn<float> IsMediumMuon2016{arena, size};
+    SoAColumn<float> IsTightMuon{arena, size};
+    SoAColumn<float> IsHighPtMuon{arena, size};
+    SoAColumn<int> IsPartOfNearAK4Jet{arena, size};
+    SoAColumn<int> IsPartOfNearAK8Jet{arena, size};
+    SoAColumn<int> IsPartOfNearSubjet{arena, size};
+    SoAColumn<float> DRNearGenMuFromSLTop{arena, size};
+    SoAColumn<float> PtNearGenMuFromSLTop{arena, size};
+    SoAColumn<float> PtNearGenTop{arena, size};
+    SoAColumn<float> LepAK4JetFrac{arena, size};
+    SoAColumn<float> LepAK8JetFrac{arena, size};
+    SoAColumn<float> LepSubjetFrac{arena, size};
+    SoAColumn<float> LepAK4JetMassDrop{arena, size};
+    SoAColumn<float> LepAK8JetMassDrop{arena, size};
+    SoAColumn<float> LepSubjetMassDrop{arena, size};
+    SoAColumn<float> AK4JetV1DR{arena, size};
+    SoAColumn<float> AK4JetV2DR{arena, size};
+    SoAColumn<float> AK4JetV3DR{arena, size};
+    SoAColumn<float> AK8JetV1DR{arena, size};
+    SoAColumn<float> AK8JetV2DR{arena, size};
+    SoAColumn<float> AK8JetV3DR{arena, size};
+    SoAColumn<float> SubjetV1DR{arena, size};
+    SoAColumn<float> SubjetV2DR{arena, size};
+    SoAColumn<float> SubjetV3DR{arena, size};
+    SoAColumn<float> AK4JetV1PtRel{arena, size};
+    SoAColumn<float> AK4JetV2PtRel{arena, size};
+    SoAColumn<float> AK4JetV3PtRel{arena, size};
+    SoAColumn<float> AK8JetV1PtRel{arena, size};
+    SoAColumn<float> AK8JetV2PtRel{arena, size};
+    SoAColumn<float> AK8JetV3PtRel{arena, size};
+    SoAColumn<float> SubjetV1PtRel{arena, size};
+    SoAColumn<float> SubjetV2PtRel{arena, size};
+    SoAColumn<float> SubjetV3PtRel{arena, size};
+    
+    unsigned int it;
+    
+    void init() {
+      it = -1;
+      size=9999;
+      arena.fill();
+    }
+    
+    bool Loop() {
+      if (size==9999) return 0;
+      ++it;
+      if (it<size) {
+        return 1;
+      } else {
+        it=-1;
+        return 0;
+      }
+    }
+    
+  } mu;
+  
+  class AK4JetVars {
+  public:
+    AK4JetVars() { init(); };
+    
+    SoAArena arena{SOA_CAPACITY};
+    unsigned int size;
+    SoAColumn<float> Pt{arena, size};
+    SoAColumn<float> Eta{arena, size};
+    SoAColumn<float> Phi{arena, size};
+    SoAColumn<float> E{arena, size};
+    SoAColumn<float> Charge{arena, size};
+    SoAColumn<float> CSVv2{arena, size};
+    SoAColumn<float> CMVAv2{arena, size};
+    SoAColumn<float> CvsL{arena, size};
+    SoAColumn<float> CvsB{arena, size};
+    SoAColumn<float> GenPartonEta{arena, size};
+    SoAColumn<float> GenPartonPhi{arena, size};
+    SoAColumn<float> GenPartonPt{arena, size};
+    SoAColumn<float> GenPartonE{arena, size};
+    SoAColumn<float> GenPartonCharge{arena, size};
+    SoAColumn<float> PartonFlavour{arena, size};
+    SoAColumn<float> HadronFlavour{arena, size};
+    SoAColumn<float> GenJetEta{arena, size};
+    SoAColumn<float> GenJetPhi{arena, size};
+    SoAColumn<float> GenJetPt{arena, size};
+    SoAColumn<float> GenJetE{arena, size};
+    SoAColumn<float> GenJetCharge{arena, size};
+    SoAColumn<float> jecFactor0{arena, size};
+    SoAColumn<float> jecUncertainty{arena, size};
+    SoAColumn<float> JERSF{arena, size};
+    SoAColumn<float> JERSFUp{arena, size};
+    SoAColumn<float> JERSFDown{arena, size};
+    SoAColumn<float> SmearedPt{arena, size};
+    std::vector<std::vector<int> > Keys;
+    SoAColumn<int> looseJetID{arena, size};
+    SoAColumn<int> tightJetID{arena, size};
+    SoAColumn<int> tightLepVetoJetID{arena, size};
+    
+    unsigned int it;
+    
+    void init() {
+      it = -1;
+      size=9999;
+      arena.fill();
+      init_vec(Keys);
+    }
+    
+    bool Loop() {
+      if (size==9999) return 0;
+      ++it;
+      if (it<size) {
+        return 1;
+      } else {
+        it=-1;
+        return 0;
+      }
+    }
+    
+  } jetsAK4;
+  
+  class AK8JetVars {
+  public:
+    AK8JetVars() { init(); };
+    
+    SoAArena arena{SOA_CAPACITY};
+    unsigned int size;
+    SoAColumn<float> Pt{arena, size};
+    SoAColumn<float> Eta{arena, size};
+    SoAColumn<float> Phi{arena, size};
+    SoAColumn<float> E{arena, size};
+    SoAColumn<float> Charge{arena, size};
+    SoAColumn<float> CSVv2{arena, size};
+    SoAColumn<float> CMVAv2{arena, size};
+    SoAColumn<float> CvsL{arena, size};
+    SoAColumn<float> CvsB{arena, size};
+    SoAColumn<float> GenPartonEta{arena, size};
+    SoAColumn<float> GenPartonPhi{arena, size};
+    SoAColumn<float> GenPartonPt{arena, size};
+    SoAColumn<float> GenPartonE{arena, size};
+    SoAColumn<float> GenPartonCharge{arena, size};
+    SoAColumn<float> PartonFlavour{arena, size};
+    SoAColumn<float> HadronFlavour{arena, size};
+    SoAColumn<float> GenJetEta{arena, size};
+    SoAColumn<float> GenJetPhi{arena, size};
+    SoAColumn<float> GenJetPt{arena, size};
+    SoAColumn<float> GenJetE{arena, size};
+    SoAColumn<float> GenJetCharge{arena, size};
+    SoAColumn<float> jecFactor0{arena, size};
+    SoAColumn<float> jecUncertainty{arena, size};
+    SoAColumn<float> JERSF{arena, size};
+    SoAColumn<float> JERSFUp{arena, size};
+    SoAColumn<float> JERSFDown{arena, size};
+    SoAColumn<float> SmearedPt{arena, size};
+    SoAColumn<float> vSubjetIndex0{arena, size};
+    SoAColumn<float> vSubjetIndex1{arena, size};
+    SoAColumn<float> tau1CHS{arena, size};
+    SoAColumn<float> tau2CHS{arena, size};
+    SoAColumn<float> tau3CHS{arena, size};
+    SoAColumn<float> softDropMassCHS{arena, size};
+    SoAColumn<float> softDropMassPuppi{arena, size};
+    SoAColumn<float> PtPuppi{arena, size};
+    SoAColumn<float> EtaPuppi{arena, size};
+    SoAColumn<float> PhiPuppi{arena, size};
+    SoAColumn<float> MassPuppi{arena, size};
+    SoAColumn<float> tau1Puppi{arena, size};
+    SoAColumn<float> tau2Puppi{arena, size};
+    SoAColumn<float> tau3Puppi{arena, size};
+    SoAColumn<float> uncorrSDMassPuppi{arena, size};
+    SoAColumn<float> corrSDMassPuppi{arena, size};
+    std::vector<std::vector<int> > Keys;
+    SoAColumn<int> HasNearGenTop{arena, size};
+    SoAColumn<int> NearGenTopIsHadronic{arena, size};
+    SoAColumn<int> NearGenWIsHadronic{arena, size};
+    SoAColumn<int> NearGenWToENu{arena, size};
+    SoAColumn<int> NearGenWToMuNu{arena, size};
+    SoAColumn<int> NearGenWToTauNu{arena, size};
+    SoAColumn<int> looseJetID{arena, size};
+    SoAColumn<int> tightJetID{arena, size};
+    SoAColumn<int> tightLepVetoJetID{arena, size};
+    SoAColumn<float> maxSubjetCSVv2{arena, size};
+    SoAColumn<float> maxSubjetCMVAv2{arena, size};
+    SoAColumn<float> DRNearGenTop{arena, size};
+    SoAColumn<float> DRNearGenWFromTop{arena, size};
+    SoAColumn<float> DRNearGenBFromTop{arena, size};
+    SoAColumn<float> DRNearGenLepFromSLTop{arena, size};
+    SoAColumn<float> DRNearGenNuFromSLTop{arena, size};
+    SoAColumn<float> PtNearGenTop{arena, size};
+    SoAColumn<float> PtNearGenBFromTop{arena, size};
+    SoAColumn<float> PtNearGenWFromTop{arena, size};
+    SoAColumn<float> PtNearGenLepFromSLTop{arena, size};
+    SoAColumn<float> PtNearGenNuFromSLTop{arena, size};
+    
+    unsigned int it;
+    
+    void init() {
+      it = -1;
+      size=9999;
+      arena.fill();
+      init_vec(Keys);
+    }
+    
+    bool Loop() {
+      if (size==9999) return 0;
+      ++it;
+      if (it<size) {
+        return 1;
+      } else {
+        it=-1;
+        return 0;
+      }
+    }
+    
+  } jetsAK8;
+  
+  class AK8SubjetVars {
+  public:
+    AK8SubjetVars() { init(); };
+    
+    unsigned int size;
+    std::vector<float> Pt;
+    std::vector<float> Eta;
+    std::vector<float> Phi;
+    std::vector<float> E;
+    std::vector<float> Charge;
+    std::vector<float> CSVv2;
+    std::vector<float> CMVAv2;
+    std::vector<float> CvsL;
+    std::vector<float> CvsB;
+    std::vector<float> GenPartonEta;
+    std::vector<float> GenPartonPhi;
+    std::vector<float> GenPartonPt;
+    std::vector<float> GenPartonE;
+    std::vector<float> GenPartonCharge;
+    std::vector<float> PartonFlavour;
+    std::vector<float> HadronFlavour;
+    std::vector<float> GenJetEta;
+    std::vector<float> GenJetPhi;
+    std::vector<float> GenJetPt;
+    std::vector<float> GenJetE;
+    std::vector<float> GenJetCharge;
+    std::vector<float> jecFactor0;
+    std::vector<std::vector<int> > Keys;
+    std::vector<int> looseJetID;
+    std::vector<int> tightJetID;
+    std::vector<int> tightLepVetoJetID;
+    
+    unsigned int it;
+    
+    void init() {
+      it = -1;
+      size=9999;
+      init_vec(Pt);
+      init_vec(Eta);
+      init_vec(Phi);
+      init_vec(E);
+      init_vec(Charge);
+      init_vec(CSVv2);
+      init_vec(CMVAv2);
+      init_vec(CvsL);
+      init_vec(CvsB);
+      init_vec(GenPartonEta);
+      init_vec(GenPartonPhi);
+      init_vec(GenPartonPt);
+      init_vec(GenPartonE);
+      init_vec(GenPartonCharge);
+      init_vec(PartonFlavour);
+      init_vec(HadronFlavour);
+      init_vec(GenJetEta);
+      init_vec(GenJetPhi);
+      init_vec(GenJetPt);
+      init_vec(GenJetE);
+      init_vec(GenJetCharge);
+      init_vec(jecFactor0);
+      init_vec(Keys);
+      init_vec(looseJetID);
+      init_vec(tightJetID);
+      init_vec(tightLepVetoJetID);
+    }
+    
+    bool Loop() {
+      if (size==9999) return 0;
+      ++it;
+      if (it<size) {
+        return 1;
+      } else {
+        it=-1;
+        return 0;
+      }
+    }
+    
+  } subjetsAK8;
+  
+  class AK8GenJetVars {
+  public:
+    AK8GenJetVars() { init(); };
+    
+    unsigned int size;
+    std::vector<float> Pt;
+    std::vector<float> Eta;
+    std::vector<float> Phi;
+    std::vector<float> E;
+    std::vector<float> Charge;
+    
+    unsigned int it;
+    
+    void init() {
+      it = -1;
+      size=9999;
+      init_vec(Pt);
+      init_vec(Eta);
+      init_vec(Phi);
+      init_vec(E);
+      init_vec(Charge);
+    }
+    
+    bool Loop() {
+      if (size==9999) return 0;
+      ++it;
+      if (it<size) {
+        return 1;
+      } else {
+        it=-1;
+        return 0;
+      }
+    }
+    
+  } genjetsAK8;
+  
+
+};
+
+#endif
+
@@ -0,0 +1,126 @@
+#ifndef DELTARMATCH_H
+#define DELTARMATCH_H
+//-----------------------------------------------------------------------------
+// File:        DeltaRMatch.h
+// Description: DeltaR/DeltaPhi matching between two object collections
+//              match() computes the DeltaR^2 and |DeltaPhi| of all pairs from
+//              the (eta, phi) arrays of the two sides (or from FourVectors),
+//              the inner loop has no branches (the wrap-around of DeltaPhi is
+//              a min), so it is vectorized. The results are then read for
+//              any pair, or the nearest object of the other side (optionally
+//              only those passing a PassMask, within a cone) is looked up:
+//
+//              ele_AK4.match(v4_ele, v4_AK4);
+//              int j = ele_AK4.nearest(i, &passLooseJet);
+//              if (j!=-1) ... ele_AK4.dR(i, j)
+//
+//              The values and the choice of the nearest are the same as with
+//              FourVector::DeltaR and a loop with dR < min.
+//              The memory is kept, so this does not allocate in the event loop.
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "FourVector.h"
+#include "PassMask.h"
+
+class DeltaRMatch {
+public:
+  size_t rows() const { return na_; }
+  size_t cols() const { return nb_; }
+
+  // Side a: rows, side b: columns (phi in [-pi, pi])
+  void match(const double* eta_a, const double* phi_a, const size_t& na,
+             const double* eta_b, const double* phi_b, const size_t& nb)
+  {
+    na_ = na;
+    nb_ = nb;
+    dr2_.resize(na*nb);
+    dphi_.resize(na*nb);
+    for (size_t i=0; i<na; ++i) {
+      const double eta = eta_a[i], phi = phi_a[i];
+      double* dr2  = dr2_.data()  + i*nb;
+      double* dphi = dphi_.data() + i*nb;
+      for (size_t j=0; j<nb; ++j) {
+        double dp = std::abs(phi - phi_b[j]);
+        dp = std::min(dp, 2*M_PI - dp);
+        double de = eta - eta_b[j];
+        dphi[j] = dp;
+        dr2[j]  = de*de + dp*dp;
+      }
+    }
+  }
+
+  void match(const std::vector<FourVector>& a, const std::vector<FourVector>& b)
+  {
+    fill_(a, eta_a_, phi_a_);
+    fill_(b, eta_b_, phi_b_);
+    match(eta_a_.data(), phi_a_.data(), a.size(), eta_b_.data(), phi_b_.data(), b.size());
+  }
+
+  double dR2 (const size_t& i, const size_t& j) const { return dr2_[i*nb_+j]; }
+  double dR  (const size_t& i, const size_t& j) const { return std::sqrt(dr2_[i*nb_+j]); }
+  double dPhi(const size_t& i, const size_t& j) const { return dphi_[i*nb_+j]; }
+
+  // Nearest column to row i (only those passing pass, if given) with dR < cone, -1 if none
+  int nearest(const size_t& i, const PassMask* pass = 0, const double& cone = 9999) const
+  {
+    const double* dr2 = dr2_.data() + i*nb_;
+    int best = -1;
+    double best_dr2 = std::numeric_limits<double>::infinity();
+    for (size_t j=0; j<nb_; ++j) if ((!pass || (*pass)[j]) && dr2[j] < best_dr2) {
+      best_dr2 = dr2[j];
+      best = j;
+    }
+    if (best == -1 || !(std::sqrt(best_dr2) < cone)) return -1;
+    // A loop on dR picks the first one with the same sqrt (not just the same dR^2)
+    const double best_dr = std::sqrt(best_dr2);
+    for (int j=0; j<best; ++j) if ((!pass || (*pass)[j]) && std::sqrt(dr2[j]) == best_dr) return j;
+    return best;
+  }
+
+  // Smallest dR/|dPhi| of row i (only to columns passing pass, if given), 9999 if none
+  double minDR(const size_t& i, const PassMask* pass = 0) const
+  {
+    int j = nearest(i, pass);
+    return j == -1 ? 9999 : dR(i, j);
+  }
+
+  double minDPhi(const size_t& i, const PassMask* pass = 0) const
+  {
+    const double* dphi = dphi_.data() + i*nb_;
+    double min = 9999;
+    for (size_t j=0; j<nb_; ++j) if ((!pass || (*pass)[j]) && dphi[j] < min) min = dphi[j];
+    return min;
+  }
+
+  // Nearest column (-1 if none) and its dR (9999 if none) for all rows
+  void nearest(std::vector<int>& index, std::vector<double>& dr, const PassMask* pass = 0, const double& cone = 9999) const
+  {
+    index.resize(na_);
+    dr.resize(na_);
+    for (size_t i=0; i<na_; ++i) {
+      index[i] = nearest(i, pass, cone);
+      dr[i] = index[i] == -1 ? 9999 : dR(i, index[i]);
+    }
+  }
+
+private:
+  size_t na_ = 0, nb_ = 0;
+  std::vector<double> dr2_, dphi_;
+  std::vector<double> eta_a_, phi_a_, eta_b_, phi_b_;
+
+  static void fill_(const std::vector<FourVector>& v, std::vector<double>& eta, std::vector<double>& phi)
+  {
+    eta.resize(v.size());
+    phi.resize(v.size());
+    for (size_t i=0, n=v.size(); i<n; ++i) {
+      eta[i] = v[i].Eta();
+      phi[i] = v[i].Phi();
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef DERIVEDVARIABLES_H
+#define DERIVEDVARIABLES_H
+//-----------------------------------------------------------------------------
+// File:        DerivedVariables.h
+// Description: Registry of derived variables (groups of variables calculated
+//              together, eg. lepton IDs) with the inputs they depend on
+//              An input is either data changed from outside (eg. "jets",
+//              changed by the JES/JER/MET variations) or another variable.
+//              A variable is calculated at the first access (get) after any
+//              of its inputs changed, and kept until then, so eg. the lepton
+//              IDs are calculated once per event, while the jet dependent
+//              variables are recalculated for each systematic variation:
+//
+//              vars.define("event");                     // input
+//              vars.define("jets", {"event"});           // input, also changes with the event
+//              vars.define("leptons", {"event"}, [&] { ... });
+//              vars.define("razor", {"jets", "leptons"}, [&] { ... });
+//              vars.invalidate("jets");                  // after rescaling the jets
+//              vars.get("razor");                        // only razor is recalculated
+//-----------------------------------------------------------------------------
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+
+class DerivedVariables {
+public:
+  // The inputs have to be defined before (so there are no cycles)
+  // Without a calculate function, name is an input
+  void define(const std::string& name, const std::vector<std::string>& inputs = {},
+              std::function<void()> calculate = nullptr)
+  {
+    if ( index_.count(name) ) utils::error("DerivedVariables::define: "+name+" is already defined");
+    size_t id = vars_.size();
+    vars_.push_back({ name, {}, {}, calculate, !calculate, 0 });
+    for (const auto& input : inputs) {
+      size_t in = id_(input);
+      vars_[id].inputs.push_back(in);
+      vars_[in].dependents.push_back(id);
+    }
+    index_[name] = id;
+  }
+
+  // The input (or variable) changed: everything depending on it is recalculated at the next access
+  void invalidate(const std::string& name) { invalidate_(id_(name)); }
+
+  // Calculate the variable (and the variables it depends on) if it is not up to date
+  void get(const std::string& name) { get_(id_(name)); }
+
+  void get_all() { for (size_t id=0; id<vars_.size(); ++id) get_(id); }
+
+  bool valid(const std::string& name) const { return vars_[id_(name)].valid; }
+
+  // How many times each variable was calculated
+  void print_counts() const
+  {
+    for (const auto& var : vars_) if (var.calculate)
+      std::cout<<"DerivedVariables - "<<var.name<<" calculated "<<var.ncalc<<" times"<<std::endl;
+  }
+
+private:
+  typedef struct Var {
+    std::string name;
+    std::vector<size_t> inputs;
+    std::vector<size_t> dependents;
+    std::function<void()> calculate;
+    bool valid;
+    size_t ncalc;
+  } Var;
+
+  std::vector<Var> vars_;
+  std::map<std::string, size_t> index_;
+
+  size_t id_(const std::string& name) const
+  {
+    auto it = index_.find(name);
+    if ( it == index_.end() ) utils::error("DerivedVariables: "+name+" is not defined");
+    return it->second;
+  }
+
+  void invalidate_(const size_t& id)
+  {
+    // Inputs stay valid, only the variables depending on them are recalculated
+    if ( vars_[id].calculate ) {
+      if ( !vars_[id].valid ) return;
+      vars_[id].valid = false;
+    }
+    for (const auto& dep : vars_[id].dependents) invalidate_(dep);
+  }
+
+  void get_(const size_t& id)
+  {
+    Var& var = vars_[id];
+    if ( var.valid ) return;
+    for (const auto& in : var.inputs) get_(in);
+    var.calculate();
+    var.valid = true;
+    ++var.ncalc;
+  }
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef FOURVECTOR_H
+#define FOURVECTOR_H
+//-----------------------------------------------------------------------------
+// File:        FourVector.h
+// Description: Plain (trivially copyable) four-vector for the hot loops of the
+//              common variables, used instead of TLorentzVector
+//              Both the cartesian (px, py, pz, E) and the pt, eta, phi form
+//              are stored, so after it is made once per object (eg. with
+//              fillFourVectors from the columns of a collection) DeltaR,
+//              DeltaPhi, Pt, Phi etc. are just reads, no trigonometry.
+//              The accessors have the same names as in TLorentzVector, and
+//              the cartesian components are computed as in ROOT 6's
+//              TLorentzVector::SetPtEtaPhiE (pz = pt*sinh(eta)), so the
+//              megajets and lepton pairs are the same as with TLorentzVector.
+//              Pt, Eta and Phi are the stored values, while TLorentzVector
+//              recomputes them from the components, so these (and DeltaR)
+//              can differ from TLorentzVector in the last bits, which may
+//              change the choice between (nearly) tied objects.
+//-----------------------------------------------------------------------------
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+class FourVector {
+public:
+  constexpr FourVector() {}
+  constexpr FourVector(const double& px, const double& py, const double& pz, const double& e,
+                       const double& pt, const double& eta, const double& phi) :
+    px_(px), py_(py), pz_(pz), e_(e), pt_(pt), eta_(eta), phi_(phi) {}
+
+  static FourVector PtEtaPhiE(double pt, const double& eta, const double& phi, const double& e)
+  {
+    pt = std::abs(pt);
+    return FourVector(pt*std::cos(phi), pt*std::sin(phi), pt*std::sinh(eta), e, pt, eta, phi);
+  }
+
+  static FourVector PxPyPzE(const double& px, const double& py, const double& pz, const double& e)
+  {
+    double pt = std::sqrt(px*px + py*py);
+    // Same conventions as TVector3 for objects along the beam
+    double eta = pt>0 ? std::asinh(pz/pt) : pz==0 ? 0 : pz>0 ? 10e10 : -10e10;
+    double phi = px==0 && py==0 ? 0 : std::atan2(py, px);
+    return FourVector(px, py, pz, e, pt, eta, phi);
+  }
+
+  constexpr double Px()  const { return px_; }
+  constexpr double Py()  const { return py_; }
+  constexpr double Pz()  const { return pz_; }
+  constexpr double E()   const { return e_; }
+  constexpr double Pt()  const { return pt_; }
+  constexpr double Eta() const { return eta_; }
+  constexpr double Phi() const { return phi_; }
+  constexpr double P2()  const { return px_*px_ + py_*py_ + pz_*pz_; }
+  constexpr double M2()  const { return e_*e_ - P2(); }
+  double P() const { return std::sqrt(P2()); }
+  double M() const { double mm = M2(); return mm < 0 ? -std::sqrt(-mm) : std::sqrt(mm); }
+
+  // Phi difference in [-pi, pi) (like TLorentzVector::DeltaPhi)
+  double DeltaPhi(const FourVector& v) const { return Phi_mpi_pi(phi_ - v.phi_); }
+  double DeltaR(const FourVector& v) const
+  {
+    double deta = eta_ - v.eta_, dphi = DeltaPhi(v);
+    return std::sqrt(deta*deta + dphi*dphi);
+  }
+
+  FourVector operator+(const FourVector& v) const { return PxPyPzE(px_+v.px_, py_+v.py_, pz_+v.pz_, e_+v.e_); }
+  FourVector& operator+=(const FourVector& v) { return *this = *this + v; }
+
+  // Same as TVector2::Phi_mpi_pi
+  static double Phi_mpi_pi(double x)
+  {
+    if (std::isnan(x)) return x;
+    while (x >= M_PI) x -= 2*M_PI;
+    while (x < -M_PI) x += 2*M_PI;
+    return x;
+  }
+
+private:
+  double px_ = 0, py_ = 0, pz_ = 0, e_ = 0;
+  double pt_ = 0, eta_ = 0, phi_ = 0;
+};
+
+static_assert(std::is_trivially_copyable<FourVector>::value, "FourVector should be copied as plain memory");
+
+// Four-vectors of the first n objects of a collection (from its Pt, Eta, Phi, E columns)
+// The memory of v is kept, so this does not allocate in the event loop
+template <class Collection>
+void fillFourVectors(std::vector<FourVector>& v, const size_t& n, const Collection& c)
+{
+  v.resize(n);
+  for (size_t i=0; i<n; ++i) v[i] = FourVector::PtEtaPhiE(c.Pt[i], c.Eta[i], c.Phi[i], c.E[i]);
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef HEMISPHERECACHE_H
+#define HEMISPHERECACHE_H
+//-----------------------------------------------------------------------------
+// File:        HemisphereCache.h
+// Description: Megajets (and MR) of the selected jets, kept until the jets
+//              change. The jets are recognized by a fingerprint of their
+//              four-vectors (and compared in full if it matches), so when a
+//              systematic variation leaves the selected jets the same
+//              (eg. MET only variations), or for the MET + lepton pair/photon
+//              variants, only the MET dependent MTR and R are recalculated.
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "FourVector.h"
+#include "Razor.h"
+
+class HemisphereCache {
+public:
+  // Megajets of the jets (empty for less than 2 jets)
+  const std::vector<TLorentzVector>& hemis(const std::vector<FourVector>& jets)
+  {
+    const uint64_t key = fingerprint(jets);
+    if ( !valid_ || key != key_ || jets.size() != jets_.size() ||
+         std::memcmp(jets.data(), jets_.data(), jets.size()*sizeof(FourVector)) ) {
+      jets_ = jets;
+      key_ = key;
+      valid_ = true;
+      ++ncalc_;
+      if (jets.size() < 2) {
+        hemis_.clear();
+        MR_ = -9999;
+      } else {
+        hemis_ = Razor::CombineJets(jets);
+        MR_ = Razor::CalcMR(hemis_[0], hemis_[1]);
+      }
+    } else ++nreuse_;
+    return hemis_;
+  }
+
+  // MR of the megajets returned by the last hemis() call
+  double MR() const { return MR_; }
+
+  size_t ncalc()  const { return ncalc_; }
+  size_t nreuse() const { return nreuse_; }
+
+  // FNV-1a style hash of the four-vector components (64 bits at a time)
+  static uint64_t fingerprint(const std::vector<FourVector>& jets)
+  {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const auto& jet : jets) {
+      const double p[4] = { jet.Px(), jet.Py(), jet.Pz(), jet.E() };
+      uint64_t bits[4];
+      std::memcpy(bits, p, sizeof(p));
+      for (size_t i=0; i<4; ++i) hash = (hash ^ bits[i]) * 1099511628211ULL;
+    }
+    return hash;
+  }
+
+private:
+  bool valid_ = false;
+  uint64_t key_ = 0;
+  std::vector<FourVector> jets_;
+  std::vector<TLorentzVector> hemis_;
+  double MR_ = -9999;
+  size_t ncalc_ = 0, nreuse_ = 0;
+};
+
+#endif
@@ -0,0 +1,276 @@
+#ifndef INPUTSTAGER_H
+#define INPUTSTAGER_H
+//-----------------------------------------------------------------------------
+// File:        InputStager.h
+// Description: Local disk staging cache of the input files of an itreestream
+//              Files are copied (TFile::Cp, so any protocol ROOT can read,
+//              eg. root://, or a plain local directory) to the staging
+//              directory by a background thread, while the previous file is
+//              being read. A file is read from the local copy if the copy is
+//              ready when the file is opened, otherwise from its original
+//              location. The directory is kept below a size limit by removing
+//              the least recently used copies (also the ones left by earlier
+//              jobs), except those being read.
+//              Copies are named <hash of the original path>_<file name>, and
+//              are written under a temporary name and renamed, so jobs can
+//              share the directory.
+//-----------------------------------------------------------------------------
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "TFile.h"
+#include "TROOT.h"
+#include "TSystem.h"
+
+class InputStager {
+public:
+  InputStager(const std::string& dir, const long long& maxsize, const int& ahead=1);
+  ~InputStager();
+
+  // Number of files staged ahead of the one being read
+  int ahead() const { return ahead_; }
+
+  // Start copying the file in the background (if it is not staged yet)
+  void prefetch(const std::string&);
+
+  // Name to open the file with: the local copy if it is ready (waits if it
+  // is being copied), otherwise the original name. The copy is in use until release
+  std::string path(const std::string&);
+
+  // The file is not read any more, its copy can be removed
+  void release(const std::string&);
+
+  // The local copy could not be read, remove it and do not stage the file again
+  void invalidate(const std::string&);
+
+private:
+  enum State { kQueued, kCopying, kStaged, kFailed };
+  struct Copy {
+    std::string local;
+    State state = kQueued;
+    long long size = 0;
+    long long lastuse = 0;
+    int inuse = 0;
+  };
+
+  std::string dir_;
+  long long maxsize_;
+  int ahead_;
+  long long used_ = 0;
+  long long clock_ = 0;
+  std::map<std::string, Copy> copies_; // by original path (or local path for copies of earlier jobs)
+  std::deque<std::string> queue_;
+  std::mutex mutex_;
+  std::condition_variable queued_;
+  std::condition_variable copied_;
+  std::thread thread_;
+  bool stopping_ = false;
+  long nstaged_ = 0, nlocal_ = 0, nremote_ = 0;
+
+  std::string local_(const std::string&) const;
+  bool reserve_(const long long&);
+  void run_();
+};
+
+//_______________________________________________________
+//     Start the copy thread, find the earlier copies
+InputStager::InputStager(const std::string& dir, const long long& maxsize, const int& ahead) :
+  dir_(dir), maxsize_(maxsize), ahead_(ahead)
+{
+  gSystem->mkdir(dir_.c_str(), kTRUE);
+  if (void* d = gSystem->OpenDirectory(dir_.c_str())) {
+    // Copies left by earlier jobs are the least recently used, oldest first
+    std::multimap<long, std::pair<std::string, long long> > earlier;
+    while (const char* name = gSystem->GetDirEntry(d)) {
+      std::string file = dir_ + "/" + name;
+      if (file.find(".root")==std::string::npos || file.find(".tmp")!=std::string::npos) continue;
+      FileStat_t stat;
+      if (gSystem->GetPathInfo(file.c_str(), stat)==0)
+        earlier.insert(std::make_pair(stat.fMtime, std::make_pair(file, stat.fSize)));
+    }
+    gSystem->FreeDirectory(d);
+    for (const auto& file : earlier) {
+      Copy& copy = copies_[file.second.first];
+      copy.local = file.second.first;
+      copy.state = kStaged;
+      copy.size = file.second.second;
+      copy.lastuse = clock_++;
+      used_ += copy.size;
+    }
+  }
+  // ROOT is used by both threads (copying and reading)
+  ROOT::EnableThreadSafety();
+  thread_ = std::thread(&InputStager::run_, this);
+}
+
+InputStager::~InputStager()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    queue_.clear();
+  }
+  queued_.notify_one();
+  thread_.join();
+  if (nlocal_+nremote_)
+    std::cout<<"InputStager - "<<nstaged_<<" files staged, "<<nlocal_<<" read from "<<dir_
+             <<", "<<nremote_<<" from the original location"<<std::endl;
+}
+
+std::string
+InputStager::local_(const std::string& remote) const
+{
+  std::stringstream ss;
+  ss<<dir_<<"/"<<std::hex<<std::hash<std::string>()(remote)<<"_"<<remote.substr(remote.rfind('/')+1);
+  return ss.str();
+}
+
+//_______________________________________________________
+//                 Used by the reader
+void
+InputStager::prefetch(const std::string& remote)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (copies_.count(remote)) return;
+  Copy& copy = copies_[remote];
+  copy.local = local_(remote);
+  auto earlier = copies_.find(copy.local);
+  if (earlier != copies_.end()) {
+    // Staged by an earlier job, used if it is still the same size
+    FileStat_t stat;
+    if (gSystem->GetPathInfo(remote.c_str(), stat)==0 && stat.fSize==earlier->second.size) {
+      copy.state = kStaged;
+      copy.size = earlier->second.size;
+      copy.lastuse = clock_++;
+      copies_.erase(earlier);
+      return;
+    }
+    used_ -= earlier->second.size;
+    std::remove(earlier->first.c_str());
+    copies_.erase(earlier);
+  }
+  queue_.push_back(remote);
+  queued_.notify_one();
+}
+
+std::string
+InputStager::path(const std::string& remote)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = copies_.find(remote);
+  if (it != copies_.end() && it->second.state==kQueued) {
+    // Not started yet, reading it remotely is faster than waiting
+    for (auto q=queue_.begin(); q!=queue_.end(); ++q) if (*q==remote) { queue_.erase(q); break; }
+    copies_.erase(it);
+    it = copies_.end();
+  }
+  if (it == copies_.end()) { ++nremote_; return remote; }
+  copied_.wait(lock, [&it] { return it->second.state!=kCopying; });
+  if (it->second.state!=kStaged) { ++nremote_; return remote; }
+  ++it->second.inuse;
+  it->second.lastuse = clock_++;
+  // The modification time orders the copies for the next jobs
+  utimes(it->second.local.c_str(), 0);
+  ++nlocal_;
+  return it->second.local;
+}
+
+void
+InputStager::release(const std::string& remote)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = copies_.find(remote);
+  if (it != copies_.end() && it->second.inuse>0) --it->second.inuse;
+}
+
+void
+InputStager::invalidate(const std::string& remote)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  Copy& copy = copies_[remote];
+  if (copy.state==kStaged) {
+    std::remove(copy.local.c_str());
+    used_ -= copy.size;
+  }
+  copy.state = kFailed;
+  copy.inuse = 0;
+}
+
+//_______________________________________________________
+//                  Copy thread
+
+// Remove least recently used copies until size fits (mutex is locked)
+bool
+InputStager::reserve_(const long long& size)
+{
+  while (used_+size > maxsize_) {
+    auto lru = copies_.end();
+    for (auto it=copies_.begin(); it!=copies_.end(); ++it)
+      if (it->second.state==kStaged && it->second.inuse==0 &&
+          (lru==copies_.end() || it->second.lastuse<lru->second.lastuse)) lru = it;
+    if (lru == copies_.end()) return false;
+    std::remove(lru->second.local.c_str());
+    used_ -= lru->second.size;
+    copies_.erase(lru); // staged again if needed
+  }
+  used_ += size;
+  return true;
+}
+
+void
+InputStager::run_()
+{
+  while (true) {
+    std::string remote, local;
+    long long size = -1;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      queued_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      if (stopping_) return;
+      remote = queue_.front();
+      queue_.pop_front();
+      FileStat_t stat;
+      if (gSystem->GetPathInfo(remote.c_str(), stat)==0) size = stat.fSize;
+      Copy& copy = copies_[remote];
+      if (size<0 || !reserve_(size)) {
+        copy.state = kFailed;
+        if (size>=0) std::cout<<"InputStager - no space left in "<<dir_<<" for "<<remote<<std::endl;
+        copied_.notify_all();
+        continue;
+      }
+      copy.state = kCopying;
+      copy.size = size;
+      local = copy.local;
+    }
+
+    std::string tmp = local + ".tmp" + std::to_string(getpid());
+    bool ok = TFile::Cp(remote.c_str(), tmp.c_str(), kFALSE) && std::rename(tmp.c_str(), local.c_str())==0;
+    if (!ok) {
+      std::cout<<"InputStager - unable to copy "<<remote<<" to "<<dir_<<std::endl;
+      std::remove(tmp.c_str());
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      Copy& copy = copies_[remote];
+      copy.state = ok ? kStaged : kFailed;
+      copy.lastuse = clock_++;
+      if (ok) ++nstaged_;
+      else used_ -= size;
+    }
+    copied_.notify_all();
+  }
+}
+
+#endif
@@ -0,0 +1,208 @@
+#ifndef LUMIMASK_H
+#define LUMIMASK_H
+//-----------------------------------------------------------------------------
+// File:        LumiMask.h
+// Description: Certified luminosity mask read from the usual CMS JSON format:
+//                {"273150": [[3, 64], [66, 75]], "273158": [[1, 1279]], ...}
+//              Runs are kept in a sorted table, each pointing to its sorted
+//              (and merged) [ls_low, ls_high] intervals. A lookup is a binary
+//              search without any allocation, and the last hit is cached,
+//              because data events mostly come ordered in run/lumisection
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utils.h"
+
+class LumiMask {
+public:
+  LumiMask() {}
+  LumiMask(const std::string& filename) { load(filename); }
+
+  void load(const std::string&);
+
+  bool contains(const unsigned int&, const unsigned int&) const;
+
+  size_t nRuns()   const { return runs_.size(); }
+  size_t nRanges() const { return ranges_.size(); }
+  bool   empty()   const { return runs_.empty(); }
+
+private:
+  typedef std::pair<unsigned int, unsigned int> Range;
+
+  // runs_[i] has the intervals ranges_[first_[i]] .. ranges_[first_[i+1]-1]
+  std::vector<unsigned int> runs_;
+  std::vector<size_t>       first_;
+  std::vector<Range>        ranges_;
+
+  // Cache of the last run found (and the interval that matched in it)
+  mutable bool         has_last_  = false;
+  mutable unsigned int last_run_  = 0;
+  mutable size_t       last_beg_  = 0;
+  mutable size_t       last_end_  = 0;
+  mutable Range        last_hit_  = Range(1,0);
+
+  // Parser
+  std::string json_;
+  size_t      pos_ = 0;
+
+  void         skip_space_();
+  void         expect_(const char&);
+  bool         accept_(const char&);
+  unsigned int read_uint_();
+  unsigned int read_run_();
+  void         parse_error_(const std::string&);
+};
+
+//_______________________________________________________
+//                  Read JSON file
+void
+LumiMask::load(const std::string& filename)
+{
+  std::ifstream file(filename.c_str());
+  if ( !file.good() ) utils::error("LumiMask - unable to open JSON file: " + filename);
+  std::stringstream buffer;
+  buffer<<file.rdbuf();
+  json_ = buffer.str();
+  pos_ = 0;
+
+  // { "run": [[low, high], ...], ... }
+  std::vector<std::pair<unsigned int, std::vector<Range> > > run_ranges;
+  expect_('{');
+  if (!accept_('}')) {
+    do {
+      run_ranges.push_back(std::make_pair(read_run_(), std::vector<Range>()));
+      expect_(':');
+      expect_('[');
+      if (!accept_(']')) {
+	do {
+	  expect_('[');
+	  unsigned int low = read_uint_();
+	  expect_(',');
+	  unsigned int high = read_uint_();
+	  expect_(']');
+	  if (low>high) parse_error_("lumisection range is decreasing");
+	  run_ranges.back().second.push_back(Range(low, high));
+	} while (accept_(','));
+	expect_(']');
+      }
+    } while (accept_(','));
+    expect_('}');
+  }
+  skip_space_();
+  if (pos_!=json_.size()) parse_error_("unexpected characters after the end");
+  json_.clear();
+  json_.shrink_to_fit();
+
+  // Sort runs (duplicate keys are merged) and then the intervals
+  // Overlapping or adjacent intervals are joined
+  std::stable_sort(run_ranges.begin(), run_ranges.end(),
+		   [](const std::pair<unsigned int, std::vector<Range> >& a,
+		      const std::pair<unsigned int, std::vector<Range> >& b) { return a.first<b.first; });
+  runs_.clear();
+  first_.clear();
+  ranges_.clear();
+  for (size_t i=0; i<run_ranges.size(); ) {
+    std::vector<Range> ranges;
+    size_t j = i;
+    for (; j<run_ranges.size() && run_ranges[j].first==run_ranges[i].first; ++j)
+      ranges.insert(ranges.end(), run_ranges[j].second.begin(), run_ranges[j].second.end());
+    std::sort(ranges.begin(), ranges.end());
+    runs_.push_back(run_ranges[i].first);
+    first_.push_back(ranges_.size());
+    for (const auto& range : ranges) {
+      if (ranges_.size()>first_.back() && range.first<=ranges_.back().second+1)
+	ranges_.back().second = std::max(ranges_.back().second, range.second);
+      else ranges_.push_back(range);
+    }
+    i = j;
+  }
+  first_.push_back(ranges_.size());
+  has_last_ = false;
+}
+
+//_______________________________________________________
+//             Check if run/lumisection is certified
+bool
+LumiMask::contains(const unsigned int& run, const unsigned int& ls) const
+{
+  if (!has_last_ || run!=last_run_) {
+    auto it = std::lower_bound(runs_.begin(), runs_.end(), run);
+    if (it==runs_.end() || *it!=run) return false;
+    size_t i = it - runs_.begin();
+    has_last_ = true;
+    last_run_ = run;
+    last_beg_ = first_[i];
+    last_end_ = first_[i+1];
+    last_hit_ = Range(1,0);
+  }
+  if (ls>=last_hit_.first && ls<=last_hit_.second) return true;
+
+  // Find the first interval that ends at or after ls
+  auto beg = ranges_.begin() + last_beg_, end = ranges_.begin() + last_end_;
+  auto it = std::lower_bound(beg, end, ls, [](const Range& r, const unsigned int& l) { return r.second<l; });
+  if (it==end || ls<it->first) return false;
+  last_hit_ = *it;
+  return true;
+}
+
+//_______________________________________________________
+//                     JSON parsing
+void
+LumiMask::skip_space_()
+{
+  while (pos_<json_.size() && std::isspace((unsigned char)json_[pos_])) ++pos_;
+}
+
+bool
+LumiMask::accept_(const char& c)
+{
+  skip_space_();
+  if (pos_<json_.size() && json_[pos_]==c) {
+    ++pos_;
+    return true;
+  }
+  return false;
+}
+
+void
+LumiMask::expect_(const char& c)
+{
+  if (!accept_(c)) parse_error_(std::string("expected '")+c+"'");
+}
+
+unsigned int
+LumiMask::read_uint_()
+{
+  skip_space_();
+  if (pos_>=json_.size() || !std::isdigit((unsigned char)json_[pos_])) parse_error_("expected a number");
+  unsigned long n = 0;
+  while (pos_<json_.size() && std::isdigit((unsigned char)json_[pos_])) {
+    n = n*10 + (json_[pos_++]-'0');
+    if (n>4294967295UL) parse_error_("number is too large");
+  }
+  return n;
+}
+
+unsigned int
+LumiMask::read_run_()
+{
+  expect_('"');
+  unsigned int run = read_uint_();
+  if (pos_>=json_.size() || json_[pos_]!='"') parse_error_("run number should be a quoted integer");
+  ++pos_;
+  return run;
+}
+
+void
+LumiMask::parse_error_(const std::string& message)
+{
+  utils::error("LumiMask - JSON parse error at character "+std::to_string(pos_)+": "+message);
+}
+
+#endif
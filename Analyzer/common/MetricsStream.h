@@ -0,0 +1,197 @@
+#ifndef METRICSSTREAM_H
+#define METRICSSTREAM_H
+//-----------------------------------------------------------------------------
+// File:        MetricsStream.h
+// Description: Live job metrics, written as JSON lines (one record per line)
+//              every N seconds during the event loop, eg:
+//                {"host": "lxplus001", "pid": 1234, "job": "output.root", "worker": 0, "entry": 120000,
+//                 "nevents": 1000000, "evt_per_s": {"10s": 410.2, ...}, ...}
+//              The target is either a file (records are appended with a
+//              single write, so parallel workers can share it) or a local
+//              UNIX datagram socket given as "unix:<path>". Socket writes
+//              never block, records are dropped if nobody is listening
+//-----------------------------------------------------------------------------
+#include <chrono>
+#include <deque>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "TFile.h"
+#include "TSystem.h"
+
+#include "utils.h"
+
+class MetricsStream {
+public:
+  MetricsStream() {}
+  ~MetricsStream() { close(); }
+
+  void open(const std::string&, const std::string&, const int&, const double& interval=10, const double& stall_threshold=5);
+
+  // Call after each event, a record is written every interval seconds
+  void update(const int& entry, const int& nevents, itreestream& stream)
+  {
+    if (fd_<0) return;
+    clock::time_point now = clock::now();
+    // The rates count from the first event (after setup or resume)
+    bool first = history_.empty();
+    if (first) history_.push_back(std::make_pair(now, entry+1));
+    double gap = std::chrono::duration<double>(now - last_event_).count();
+    last_event_ = now;
+    if (!first && gap>stall_threshold_) {
+      ++nstalls_;
+      if (gap>max_stall_) max_stall_ = gap;
+    }
+    if (entry+1==nevents || now - last_record_ >= interval_)
+      record_(entry+1, nevents, stream, now, entry+1==nevents);
+  }
+
+  void close()
+  {
+    if (fd_>=0) ::close(fd_);
+    fd_ = -1;
+  }
+
+  bool good() const { return fd_>=0; }
+
+private:
+  typedef std::chrono::steady_clock clock;
+
+  int    fd_       = -1;
+  bool   socket_   = false;
+  std::string job_;
+  int    worker_   = 0;
+  struct sockaddr_un addr_;
+  clock::duration interval_;
+  double stall_threshold_ = 5;
+
+  clock::time_point start_;
+  clock::time_point last_event_;
+  clock::time_point last_record_;
+
+  // Number of entries done at the time of previous records (for the rate windows)
+  std::deque<std::pair<clock::time_point, int> > history_;
+  int    nstalls_     = 0;
+  double max_stall_   = 0;
+  long   ndropped_    = 0;
+
+  void record_(const int&, const int&, itreestream&, const clock::time_point&, const bool&);
+  double rate_(const double&, const int&, const clock::time_point&) const;
+  static std::string escape_(const std::string&);
+};
+
+//_______________________________________________________
+//          Open file or socket and start the clock
+void
+MetricsStream::open(const std::string& target, const std::string& job, const int& worker,
+		    const double& interval, const double& stall_threshold)
+{
+  close();
+  job_ = job;
+  worker_ = worker;
+  interval_ = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(interval));
+  stall_threshold_ = stall_threshold;
+  if (target.compare(0, 5, "unix:")==0) {
+    std::string path = target.substr(5);
+    if (path.size() >= sizeof(addr_.sun_path)) utils::error("MetricsStream - socket path is too long: " + path);
+    addr_ = sockaddr_un();
+    addr_.sun_family = AF_UNIX;
+    path.copy(addr_.sun_path, path.size());
+    fd_ = socket(AF_UNIX, SOCK_DGRAM, 0);
+    socket_ = true;
+    if (fd_<0) utils::error("MetricsStream - unable to create socket for " + path);
+  } else {
+    fd_ = ::open(target.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    socket_ = false;
+    if (fd_<0) utils::error("MetricsStream - unable to open file: " + target);
+  }
+  start_ = last_event_ = last_record_ = clock::now();
+  history_.clear();
+  nstalls_ = 0;
+  max_stall_ = 0;
+  ndropped_ = 0;
+}
+
+//_______________________________________________________
+//     Event rate in the last window seconds (0: whole job)
+double
+MetricsStream::rate_(const double& window, const int& ndone, const clock::time_point& now) const
+{
+  // Oldest record that is still inside the window
+  auto first = history_.begin();
+  if (window>0)
+    while (first+1!=history_.end() && std::chrono::duration<double>(now - (first+1)->first).count() >= window) ++first;
+  double dt = std::chrono::duration<double>(now - first->first).count();
+  return dt>0 ? (ndone - first->second)/dt : 0;
+}
+
+//_______________________________________________________
+//                   Write a record
+void
+MetricsStream::record_(const int& ndone, const int& nevents, itreestream& stream,
+		       const clock::time_point& now, const bool& done)
+{
+  history_.push_back(std::make_pair(now, ndone));
+  while (history_.size()>2 && std::chrono::duration<double>(now - history_[1].first).count() >= 300)
+    history_.pop_front();
+  last_record_ = now;
+
+  double rate_10s = rate_(10, ndone, now), rate_60s = rate_(60, ndone, now), rate_300s = rate_(300, ndone, now);
+  ProcInfo_t info;
+  gSystem->GetProcInfo(&info);
+
+  std::stringstream ss;
+  ss.precision(6);
+  ss<<"{\"time\": "<<std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count()
+    <<", \"host\": \""<<escape_(gSystem->HostName())<<"\""
+    <<", \"pid\": "<<getpid()
+    <<", \"job\": \""<<escape_(job_)<<"\""
+    <<", \"worker\": "<<worker_
+    <<", \"entry\": "<<ndone
+    <<", \"nevents\": "<<nevents
+    <<", \"done\": "<<(done ? "true" : "false")
+    <<", \"runtime_s\": "<<std::chrono::duration<double>(now - start_).count()
+    <<", \"evt_per_s\": {\"10s\": "<<rate_10s<<", \"60s\": "<<rate_60s<<", \"300s\": "<<rate_300s
+    <<", \"job\": "<<rate_(0, ndone, now)<<"}"
+    <<", \"eta_s\": ";
+  if (rate_60s>0) ss<<(nevents-ndone)/rate_60s;
+  else ss<<"null";
+  ss<<", \"file\": \""<<escape_(stream.filename())<<"\""
+    <<", \"stalls\": "<<nstalls_
+    <<", \"max_stall_s\": "<<max_stall_
+    <<", \"dropped\": "<<ndropped_
+    <<", \"rss_mb\": "<<info.fMemResident/1024.
+    <<", \"bytes_read\": {\"compressed\": "<<TFile::GetFileBytesRead();
+  for (const auto& group : stream.bytesread())
+    ss<<", \""<<escape_(group.first)<<"\": "<<group.second;
+  ss<<"}}\n";
+
+  std::string line = ss.str();
+  ssize_t n = socket_ ?
+    sendto(fd_, line.data(), line.size(), MSG_DONTWAIT, (struct sockaddr*)&addr_, sizeof(addr_)) :
+    ::write(fd_, line.data(), line.size());
+  if (n != (ssize_t)line.size()) ++ndropped_;
+}
+
+//_______________________________________________________
+//                Escape a JSON string
+std::string
+MetricsStream::escape_(const std::string& str)
+{
+  std::string out;
+  for (const char& c : str) {
+    if (c=='"' || c=='\\') out += '\\';
+    if ((unsigned char)c<0x20) continue;
+    out += c;
+  }
+  return out;
+}
+
+#endif
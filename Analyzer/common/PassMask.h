@@ -0,0 +1,135 @@
+#ifndef PASSMASK_H
+#define PASSMASK_H
+//-----------------------------------------------------------------------------
+// File:        PassMask.h
+// Description: Bit mask of the objects of a collection passing a selection
+//              Used instead of std::vector<bool> (same [i], assign, size),
+//              packed in 64 bit words, so a selection on the columns of a
+//              collection (eg. pt/eta/ID cuts) can be computed 64 objects at
+//              a time without branches (select), selections are combined
+//              with &=, |= and andnot word by word, counting is a popcount and
+//              looping over the passing objects is a bit scan:
+//
+//              passLooseJet.select(data.jetsAK4.size, [&data] (size_t i) {
+//                return (data.jetsAK4.Pt[i] >= 30) & (std::abs(data.jetsAK4.Eta[i]) < 2.4); });
+//              nJet = passLooseJet.count();
+//              for (size_t i : passLooseJet) ...
+//              while (passLooseJet.Loop(data.jetsAK4.it)) ... // like data.jetsAK4.Loop()
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+class PassMask {
+public:
+  class Reference {
+  public:
+    Reference(uint64_t& word, const uint64_t& bit) : word_(word), bit_(bit) {}
+    operator bool() const { return word_ & bit_; }
+    // Returns the new value, so if (pass[i] = ...) works as with std::vector<bool>
+    bool operator=(const bool& pass) { if (pass) word_ |= bit_; else word_ &= ~bit_; return pass; }
+    bool operator=(const Reference& other) { return *this = bool(other); }
+  private:
+    uint64_t& word_;
+    uint64_t  bit_;
+  };
+
+  // Iterates over the index of the objects passing
+  class Iterator {
+  public:
+    Iterator(const PassMask& mask, const size_t& i) : mask_(mask), i_(mask.next(i)) {}
+    size_t operator*() const { return i_; }
+    Iterator& operator++() { i_ = mask_.next(i_+1); return *this; }
+    bool operator!=(const Iterator& other) const { return i_ != other.i_; }
+  private:
+    const PassMask& mask_;
+    size_t i_;
+  };
+
+  size_t size() const { return size_; }
+
+  // The memory of the words is kept, so this does not allocate in the event loop
+  void assign(const size_t& n, const bool& pass)
+  {
+    size_ = n;
+    words_.assign((n+63)/64, pass ? ~uint64_t(0) : 0);
+    if (pass && n%64) words_.back() = (uint64_t(1)<<(n%64))-1;
+  }
+
+  bool      operator[](const size_t& i) const { return (words_[i/64]>>(i%64)) & 1; }
+  Reference operator[](const size_t& i)       { return Reference(words_[i/64], uint64_t(1)<<(i%64)); }
+
+  // Set the mask from a cut on object i, evaluated for all objects
+  // (use & instead of && between the conditions, so there are no branches)
+  template <class Cut>
+  void select(const size_t& n, Cut cut)
+  {
+    assign(n, 0);
+    for (size_t w=0, i=0; i<n; ++w) {
+      uint64_t bits = 0;
+      for (size_t bit=0, nbit=std::min<size_t>(64, n-i); bit<nbit; ++bit, ++i)
+	bits |= uint64_t(bool(cut(i))) << bit;
+      words_[w] = bits;
+    }
+  }
+
+  // Combine selections of the same collection
+  PassMask& operator&=(const PassMask& other) { for (size_t w=0, n=words_.size(); w<n; ++w) words_[w] &= other.words_[w]; return *this; }
+  PassMask& operator|=(const PassMask& other) { for (size_t w=0, n=words_.size(); w<n; ++w) words_[w] |= other.words_[w]; return *this; }
+  PassMask& andnot(const PassMask& other)     { for (size_t w=0, n=words_.size(); w<n; ++w) words_[w] &= ~other.words_[w]; return *this; }
+
+  // Number of objects passing
+  size_t count() const
+  {
+    size_t n = 0;
+    for (const auto& word : words_) n += __builtin_popcountll(word);
+    return n;
+  }
+
+  bool any() const { for (const auto& word : words_) if (word) return true; return false; }
+
+  // First object passing at or after i (size() if none)
+  size_t next(size_t i) const
+  {
+    if (i>=size_) return size_;
+    size_t w = i/64;
+    uint64_t word = words_[w] & (~uint64_t(0) << (i%64));
+    while (!word) {
+      if (++w==words_.size()) return size_;
+      word = words_[w];
+    }
+    return w*64 + __builtin_ctzll(word);
+  }
+
+  Iterator begin() const { return Iterator(*this, 0); }
+  Iterator end()   const { return Iterator(*this, size_); }
+
+  // Like the Loop() of DataStruct collections, but only over the objects passing:
+  // while (passLooseJet.Loop(data.jetsAK4.it)) ...
+  bool Loop(unsigned int& it) const
+  {
+    it = next(it+1);
+    if (it<size_) return 1;
+    it = -1;
+    return 0;
+  }
+
+  // Fill the indices of the passing objects (i) and the position of each
+  // object among them (it, -1 if not passing), returns the count
+  size_t indices(std::vector<size_t>& i, std::vector<size_t>& it) const
+  {
+    i.clear();
+    it.assign(size_, (size_t)-1);
+    for (size_t j : *this) {
+      it[j] = i.size();
+      i.push_back(j);
+    }
+    return i.size();
+  }
+
+private:
+  std::vector<uint64_t> words_;
+  size_t size_ = 0;
+};
+
+#endif
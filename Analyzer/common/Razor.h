@@ -1,8 +1,17 @@
+#ifndef RAZOR_H
+#define RAZOR_H
 // Razor recipe taken from the RazorBoost gurus: N. Strobbe, S. Sekmen
 //   https://github.com/nstrobbe/RazorBoost/blob/master/analyzer/utils.h
 // also info here:
 //   https://twiki.cern.ch/twiki/bin/view/CMSPublic/RazorLikelihoodHowTo
 #include "TLorentzVector.h"
+#include "FourVector.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
 
 namespace Razor {
   
@@ -15,6 +24,7 @@ namespace Razor {
     double deltaR = sqrt(deltaphi*deltaphi + deltaeta*deltaeta);
     return deltaR;
   }
+  double fdeltaR(const FourVector& a, const FourVector& b) { return fdeltaR(a.Eta(), a.Phi(), b.Eta(), b.Phi()); }
   
   // deltaPhi:
   double fdeltaPhi(double phi1, double phi2) {
@@ -23,9 +33,10 @@ namespace Razor {
       deltaphi = TMath::TwoPi() - deltaphi;
     return deltaphi;
   }
+  double fdeltaPhi(const FourVector& a, const FourVector& b) { return fdeltaPhi(a.Phi(), b.Phi()); }
   
-  // Hemispheres:
-  std::vector<TLorentzVector> CombineJets(std::vector<TLorentzVector> myjets) {
+  // Hemispheres (all 2^N partitions summed from scratch, reference for CombineJets):
+  std::vector<TLorentzVector> CombineJetsBruteForce(const std::vector<TLorentzVector>& myjets) {
     std::vector<TLorentzVector> mynewjets;
     TLorentzVector j1, j2;
     //bool foundGood = false;
@@ -68,6 +79,119 @@ namespace Razor {
     return mynewjets;
   }
   
+  // Hemispheres (megajets) of n jets given as px, py, pz, E arrays
+  // Gives exactly the same result as CombineJetsBruteForce:
+  // - A partition and its mirror (j1 <-> j2) have the same mass sum, and the
+  //   first one in the brute-force order is the one with jet 0 in j2, so only
+  //   those are walked (half of the space)
+  // - They are walked in Gray-code order, each step adds or removes one jet
+  //   from the sum of j1 (j2 = total - j1), for 8 lanes at a time (the lanes
+  //   differ by the last 3 jets), so the M2 evaluation is vectorized
+  // - The incremental sums are rounded differently, so the partitions within
+  //   a (generous) tolerance of the minimum are summed again from scratch in
+  //   the brute-force order, and the first smallest one is chosen the same way
+  std::vector<TLorentzVector> CombineJets(const double* px, const double* py, const double* pz,
+					  const double* E, const size_t& n) {
+    // The brute-force version does not work beyond this anyway (int overflow)
+    if (n > 31) {
+      std::vector<TLorentzVector> myjets;
+      for (size_t i=0; i<n; ++i) myjets.emplace_back(px[i], py[i], pz[i], E[i]);
+      return CombineJetsBruteForce(myjets);
+    }
+    TLorentzVector j1, j2;
+    if (n >= 2) {
+      // Jets 1..nlow are walked, the next nhigh jets set the lane
+      const size_t nfree = n-1, nhigh = std::min<size_t>(3, nfree), nlow = nfree-nhigh;
+      const size_t nlane = size_t(1)<<nhigh, lanes = 8;
+      double tx = 0, ty = 0, tz = 0, te = 0, scale = 0;
+      for (size_t i=0; i<n; ++i) {
+        tx += px[i]; ty += py[i]; tz += pz[i]; te += E[i];
+        scale += std::abs(E[i]);
+      }
+      // Far above the rounding of 2^30 incremental steps
+      const double tol = 1e-6*scale*scale;
+      alignas(64) double ax[lanes] = {}, ay[lanes] = {}, az[lanes] = {}, ae[lanes] = {}, m2[lanes];
+      for (size_t l=0; l<nlane; ++l) for (size_t h=0; h<nhigh; ++h) if ((l>>h)&1) {
+        size_t i = 1+nlow+h;
+        ax[l] += px[i]; ay[l] += py[i]; az[l] += pz[i]; ae[l] += E[i];
+      }
+      // Candidates: jets in j1 (bit i = jet i), approximate mass sum
+      std::vector<std::pair<uint64_t, double> > candidates;
+      double m2_min = std::numeric_limits<double>::infinity();
+      uint64_t gray = 0;
+      for (uint64_t k=0, nstep=uint64_t(1)<<nlow; k<nstep; ++k) {
+        if (k) {
+          size_t bit = __builtin_ctzll(k);
+          gray ^= uint64_t(1)<<bit;
+          const double sign = (gray>>bit)&1 ? 1 : -1;
+          const double dx = sign*px[1+bit], dy = sign*py[1+bit], dz = sign*pz[1+bit], de = sign*E[1+bit];
+          for (size_t l=0; l<lanes; ++l) { ax[l] += dx; ay[l] += dy; az[l] += dz; ae[l] += de; }
+        }
+        for (size_t l=0; l<lanes; ++l) {
+          double bx = tx-ax[l], by = ty-ay[l], bz = tz-az[l], be = te-ae[l];
+          m2[l] = (ae[l]*ae[l] - (ax[l]*ax[l] + ay[l]*ay[l] + az[l]*az[l]))
+            +     (be*be       - (bx*bx       + by*by       + bz*bz));
+        }
+        for (size_t l=(k==0); l<nlane; ++l) if (m2[l] <= m2_min + tol) {
+          m2_min = std::min(m2_min, m2[l]);
+          candidates.emplace_back((gray<<1) | (uint64_t(l)<<(1+nlow)), m2[l]);
+        }
+        // Drop the ones left behind by a new minimum
+        if (candidates.size() > 64) {
+          candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                          [&] (const std::pair<uint64_t, double>& c) { return c.second > m2_min + tol; }),
+                           candidates.end());
+        }
+      }
+      // Brute-force order: jet 0 is the most significant bit
+      std::vector<std::pair<uint64_t, uint64_t> > order;
+      for (const auto& c : candidates) if (c.second <= m2_min + tol) {
+        uint64_t i = 0;
+        for (size_t j=0; j<n; ++j) if ((c.first>>j)&1) i |= uint64_t(1)<<(n-1-j);
+        order.emplace_back(i, c.first);
+      }
+      std::sort(order.begin(), order.end());
+      double M_min = 9999999999.0;
+      for (const auto& c : order) {
+        TLorentzVector j_temp1, j_temp2;
+        for (size_t j=0; j<n; ++j) {
+          if ((c.second>>j)&1) j_temp1 += TLorentzVector(px[j], py[j], pz[j], E[j]);
+          else                 j_temp2 += TLorentzVector(px[j], py[j], pz[j], E[j]);
+        }
+        double M_temp = j_temp1.M2()+j_temp2.M2();
+        if(M_temp < M_min){
+          M_min = M_temp;
+          j1 = j_temp1;
+          j2 = j_temp2;
+        }
+      }
+    }
+    if(j2.Pt() > j1.Pt()) std::swap(j1, j2);
+    return std::vector<TLorentzVector>{j1, j2};
+  }
+
+  std::vector<TLorentzVector> CombineJets(const std::vector<TLorentzVector>& myjets) {
+    if (myjets.size() > 31) return CombineJetsBruteForce(myjets);
+    double px[31], py[31], pz[31], E[31];
+    for (size_t i=0; i<myjets.size(); ++i) {
+      px[i] = myjets[i].Px(); py[i] = myjets[i].Py(); pz[i] = myjets[i].Pz(); E[i] = myjets[i].E();
+    }
+    return CombineJets(px, py, pz, E, myjets.size());
+  }
+
+  std::vector<TLorentzVector> CombineJets(const std::vector<FourVector>& myjets) {
+    if (myjets.size() > 31) {
+      std::vector<TLorentzVector> jets;
+      for (const auto& jet : myjets) jets.emplace_back(jet.Px(), jet.Py(), jet.Pz(), jet.E());
+      return CombineJetsBruteForce(jets);
+    }
+    double px[31], py[31], pz[31], E[31];
+    for (size_t i=0; i<myjets.size(); ++i) {
+      px[i] = myjets[i].Px(); py[i] = myjets[i].Py(); pz[i] = myjets[i].Pz(); E[i] = myjets[i].E();
+    }
+    return CombineJets(px, py, pz, E, myjets.size());
+  }
+  
   // MR
   double CalcMR(TLorentzVector ja, TLorentzVector jb){
     double A = ja.P();
@@ -99,5 +223,35 @@ namespace Razor {
   double CalcMT(TLorentzVector lepton, TLorentzVector pfmet){
     return sqrt( 2 * lepton.Pt() * pfmet.Pt() * ( 1 - cos( pfmet.Phi() - lepton.Phi() ) ) );
   }
+
+  // Same with FourVector (passed by reference, pt and phi are not recomputed)
+  double CalcMR(const FourVector& ja, const FourVector& jb){
+    double A = ja.P();
+    double B = jb.P();
+    double az = ja.Pz();
+    double bz = jb.Pz();
+    double jaT2 = ja.Px()*ja.Px() + ja.Py()*ja.Py();
+    double jbT2 = jb.Px()*jb.Px() + jb.Py()*jb.Py();
+    double ATBT = (ja.Px()+jb.Px())*(ja.Px()+jb.Px()) + (ja.Py()+jb.Py())*(ja.Py()+jb.Py());
+    double temp = sqrt((A+B)*(A+B)-(az+bz)*(az+bz)-(jbT2-jaT2)*(jbT2-jaT2)/ATBT);
+    double mybeta = (jbT2-jaT2)/sqrt(ATBT*((A+B)*(A+B)-(az+bz)*(az+bz)));
+    double mygamma = 1./sqrt(1.-mybeta*mybeta);
+    //gamma times MRstar
+    temp *= mygamma;
+    return temp;
+  }
+
+  double CalcMTR(const FourVector& ja, const FourVector& jb, const TVector3& met){
+    double temp = met.Mag()*(ja.Pt()+jb.Pt()) - (met.X()*(ja.Px()+jb.Px()) + met.Y()*(ja.Py()+jb.Py()) + met.Z()*(ja.Pz()+jb.Pz()));
+    temp /= 2.;
+    temp = sqrt(temp);
+    return temp;
+  }
+
+  double CalcMT(const FourVector& lepton, const FourVector& pfmet){
+    return sqrt( 2 * lepton.Pt() * pfmet.Pt() * ( 1 - cos( pfmet.Phi() - lepton.Phi() ) ) );
+  }
   
 }
+
+#endif
@@ -0,0 +1,353 @@
+#ifndef SAMPLEINDEX_H
+#define SAMPLEINDEX_H
+//-----------------------------------------------------------------------------
+// File:        SampleIndex.h
+// Description: Metadata of the input files of a sample, so they do not all
+//              have to be opened at the start of each job:
+//              - number of entries and cluster boundaries of the tree
+//              - cross-section (evt_XSec in the first entry)
+//              - total weight histograms (totweight and the signal scan maps)
+//                saved as their non-empty bins
+//              The index is a ROOT file next to the file list (<list>.index.root)
+//              Each file is checked against its size and modification time,
+//              and only new or changed files are read again (in parallel
+//              threads). The index is then rewritten under a temporary name
+//              and renamed, so parallel jobs always see a complete index.
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TFile.h"
+#include "TH1.h"
+#include "TNamed.h"
+#include "TROOT.h"
+#include "TSystem.h"
+#include "TTree.h"
+
+#include "utils.h"
+
+class SampleIndex {
+public:
+  SampleIndex() {}
+
+  // Index for the files (and create/update it), histos[0] is the total weight
+  // histogram, the rest are the signal total weight maps (missing ones are skipped)
+  void load(const std::string&, const std::vector<std::string>&, const std::string&,
+            const std::vector<std::string>&, int nthreads=8);
+
+  bool good() const { return !files_.empty(); }
+
+  // Entries of the files (in the same order)
+  std::vector<long long> entries(const std::vector<std::string>&) const;
+
+  // First entries of the clusters in the chain of these files, and the number of entries at the end
+  // (same as itreestream::clusters)
+  std::vector<int> clusters(const std::vector<std::string>&) const;
+
+  // Cross-section, the same as in all files
+  double xsec(const std::vector<std::string>&) const;
+
+  // Add the histos[ihisto] of all files to the histogram (same binning)
+  void add_histo(const std::vector<std::string>&, const size_t&, TH1*) const;
+
+private:
+  struct File {
+    std::string path;
+    Long64_t size = -1;
+    Long64_t mtime = -1;
+    Long64_t entries = 0;
+    float xsec = 0;
+    std::vector<Long64_t> clusters;
+    // Histograms: number of cells (-1: not in the file) and entries,
+    // and the non-empty bins: histogram, bin, content, sum of squared weights
+    std::vector<int>    hist_ncells;
+    std::vector<double> hist_entries;
+    std::vector<int>    bin_hist;
+    std::vector<int>    bin;
+    std::vector<double> bin_w;
+    std::vector<double> bin_w2;
+  };
+
+  std::string key_;
+  std::map<std::string, File> files_;
+
+  const File& file_(const std::string&) const;
+  static bool stat_(const std::string&, Long64_t&, Long64_t&);
+  static bool read_file_(File&, const std::string&, const std::vector<std::string>&);
+  void read_index_(const std::string&);
+  void write_index_(const std::string&);
+};
+
+//_______________________________________________________
+//            Load, check and update the index
+void
+SampleIndex::load(const std::string& indexfile, const std::vector<std::string>& filenames,
+                  const std::string& treename, const std::vector<std::string>& histos, int nthreads)
+{
+  key_ = "tree: " + treename;
+  for (const auto& histo : histos) key_ += "\nhisto: " + histo;
+  files_.clear();
+  read_index_(indexfile);
+
+  // Check the files (in parallel, a stat of a remote file also takes time)
+  std::vector<std::string> paths(filenames);
+  std::sort(paths.begin(), paths.end());
+  paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+  std::vector<File> checked(paths.size());
+  std::vector<char> stale(paths.size(), 0), failed(paths.size(), 0);
+  auto run_parallel = [&nthreads] (const size_t& n, std::function<void(size_t)> func) {
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> threads;
+    for (int t=0, nt=std::min<size_t>(std::max(nthreads, 1), n); t<nt; ++t)
+      threads.push_back(std::thread([&] { for (size_t i; (i = next++) < n; ) func(i); }));
+    for (auto& thread : threads) thread.join();
+  };
+  ROOT::EnableThreadSafety();
+  run_parallel(paths.size(), [&] (size_t i) {
+      File& f = checked[i];
+      auto it = files_.find(paths[i]);
+      if (it != files_.end()) f = it->second;
+      Long64_t size = -1, mtime = -1;
+      stat_(paths[i], size, mtime);
+      if (it == files_.end() || size != f.size || mtime != f.mtime) {
+        f = File();
+        f.path = paths[i];
+        f.size = size;
+        f.mtime = mtime;
+        stale[i] = 1;
+      }
+    });
+
+  // Read the new or changed files
+  size_t nstale = std::count(stale.begin(), stale.end(), 1);
+  if (nstale) {
+    std::cout<<"SampleIndex - reading "<<nstale<<" (of "<<paths.size()<<") files for "<<indexfile<<std::endl;
+    std::vector<size_t> todo;
+    for (size_t i=0; i<paths.size(); ++i) if (stale[i]) todo.push_back(i);
+    run_parallel(todo.size(), [&] (size_t j) {
+	size_t i = todo[j];
+	failed[i] = !read_file_(checked[i], treename, histos);
+      });
+    for (size_t i=0; i<paths.size(); ++i)
+      if (failed[i]) utils::error("SampleIndex - unable to read file: "+paths[i]);
+  }
+  for (auto& f : checked) files_[f.path] = f;
+  if (nstale) write_index_(indexfile);
+  else std::cout<<"SampleIndex - using "<<indexfile<<" ("<<paths.size()<<" files)"<<std::endl;
+}
+
+// Size and modification time (also for remote files, through the TSystem plugins)
+bool
+SampleIndex::stat_(const std::string& path, Long64_t& size, Long64_t& mtime)
+{
+  FileStat_t stat;
+  if (gSystem->GetPathInfo(path.c_str(), stat) != 0) return false;
+  size = stat.fSize;
+  mtime = stat.fMtime;
+  return true;
+}
+
+//_______________________________________________________
+//               Read the metadata of a file
+bool
+SampleIndex::read_file_(File& f, const std::string& treename, const std::vector<std::string>& histos)
+{
+  TFile* file = TFile::Open(f.path.c_str());
+  if (file == 0 || file->IsZombie()) return false;
+  TTree* tree = (TTree*)file->Get(treename.c_str());
+  if (tree == 0) { file->Close(); delete file; return false; }
+  f.entries = tree->GetEntries();
+  TTree::TClusterIterator cluster = tree->GetClusterIterator(0);
+  Long64_t start;
+  while ((start = cluster()) < f.entries) f.clusters.push_back(start);
+  TBranch* b_xsec = tree->GetBranch("evt_XSec");
+  if (b_xsec && f.entries) {
+    b_xsec->SetAddress(&f.xsec);
+    b_xsec->GetEntry(0);
+    b_xsec->ResetAddress();
+  }
+  for (size_t ih=0; ih<histos.size(); ++ih) {
+    TH1* h = (TH1*)file->Get(histos[ih].c_str());
+    f.hist_ncells.push_back(h ? h->GetNcells() : -1);
+    f.hist_entries.push_back(h ? h->GetEntries() : 0);
+    if (h == 0) continue;
+    for (int bin=0, n=h->GetNcells(); bin<n; ++bin) {
+      double w = h->GetBinContent(bin);
+      double w2 = h->GetSumw2N() ? h->GetSumw2()->At(bin) : w;
+      if (w==0 && w2==0) continue;
+      f.bin_hist.push_back(ih);
+      f.bin.push_back(bin);
+      f.bin_w.push_back(w);
+      f.bin_w2.push_back(w2);
+    }
+  }
+  file->Close();
+  delete file;
+  return true;
+}
+
+//_______________________________________________________
+//                  Index file I/O
+void
+SampleIndex::read_index_(const std::string& indexfile)
+{
+  if (gSystem->AccessPathName(indexfile.c_str())) return;
+  TFile* file = TFile::Open(indexfile.c_str());
+  if (file == 0 || file->IsZombie()) return;
+  TNamed* key = (TNamed*)file->Get("key");
+  TTree* tree = (TTree*)file->Get("files");
+  if (key == 0 || tree == 0 || key_ != key->GetTitle()) {
+    std::cout<<"SampleIndex - "<<indexfile<<" was made with different settings, remaking it"<<std::endl;
+    file->Close();
+    delete file;
+    return;
+  }
+  File f, *pf = &f;
+  std::string* path = 0;
+  std::vector<Long64_t>* clusters = 0;
+  std::vector<int> *hist_ncells = 0, *bin_hist = 0, *bin = 0;
+  std::vector<double> *hist_entries = 0, *bin_w = 0, *bin_w2 = 0;
+  tree->SetBranchAddress("path",         &path);
+  tree->SetBranchAddress("size",         &pf->size);
+  tree->SetBranchAddress("mtime",        &pf->mtime);
+  tree->SetBranchAddress("entries",      &pf->entries);
+  tree->SetBranchAddress("xsec",         &pf->xsec);
+  tree->SetBranchAddress("clusters",     &clusters);
+  tree->SetBranchAddress("hist_ncells",  &hist_ncells);
+  tree->SetBranchAddress("hist_entries", &hist_entries);
+  tree->SetBranchAddress("bin_hist",     &bin_hist);
+  tree->SetBranchAddress("bin",          &bin);
+  tree->SetBranchAddress("bin_w",        &bin_w);
+  tree->SetBranchAddress("bin_w2",       &bin_w2);
+  for (Long64_t i=0, n=tree->GetEntries(); i<n; ++i) {
+    tree->GetEntry(i);
+    f.path         = *path;
+    f.clusters     = *clusters;
+    f.hist_ncells  = *hist_ncells;
+    f.hist_entries = *hist_entries;
+    f.bin_hist     = *bin_hist;
+    f.bin          = *bin;
+    f.bin_w        = *bin_w;
+    f.bin_w2       = *bin_w2;
+    files_[f.path] = f;
+  }
+  tree->ResetBranchAddresses();
+  file->Close();
+  delete file;
+}
+
+void
+SampleIndex::write_index_(const std::string& indexfile)
+{
+  std::string tmpfile = indexfile + ".tmp" + std::to_string(gSystem->GetPid()) + ".root";
+  TDirectory* dir = gDirectory;
+  TFile* file = TFile::Open(tmpfile.c_str(), "RECREATE");
+  if (file == 0 || file->IsZombie()) {
+    std::cout<<"** Warning ** SampleIndex - unable to write "<<tmpfile<<", the index is not saved"<<std::endl;
+    dir->cd();
+    return;
+  }
+  TNamed key("key", key_.c_str());
+  key.Write();
+  TTree* tree = new TTree("files", "Metadata of the input files");
+  File f;
+  tree->Branch("path",         &f.path);
+  tree->Branch("size",         &f.size,    "size/L");
+  tree->Branch("mtime",        &f.mtime,   "mtime/L");
+  tree->Branch("entries",      &f.entries, "entries/L");
+  tree->Branch("xsec",         &f.xsec,    "xsec/F");
+  tree->Branch("clusters",     &f.clusters);
+  tree->Branch("hist_ncells",  &f.hist_ncells);
+  tree->Branch("hist_entries", &f.hist_entries);
+  tree->Branch("bin_hist",     &f.bin_hist);
+  tree->Branch("bin",          &f.bin);
+  tree->Branch("bin_w",        &f.bin_w);
+  tree->Branch("bin_w2",       &f.bin_w2);
+  for (const auto& file : files_) {
+    f = file.second;
+    tree->Fill();
+  }
+  tree->Write();
+  file->Close();
+  delete file;
+  dir->cd();
+  if (std::rename(tmpfile.c_str(), indexfile.c_str())) {
+    std::cout<<"** Warning ** SampleIndex - unable to rename "<<tmpfile<<", the index is not saved"<<std::endl;
+    std::remove(tmpfile.c_str());
+  } else std::cout<<"SampleIndex - index saved to "<<indexfile<<std::endl;
+}
+
+//_______________________________________________________
+//                      Queries
+const SampleIndex::File&
+SampleIndex::file_(const std::string& path) const
+{
+  auto it = files_.find(path);
+  if (it == files_.end()) utils::error("SampleIndex - file is not in the index: "+path);
+  return it->second;
+}
+
+std::vector<long long>
+SampleIndex::entries(const std::vector<std::string>& filenames) const
+{
+  std::vector<long long> n;
+  for (const auto& filename : filenames) n.push_back(file_(filename).entries);
+  return n;
+}
+
+std::vector<int>
+SampleIndex::clusters(const std::vector<std::string>& filenames) const
+{
+  std::vector<int> starts;
+  Long64_t offset = 0;
+  for (const auto& filename : filenames) {
+    const File& f = file_(filename);
+    for (const auto& start : f.clusters) starts.push_back(offset + start);
+    offset += f.entries;
+  }
+  starts.push_back(offset);
+  return starts;
+}
+
+double
+SampleIndex::xsec(const std::vector<std::string>& filenames) const
+{
+  float evt_XSec=0, prev_XSec=0;
+  for (const auto& filename : filenames) {
+    // Empty files have no cross-section (GetEntry(0) did not change it)
+    const File& f = file_(filename);
+    if (f.entries == 0) continue;
+    evt_XSec = f.xsec;
+    if (prev_XSec!=0&&prev_XSec!=evt_XSec)
+      utils::error("AnalysisBase - Files added with different cross-sections. Please, add them separately!");
+    prev_XSec = evt_XSec;
+  }
+  return evt_XSec;
+}
+
+void
+SampleIndex::add_histo(const std::vector<std::string>& filenames, const size_t& ihisto, TH1* h) const
+{
+  if (h->GetSumw2N()==0) h->Sumw2();
+  double entries = h->GetEntries();
+  for (const auto& filename : filenames) {
+    const File& f = file_(filename);
+    if (ihisto>=f.hist_ncells.size() || f.hist_ncells[ihisto]<0) continue;
+    if (f.hist_ncells[ihisto]!=h->GetNcells())
+      utils::error(std::string("SampleIndex - histogram ")+h->GetName()+" has a different binning than in file "+filename);
+    for (size_t i=0, n=f.bin.size(); i<n; ++i) if (f.bin_hist[i]==(int)ihisto) {
+      h->SetBinContent(f.bin[i], h->GetBinContent(f.bin[i]) + f.bin_w[i]);
+      (*h->GetSumw2())[f.bin[i]] += f.bin_w2[i];
+    }
+    entries += f.hist_entries[ihisto];
+  }
+  h->SetEntries(entries);
+}
+
+#endif
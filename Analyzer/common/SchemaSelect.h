@@ -0,0 +1,58 @@
+#ifndef SCHEMASELECT_H
+#define SCHEMASELECT_H
+//-----------------------------------------------------------------------------
+// File:        SchemaSelect.h
+// Description: Select the variables of DataStruct from the schema
+//              (DATASTRUCT_SCHEMA, see Schema_May10.h) instead of a
+//              selectVariables header
+//              Only the branches of the members used by the compiled
+//              analysis (usedBranches.h, made by make) are read, or all of
+//              them for skimming. Branches missing from the input (eg. older
+//              ntuple versions) are not read, their variables keep the
+//              default value (-9999), so the same executable runs on all
+//              ntuple versions that DataStruct covers.
+//-----------------------------------------------------------------------------
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#if __has_include("usedBranches.h")
+#include "usedBranches.h"
+#endif
+
+// all: select all variables (for skimming)
+// extra: branches to read even if not used by the analysis (eg. preselection)
+void
+selectSchema(itreestream& stream, DataStruct& data, const bool& all,
+	     const std::vector<std::string>& extra = std::vector<std::string>())
+{
+#ifdef USED_DATASTRUCT_MEMBERS
+  const std::set<std::string> used = { USED_DATASTRUCT_MEMBERS };
+  const bool select_all = all;
+#else
+  // Not made by make, read everything
+  const std::set<std::string> used;
+  const bool select_all = true;
+#endif
+  const std::set<std::string> extras(extra.begin(), extra.end());
+
+  size_t nselected = 0, nunused = 0;
+  std::vector<std::string> missing;
+#define SELECT_SCHEMA_FIELD(branch, member)				\
+  if ( select_all || used.count(#member) || extras.count(branch) ) {		\
+    if ( stream.present(branch) ) { stream.select(branch, data.member); ++nselected; } \
+    else missing.push_back(branch);					\
+  } else ++nunused;
+  DATASTRUCT_SCHEMA(SELECT_SCHEMA_FIELD)
+#undef SELECT_SCHEMA_FIELD
+
+  std::cout<<"selectSchema - "<<nselected<<" branches selected, "<<nunused<<" not used by the analysis"<<std::endl;
+  if ( missing.size() ) {
+    std::cout<<"selectSchema - "<<missing.size()<<" branches are not in the input, their variables are not set:";
+    for (const auto& branch : missing) std::cout<<" "<<branch;
+    std::cout<<std::endl;
+  }
+}
+
+#endif
@@ -0,0 +1,612 @@
+#ifndef SCHEMA_H
+#define SCHEMA_H
+//-----------------------------------------------------------------------------
+// File:        Schema_May10.h
+// Description: Branch name and DataStruct member of all variables of
+//              DataStruct_May10.h (made with scripts/make_schema.py from
+//              common/selectVariables_skim_May10_photon.h)
+//              Usage: #define F(branch, member) ...
+//                     DATASTRUCT_SCHEMA(F)
+//-----------------------------------------------------------------------------
+
+#define DATASTRUCT_SCHEMA(F) \
+  F("evt_RunNumber", evt.RunNumber) \
+  F("evt_LumiBlock", evt.LumiBlock) \
+  F("evt_EventNumber", evt.EventNumber) \
+  F("evt_NGoodVtx", evt.NGoodVtx) \
+  F("evt_LHA_PDF_ID", evt.LHA_PDF_ID) \
+  F("evt_NIsoTrk", evt.NIsoTrk) \
+  F("evt_MR", evt.MR) \
+  F("evt_MTR", evt.MTR) \
+  F("evt_R", evt.R) \
+  F("evt_R2", evt.R2) \
+  F("evt_MR_Smear", evt.MR_Smear) \
+  F("evt_MTR_Smear", evt.MTR_Smear) \
+  F("evt_XSec", evt.XSec) \
+  F("evt_Gen_Weight", evt.Gen_Weight) \
+  F("evt_Gen_Ht", evt.Gen_Ht) \
+  F("SUSY_Stop_Mass", evt.SUSY_Stop_Mass) \
+  F("SUSY_Gluino_Mass", evt.SUSY_Gluino_Mass) \
+  F("SUSY_LSP_Mass", evt.SUSY_LSP_Mass) \
+  F("met_MuCleanOnly_size", met.MuCleanOnly_size) \
+  F("met_MuCleanOnly_Pt", met.MuCleanOnly_Pt) \
+  F("met_MuCleanOnly_Phi", met.MuCleanOnly_Phi) \
+  F("met_size", met.size) \
+  F("met_Pt", met.Pt) \
+  F("met_Phi", met.Phi) \
+  F("puppimet_size", puppimet.size) \
+  F("puppimet_Pt", puppimet.Pt) \
+  F("puppimet_Phi", puppimet.Phi) \
+  F("pu_NtrueInt", pu.NtrueInt) \
+  F("scale_size", syst_scale.size) \
+  F("scale_Weights", syst_scale.Weights) \
+  F("pdf_size", syst_pdf.size) \
+  F("pdf_Weights", syst_pdf.Weights) \
+  F("alphas_size", syst_alphas.size) \
+  F("alphas_Weights", syst_alphas.Weights) \
+  F("metsyst_size", syst_met.size) \
+  F("metsyst_MuCleanOnly_Pt", syst_met.MuCleanOnly_Pt) \
+  F("metsyst_MuCleanOnly_Phi", syst_met.MuCleanOnly_Phi) \
+  F("metsyst_Pt", syst_met.Pt) \
+  F("metsyst_Phi", syst_met.Phi) \
+  F("puppimetsyst_size", syst_puppimet.size) \
+  F("puppimetsyst_Pt", syst_puppimet.Pt) \
+  F("puppimetsyst_Phi", syst_puppimet.Phi) \
+  F("Flag_BadPFMuonFilter", filter.BadPFMuonFilter) \
+  F("Flag_BadChargedCandidateFilter", filter.BadChargedCandidateFilter) \
+  F("Flag_HBHENoiseFilter", filter.HBHENoiseFilter) \
+  F("Flag_HBHENoiseIsoFilter", filter.HBHENoiseIsoFilter) \
+  F("Flag_CSCTightHaloFilter", filter.CSCTightHaloFilter) \
+  F("Flag_CSCTightHaloTrkMuUnvetoFilter", filter.CSCTightHaloTrkMuUnvetoFilter) \
+  F("Flag_CSCTightHalo2015Filter", filter.CSCTightHalo2015Filter) \
+  F("Flag_globalTightHalo2016Filter", filter.globalTightHalo2016Filter) \
+  F("Flag_globalSuperTightHalo2016Filter", filter.globalSuperTightHalo2016Filter) \
+  F("Flag_HcalStripHaloFilter", filter.HcalStripHaloFilter) \
+  F("Flag_hcalLaserEventFilter", filter.hcalLaserEventFilter) \
+  F("Flag_EcalDeadCellTriggerPrimitiveFilter", filter.EcalDeadCellTriggerPrimitiveFilter) \
+  F("Flag_EcalDeadCellBoundaryEnergyFilter", filter.EcalDeadCellBoundaryEnergyFilter) \
+  F("Flag_goodVertices", filter.goodVertices) \
+  F("Flag_eeBadScFilter", filter.eeBadScFilter) \
+  F("Flag_ecalLaserCorrFilter", filter.ecalLaserCorrFilter) \
+  F("Flag_trkPOGFilters", filter.trkPOGFilters) \
+  F("Flag_chargedHadronTrackResolutionFilter", filter.chargedHadronTrackResolutionFilter) \
+  F("Flag_muonBadTrackFilter", filter.muonBadTrackFilter) \
+  F("Flag_trkPOG_manystripclus53X", filter.trkPOG_manystripclus53X) \
+  F("Flag_trkPOG_toomanystripclus53X", filter.trkPOG_toomanystripclus53X) \
+  F("Flag_trkPOG_logErrorTooManyClusters", filter.trkPOG_logErrorTooManyClusters) \
+  F("Flag_METFilters", filter.METFilters) \
+  F("Flag_badMuons", filter.badMuons) \
+  F("Flag_duplicateMuons", filter.duplicateMuons) \
+  F("Flag_noBadMuons", filter.noBadMuons) \
+  F("HLT_PFJet40", hlt.PFJet40) \
+  F("HLT_PFJet40_prescale", hlt.PFJet40_prescale) \
+  F("HLT_PFJet60", hlt.PFJet60) \
+  F("HLT_PFJet60_prescale", hlt.PFJet60_prescale) \
+  F("HLT_PFJet80", hlt.PFJet80) \
+  F("HLT_PFJet80_prescale", hlt.PFJet80_prescale) \
+  F("HLT_PFJet140", hlt.PFJet140) \
+  F("HLT_PFJet140_prescale", hlt.PFJet140_prescale) \
+  F("HLT_PFJet200", hlt.PFJet200) \
+  F("HLT_PFJet200_prescale", hlt.PFJet200_prescale) \
+  F("HLT_PFJet260", hlt.PFJet260) \
+  F("HLT_PFJet260_prescale", hlt.PFJet260_prescale) \
+  F("HLT_PFJet320", hlt.PFJet320) \
+  F("HLT_PFJet320_prescale", hlt.PFJet320_prescale) \
+  F("HLT_PFJet400", hlt.PFJet400) \
+  F("HLT_PFJet400_prescale", hlt.PFJet400_prescale) \
+  F("HLT_PFJet450", hlt.PFJet450) \
+  F("HLT_PFJet450_prescale", hlt.PFJet450_prescale) \
+  F("HLT_PFJet500", hlt.PFJet500) \
+  F("HLT_PFJet500_prescale", hlt.PFJet500_prescale) \
+  F("HLT_AK8PFJet40", hlt.AK8PFJet40) \
+  F("HLT_AK8PFJet40_prescale", hlt.AK8PFJet40_prescale) \
+  F("HLT_AK8PFJet60", hlt.AK8PFJet60) \
+  F("HLT_AK8PFJet60_prescale", hlt.AK8PFJet60_prescale) \
+  F("HLT_AK8PFJet80", hlt.AK8PFJet80) \
+  F("HLT_AK8PFJet80_prescale", hlt.AK8PFJet80_prescale) \
+  F("HLT_AK8PFJet140", hlt.AK8PFJet140) \
+  F("HLT_AK8PFJet140_prescale", hlt.AK8PFJet140_prescale) \
+  F("HLT_AK8PFJet200", hlt.AK8PFJet200) \
+  F("HLT_AK8PFJet200_prescale", hlt.AK8PFJet200_prescale) \
+  F("HLT_AK8PFJet260", hlt.AK8PFJet260) \
+  F("HLT_AK8PFJet260_prescale", hlt.AK8PFJet260_prescale) \
+  F("HLT_AK8PFJet320", hlt.AK8PFJet320) \
+  F("HLT_AK8PFJet320_prescale", hlt.AK8PFJet320_prescale) \
+  F("HLT_AK8PFJet360_TrimMass30", hlt.AK8PFJet360_TrimMass30) \
+  F("HLT_AK8PFJet360_TrimMass30_prescale", hlt.AK8PFJet360_TrimMass30_prescale) \
+  F("HLT_AK8PFJet400_TrimMass30", hlt.AK8PFJet400_TrimMass30) \
+  F("HLT_AK8PFJet400_TrimMass30_prescale", hlt.AK8PFJet400_TrimMass30_prescale) \
+  F("HLT_AK8PFJet400", hlt.AK8PFJet400) \
+  F("HLT_AK8PFJet400_prescale", hlt.AK8PFJet400_prescale) \
+  F("HLT_AK8PFJet450", hlt.AK8PFJet450) \
+  F("HLT_AK8PFJet450_prescale", hlt.AK8PFJet450_prescale) \
+  F("HLT_AK8PFJet500", hlt.AK8PFJet500) \
+  F("HLT_AK8PFJet500_prescale", hlt.AK8PFJet500_prescale) \
+  F("HLT_PFHT125", hlt.PFHT125) \
+  F("HLT_PFHT125_prescale", hlt.PFHT125_prescale) \
+  F("HLT_PFHT200", hlt.PFHT200) \
+  F("HLT_PFHT200_prescale", hlt.PFHT200_prescale) \
+  F("HLT_PFHT250", hlt.PFHT250) \
+  F("HLT_PFHT250_prescale", hlt.PFHT250_prescale) \
+  F("HLT_PFHT300", hlt.PFHT300) \
+  F("HLT_PFHT300_prescale", hlt.PFHT300_prescale) \
+  F("HLT_PFHT350", hlt.PFHT350) \
+  F("HLT_PFHT350_prescale", hlt.PFHT350_prescale) \
+  F("HLT_PFHT400", hlt.PFHT400) \
+  F("HLT_PFHT400_prescale", hlt.PFHT400_prescale) \
+  F("HLT_PFHT475", hlt.PFHT475) \
+  F("HLT_PFHT475_prescale", hlt.PFHT475_prescale) \
+  F("HLT_PFHT600", hlt.PFHT600) \
+  F("HLT_PFHT600_prescale", hlt.PFHT600_prescale) \
+  F("HLT_PFHT650", hlt.PFHT650) \
+  F("HLT_PFHT650_prescale", hlt.PFHT650_prescale) \
+  F("HLT_PFHT800", hlt.PFHT800) \
+  F("HLT_PFHT800_prescale", hlt.PFHT800_prescale) \
+  F("HLT_PFHT900", hlt.PFHT900) \
+  F("HLT_PFHT900_prescale", hlt.PFHT900_prescale) \
+  F("HLT_AK8PFHT650_TrimR0p1PT0p03Mass50", hlt.AK8PFHT650_TrimR0p1PT0p03Mass50) \
+  F("HLT_AK8PFHT650_TrimR0p1PT0p03Mass50_prescale", hlt.AK8PFHT650_TrimR0p1PT0p03Mass50_prescale) \
+  F("HLT_AK8PFHT700_TrimR0p1PT0p03Mass50", hlt.AK8PFHT700_TrimR0p1PT0p03Mass50) \
+  F("HLT_AK8PFHT700_TrimR0p1PT0p03Mass50_prescale", hlt.AK8PFHT700_TrimR0p1PT0p03Mass50_prescale) \
+  F("HLT_AK8PFHT750_TrimMass50", hlt.AK8PFHT750_TrimMass50) \
+  F("HLT_AK8PFHT750_TrimMass50_prescale", hlt.AK8PFHT750_TrimMass50_prescale) \
+  F("HLT_AK8PFHT800_TrimMass50", hlt.AK8PFHT800_TrimMass50) \
+  F("HLT_AK8PFHT800_TrimMass50_prescale", hlt.AK8PFHT800_TrimMass50_prescale) \
+  F("HLT_PFHT550_4JetPt50", hlt.PFHT550_4JetPt50) \
+  F("HLT_PFHT550_4JetPt50_prescale", hlt.PFHT550_4JetPt50_prescale) \
+  F("HLT_PFHT650_4JetPt50", hlt.PFHT650_4JetPt50) \
+  F("HLT_PFHT650_4JetPt50_prescale", hlt.PFHT650_4JetPt50_prescale) \
+  F("HLT_PFHT750_4JetPt50", hlt.PFHT750_4JetPt50) \
+  F("HLT_PFHT750_4JetPt50_prescale", hlt.PFHT750_4JetPt50_prescale) \
+  F("HLT_PFHT750_4JetPt70", hlt.PFHT750_4JetPt70) \
+  F("HLT_PFHT750_4JetPt70_prescale", hlt.PFHT750_4JetPt70_prescale) \
+  F("HLT_PFHT750_4JetPt80", hlt.PFHT750_4JetPt80) \
+  F("HLT_PFHT750_4JetPt80_prescale", hlt.PFHT750_4JetPt80_prescale) \
+  F("HLT_PFHT800_4JetPt50", hlt.PFHT800_4JetPt50) \
+  F("HLT_PFHT800_4JetPt50_prescale", hlt.PFHT800_4JetPt50_prescale) \
+  F("HLT_PFHT850_4JetPt50", hlt.PFHT850_4JetPt50) \
+  F("HLT_PFHT850_4JetPt50_prescale", hlt.PFHT850_4JetPt50_prescale) \
+  F("HLT_AK8DiPFJet250_200_TrimMass30", hlt.AK8DiPFJet250_200_TrimMass30) \
+  F("HLT_AK8DiPFJet250_200_TrimMass30_prescale", hlt.AK8DiPFJet250_200_TrimMass30_prescale) \
+  F("HLT_AK8DiPFJet280_200_TrimMass30", hlt.AK8DiPFJet280_200_TrimMass30) \
+  F("HLT_AK8DiPFJet280_200_TrimMass30_prescale", hlt.AK8DiPFJet280_200_TrimMass30_prescale) \
+  F("HLT_AK8DiPFJet300_200_TrimMass30", hlt.AK8DiPFJet300_200_TrimMass30) \
+  F("HLT_AK8DiPFJet300_200_TrimMass30_prescale", hlt.AK8DiPFJet300_200_TrimMass30_prescale) \
+  F("HLT_MET100", hlt.MET100) \
+  F("HLT_MET100_prescale", hlt.MET100_prescale) \
+  F("HLT_MET150", hlt.MET150) \
+  F("HLT_MET150_prescale", hlt.MET150_prescale) \
+  F("HLT_MET200", hlt.MET200) \
+  F("HLT_MET200_prescale", hlt.MET200_prescale) \
+  F("HLT_MET250", hlt.MET250) \
+  F("HLT_MET250_prescale", hlt.MET250_prescale) \
+  F("HLT_MET300", hlt.MET300) \
+  F("HLT_MET300_prescale", hlt.MET300_prescale) \
+  F("HLT_MET600", hlt.MET600) \
+  F("HLT_MET600_prescale", hlt.MET600_prescale) \
+  F("HLT_MET700", hlt.MET700) \
+  F("HLT_MET700_prescale", hlt.MET700_prescale) \
+  F("HLT_PFMET170_BeamHaloCleaned", hlt.PFMET170_BeamHaloCleaned) \
+  F("HLT_PFMET170_BeamHaloCleaned_prescale", hlt.PFMET170_BeamHaloCleaned_prescale) \
+  F("HLT_PFMET170_HBHECleaned", hlt.PFMET170_HBHECleaned) \
+  F("HLT_PFMET170_HBHECleaned_prescale", hlt.PFMET170_HBHECleaned_prescale) \
+  F("HLT_PFMET170_HBHE_BeamHaloCleaned", hlt.PFMET170_HBHE_BeamHaloCleaned) \
+  F("HLT_PFMET170_HBHE_BeamHaloCleaned_prescale", hlt.PFMET170_HBHE_BeamHaloCleaned_prescale) \
+  F("HLT_PFMET170_JetIdCleaned", hlt.PFMET170_JetIdCleaned) \
+  F("HLT_PFMET170_JetIdCleaned_prescale", hlt.PFMET170_JetIdCleaned_prescale) \
+  F("HLT_PFMET170_NoiseCleaned", hlt.PFMET170_NoiseCleaned) \
+  F("HLT_PFMET170_NoiseCleaned_prescale", hlt.PFMET170_NoiseCleaned_prescale) \
+  F("HLT_PFMET170_NotCleaned", hlt.PFMET170_NotCleaned) \
+  F("HLT_PFMET170_NotCleaned_prescale", hlt.PFMET170_NotCleaned_prescale) \
+  F("HLT_PFMETTypeOne190_HBHE_BeamHaloCleaned", hlt.PFMETTypeOne190_HBHE_BeamHaloCleaned) \
+  F("HLT_PFMETTypeOne190_HBHE_BeamHaloCleaned_prescale", hlt.PFMETTypeOne190_HBHE_BeamHaloCleaned_prescale) \
+  F("HLT_PFMET300", hlt.PFMET300) \
+  F("HLT_PFMET300_prescale", hlt.PFMET300_prescale) \
+  F("HLT_PFMET400", hlt.PFMET400) \
+  F("HLT_PFMET400_prescale", hlt.PFMET400_prescale) \
+  F("HLT_PFMET500", hlt.PFMET500) \
+  F("HLT_PFMET500_prescale", hlt.PFMET500_prescale) \
+  F("HLT_PFMET600", hlt.PFMET600) \
+  F("HLT_PFMET600_prescale", hlt.PFMET600_prescale) \
+  F("HLT_CaloMHTNoPU90_PFMET90_PFMHT90_IDTight_BTagCSV_p067", hlt.CaloMHTNoPU90_PFMET90_PFMHT90_IDTight_BTagCSV_p067) \
+  F("HLT_CaloMHTNoPU90_PFMET90_PFMHT90_IDTight_BTagCSV_p067_prescale", hlt.CaloMHTNoPU90_PFMET90_PFMHT90_IDTight_BTagCSV_p067_prescale) \
+  F("HLT_CaloMHTNoPU90_PFMET90_PFMHT90_IDTight", hlt.CaloMHTNoPU90_PFMET90_PFMHT90_IDTight) \
+  F("HLT_CaloMHTNoPU90_PFMET90_PFMHT90_IDTight_prescale", hlt.CaloMHTNoPU90_PFMET90_PFMHT90_IDTight_prescale) \
+  F("HLT_PFMET100_PFMHT100_IDTight_BeamHaloCleaned", hlt.PFMET100_PFMHT100_IDTight_BeamHaloCleaned) \
+  F("HLT_PFMET100_PFMHT100_IDTight_BeamHaloCleaned_prescale", hlt.PFMET100_PFMHT100_IDTight_BeamHaloCleaned_prescale) \
+  F("HLT_PFMET100_PFMHT100_IDTight", hlt.PFMET100_PFMHT100_IDTight) \
+  F("HLT_PFMET100_PFMHT100_IDTight_prescale", hlt.PFMET100_PFMHT100_IDTight_prescale) \
+  F("HLT_PFMET110_PFMHT110_IDTight", hlt.PFMET110_PFMHT110_IDTight) \
+  F("HLT_PFMET110_PFMHT110_IDTight_prescale", hlt.PFMET110_PFMHT110_IDTight_prescale) \
+  F("HLT_PFMET120_PFMHT120_IDTight", hlt.PFMET120_PFMHT120_IDTight) \
+  F("HLT_PFMET120_PFMHT120_IDTight_prescale", hlt.PFMET120_PFMHT120_IDTight_prescale) \
+  F("HLT_PFMET90_PFMHT90_IDTight", hlt.PFMET90_PFMHT90_IDTight) \
+  F("HLT_PFMET90_PFMHT90_IDTight_prescale", hlt.PFMET90_PFMHT90_IDTight_prescale) \
+  F("HLT_PFMETNoMu100_PFMHTNoMu100_IDTight", hlt.PFMETNoMu100_PFMHTNoMu100_IDTight) \
+  F("HLT_PFMETNoMu100_PFMHTNoMu100_IDTight_prescale", hlt.PFMETNoMu100_PFMHTNoMu100_IDTight_prescale) \
+  F("HLT_PFMETNoMu110_PFMHTNoMu110_IDTight", hlt.PFMETNoMu110_PFMHTNoMu110_IDTight) \
+  F("HLT_PFMETNoMu110_PFMHTNoMu110_IDTight_prescale", hlt.PFMETNoMu110_PFMHTNoMu110_IDTight_prescale) \
+  F("HLT_PFMETNoMu120_PFMHTNoMu120_IDTight", hlt.PFMETNoMu120_PFMHTNoMu120_IDTight) \
+  F("HLT_PFMETNoMu120_PFMHTNoMu120_IDTight_prescale", hlt.PFMETNoMu120_PFMHTNoMu120_IDTight_prescale) \
+  F("HLT_PFMETNoMu90_PFMHTNoMu90_IDTight", hlt.PFMETNoMu90_PFMHTNoMu90_IDTight) \
+  F("HLT_PFMETNoMu90_PFMHTNoMu90_IDTight_prescale", hlt.PFMETNoMu90_PFMHTNoMu90_IDTight_prescale) \
+  F("HLT_Mu17", hlt.Mu17) \
+  F("HLT_Mu17_prescale", hlt.Mu17_prescale) \
+  F("HLT_Mu20", hlt.Mu20) \
+  F("HLT_Mu20_prescale", hlt.Mu20_prescale) \
+  F("HLT_Mu27", hlt.Mu27) \
+  F("HLT_Mu27_prescale", hlt.Mu27_prescale) \
+  F("HLT_Mu50", hlt.Mu50) \
+  F("HLT_Mu50_prescale", hlt.Mu50_prescale) \
+  F("HLT_Mu55", hlt.Mu55) \
+  F("HLT_Mu55_prescale", hlt.Mu55_prescale) \
+  F("HLT_TkMu17", hlt.TkMu17) \
+  F("HLT_TkMu17_prescale", hlt.TkMu17_prescale) \
+  F("HLT_TkMu20", hlt.TkMu20) \
+  F("HLT_TkMu20_prescale", hlt.TkMu20_prescale) \
+  F("HLT_TkMu27", hlt.TkMu27) \
+  F("HLT_TkMu27_prescale", hlt.TkMu27_prescale) \
+  F("HLT_TkMu50", hlt.TkMu50) \
+  F("HLT_TkMu50_prescale", hlt.TkMu50_prescale) \
+  F("HLT_IsoMu18", hlt.IsoMu18) \
+  F("HLT_IsoMu18_prescale", hlt.IsoMu18_prescale) \
+  F("HLT_IsoMu20", hlt.IsoMu20) \
+  F("HLT_IsoMu20_prescale", hlt.IsoMu20_prescale) \
+  F("HLT_IsoMu22", hlt.IsoMu22) \
+  F("HLT_IsoMu22_prescale", hlt.IsoMu22_prescale) \
+  F("HLT_IsoMu24", hlt.IsoMu24) \
+  F("HLT_IsoMu24_prescale", hlt.IsoMu24_prescale) \
+  F("HLT_IsoMu27", hlt.IsoMu27) \
+  F("HLT_IsoMu27_prescale", hlt.IsoMu27_prescale) \
+  F("HLT_IsoTkMu18", hlt.IsoTkMu18) \
+  F("HLT_IsoTkMu18_prescale", hlt.IsoTkMu18_prescale) \
+  F("HLT_IsoTkMu20", hlt.IsoTkMu20) \
+  F("HLT_IsoTkMu20_prescale", hlt.IsoTkMu20_prescale) \
+  F("HLT_IsoTkMu22", hlt.IsoTkMu22) \
+  F("HLT_IsoTkMu22_prescale", hlt.IsoTkMu22_prescale) \
+  F("HLT_IsoTkMu24", hlt.IsoTkMu24) \
+  F("HLT_IsoTkMu24_prescale", hlt.IsoTkMu24_prescale) \
+  F("HLT_IsoTkMu27", hlt.IsoTkMu27) \
+  F("HLT_IsoTkMu27_prescale", hlt.IsoTkMu27_prescale) \
+  F("HLT_Ele17_CaloIdL_GsfTrkIdVL", hlt.Ele17_CaloIdL_GsfTrkIdVL) \
+  F("HLT_Ele17_CaloIdL_GsfTrkIdVL_prescale", hlt.Ele17_CaloIdL_GsfTrkIdVL_prescale) \
+  F("HLT_Ele22_eta2p1_WPLoose_Gsf", hlt.Ele22_eta2p1_WPLoose_Gsf) \
+  F("HLT_Ele22_eta2p1_WPLoose_Gsf_prescale", hlt.Ele22_eta2p1_WPLoose_Gsf_prescale) \
+  F("HLT_Ele23_WPLoose_Gsf", hlt.Ele23_WPLoose_Gsf) \
+  F("HLT_Ele23_WPLoose_Gsf_prescale", hlt.Ele23_WPLoose_Gsf_prescale) \
+  F("HLT_Ele24_eta2p1_WPLoose_Gsf", hlt.Ele24_eta2p1_WPLoose_Gsf) \
+  F("HLT_Ele24_eta2p1_WPLoose_Gsf_prescale", hlt.Ele24_eta2p1_WPLoose_Gsf_prescale) \
+  F("HLT_Ele25_WPTight_Gsf", hlt.Ele25_WPTight_Gsf) \
+  F("HLT_Ele25_WPTight_Gsf_prescale", hlt.Ele25_WPTight_Gsf_prescale) \
+  F("HLT_Ele25_eta2p1_WPLoose_Gsf", hlt.Ele25_eta2p1_WPLoose_Gsf) \
+  F("HLT_Ele25_eta2p1_WPLoose_Gsf_prescale", hlt.Ele25_eta2p1_WPLoose_Gsf_prescale) \
+  F("HLT_Ele25_eta2p1_WPTight_Gsf", hlt.Ele25_eta2p1_WPTight_Gsf) \
+  F("HLT_Ele25_eta2p1_WPTight_Gsf_prescale", hlt.Ele25_eta2p1_WPTight_Gsf_prescale) \
+  F("HLT_Ele27_WPLoose_Gsf", hlt.Ele27_WPLoose_Gsf) \
+  F("HLT_Ele27_WPLoose_Gsf_prescale", hlt.Ele27_WPLoose_Gsf_prescale) \
+  F("HLT_Ele27_WPTight_Gsf", hlt.Ele27_WPTight_Gsf) \
+  F("HLT_Ele27_WPTight_Gsf_prescale", hlt.Ele27_WPTight_Gsf_prescale) \
+  F("HLT_Ele27_eta2p1_WPLoose_Gsf", hlt.Ele27_eta2p1_WPLoose_Gsf) \
+  F("HLT_Ele27_eta2p1_WPLoose_Gsf_prescale", hlt.Ele27_eta2p1_WPLoose_Gsf_prescale) \
+  F("HLT_Ele27_eta2p1_WPTight_Gsf", hlt.Ele27_eta2p1_WPTight_Gsf) \
+  F("HLT_Ele27_eta2p1_WPTight_Gsf_prescale", hlt.Ele27_eta2p1_WPTight_Gsf_prescale) \
+  F("HLT_Ele30_WPTight_Gsf", hlt.Ele30_WPTight_Gsf) \
+  F("HLT_Ele30_WPTight_Gsf_prescale", hlt.Ele30_WPTight_Gsf_prescale) \
+  F("HLT_Ele30_eta2p1_WPLoose_Gsf", hlt.Ele30_eta2p1_WPLoose_Gsf) \
+  F("HLT_Ele30_eta2p1_WPLoose_Gsf_prescale", hlt.Ele30_eta2p1_WPLoose_Gsf_prescale) \
+  F("HLT_Ele30_eta2p1_WPTight_Gsf", hlt.Ele30_eta2p1_WPTight_Gsf) \
+  F("HLT_Ele30_eta2p1_WPTight_Gsf_prescale", hlt.Ele30_eta2p1_WPTight_Gsf_prescale) \
+  F("HLT_Ele32_WPTight_Gsf", hlt.Ele32_WPTight_Gsf) \
+  F("HLT_Ele32_WPTight_Gsf_prescale", hlt.Ele32_WPTight_Gsf_prescale) \
+  F("HLT_Ele32_eta2p1_WPLoose_Gsf", hlt.Ele32_eta2p1_WPLoose_Gsf) \
+  F("HLT_Ele32_eta2p1_WPLoose_Gsf_prescale", hlt.Ele32_eta2p1_WPLoose_Gsf_prescale) \
+  F("HLT_Ele32_eta2p1_WPTight_Gsf", hlt.Ele32_eta2p1_WPTight_Gsf) \
+  F("HLT_Ele32_eta2p1_WPTight_Gsf_prescale", hlt.Ele32_eta2p1_WPTight_Gsf_prescale) \
+  F("HLT_Ele35_WPLoose_Gsf", hlt.Ele35_WPLoose_Gsf) \
+  F("HLT_Ele35_WPLoose_Gsf_prescale", hlt.Ele35_WPLoose_Gsf_prescale) \
+  F("HLT_Ele45_WPLoose_Gsf", hlt.Ele45_WPLoose_Gsf) \
+  F("HLT_Ele45_WPLoose_Gsf_prescale", hlt.Ele45_WPLoose_Gsf_prescale) \
+  F("HLT_Ele105_CaloIdVT_GsfTrkIdT", hlt.Ele105_CaloIdVT_GsfTrkIdT) \
+  F("HLT_Ele105_CaloIdVT_GsfTrkIdT_prescale", hlt.Ele105_CaloIdVT_GsfTrkIdT_prescale) \
+  F("HLT_Ele115_CaloIdVT_GsfTrkIdT", hlt.Ele115_CaloIdVT_GsfTrkIdT) \
+  F("HLT_Ele115_CaloIdVT_GsfTrkIdT_prescale", hlt.Ele115_CaloIdVT_GsfTrkIdT_prescale) \
+  F("HLT_Ele145_CaloIdVT_GsfTrkIdT", hlt.Ele145_CaloIdVT_GsfTrkIdT) \
+  F("HLT_Ele145_CaloIdVT_GsfTrkIdT_prescale", hlt.Ele145_CaloIdVT_GsfTrkIdT_prescale) \
+  F("HLT_Ele200_CaloIdVT_GsfTrkIdT", hlt.Ele200_CaloIdVT_GsfTrkIdT) \
+  F("HLT_Ele200_CaloIdVT_GsfTrkIdT_prescale", hlt.Ele200_CaloIdVT_GsfTrkIdT_prescale) \
+  F("HLT_Ele250_CaloIdVT_GsfTrkIdT", hlt.Ele250_CaloIdVT_GsfTrkIdT) \
+  F("HLT_Ele250_CaloIdVT_GsfTrkIdT_prescale", hlt.Ele250_CaloIdVT_GsfTrkIdT_prescale) \
+  F("HLT_Ele300_CaloIdVT_GsfTrkIdT", hlt.Ele300_CaloIdVT_GsfTrkIdT) \
+  F("HLT_Ele300_CaloIdVT_GsfTrkIdT_prescale", hlt.Ele300_CaloIdVT_GsfTrkIdT_prescale) \
+  F("HLT_Mu30_eta2p1_PFJet150_PFJet50", hlt.Mu30_eta2p1_PFJet150_PFJet50) \
+  F("HLT_Mu30_eta2p1_PFJet150_PFJet50_prescale", hlt.Mu30_eta2p1_PFJet150_PFJet50_prescale) \
+  F("HLT_Mu40_eta2p1_PFJet200_PFJet50", hlt.Mu40_eta2p1_PFJet200_PFJet50) \
+  F("HLT_Mu40_eta2p1_PFJet200_PFJet50_prescale", hlt.Mu40_eta2p1_PFJet200_PFJet50_prescale) \
+  F("HLT_Ele35_CaloIdVT_GsfTrkIdT_PFJet150_PFJet50", hlt.Ele35_CaloIdVT_GsfTrkIdT_PFJet150_PFJet50) \
+  F("HLT_Ele35_CaloIdVT_GsfTrkIdT_PFJet150_PFJet50_prescale", hlt.Ele35_CaloIdVT_GsfTrkIdT_PFJet150_PFJet50_prescale) \
+  F("HLT_Ele45_CaloIdVT_GsfTrkIdT_PFJet200_PFJet50", hlt.Ele45_CaloIdVT_GsfTrkIdT_PFJet200_PFJet50) \
+  F("HLT_Ele45_CaloIdVT_GsfTrkIdT_PFJet200_PFJet50_prescale", hlt.Ele45_CaloIdVT_GsfTrkIdT_PFJet200_PFJet50_prescale) \
+  F("gen_size", gen.size) \
+  F("gen_ID", gen.ID) \
+  F("gen_Status", gen.Status) \
+  F("gen_Mom0ID", gen.Mom0ID) \
+  F("gen_Mom0Status", gen.Mom0Status) \
+  F("gen_Mom1ID", gen.Mom1ID) \
+  F("gen_Mom1Status", gen.Mom1Status) \
+  F("gen_Dau0ID", gen.Dau0ID) \
+  F("gen_Dau0Status", gen.Dau0Status) \
+  F("gen_Dau1ID", gen.Dau1ID) \
+  F("gen_Dau1Status", gen.Dau1Status) \
+  F("gen_Pt", gen.Pt) \
+  F("gen_Eta", gen.Eta) \
+  F("gen_Phi", gen.Phi) \
+  F("gen_E", gen.E) \
+  F("gen_Mass", gen.Mass) \
+  F("gen_Charge", gen.Charge) \
+  F("pho_size", pho.size) \
+  F("pho_Pt", pho.Pt) \
+  F("pho_Eta", pho.Eta) \
+  F("pho_Phi", pho.Phi) \
+  F("pho_E", pho.E) \
+  F("pho_Charge", pho.Charge) \
+  F("pho_SCEta", pho.SCEta) \
+  F("pho_SCPhi", pho.SCPhi) \
+  F("pho_SCRawE", pho.SCRawE) \
+  F("pho_HasPixelSeed", pho.HasPixelSeed) \
+  F("pho_ElectronVeto", pho.ElectronVeto) \
+  F("pho_SigmaIEtaIEta", pho.SigmaIEtaIEta) \
+  F("pho_SigmaIEtaIPhi", pho.SigmaIEtaIPhi) \
+  F("pho_SigmaIPhiIPhi", pho.SigmaIPhiIPhi) \
+  F("pho_E1x5", pho.E1x5) \
+  F("pho_E5x5", pho.E5x5) \
+  F("pho_HoverE", pho.HoverE) \
+  F("pho_R9", pho.R9) \
+  F("pho_ChargedHadronIso", pho.ChargedHadronIso) \
+  F("pho_PhotonIso", pho.PhotonIso) \
+  F("pho_NeutralHadronIso", pho.NeutralHadronIso) \
+  F("pho_PhotonIsoEAcorrectedsp15", pho.PhotonIsoEAcorrectedsp15) \
+  F("pho_NeutralHadronIsoEAcorrectedsp15", pho.NeutralHadronIsoEAcorrectedsp15) \
+  F("pho_PassLooseID", pho.PassLooseID) \
+  F("pho_PassMediumID", pho.PassMediumID) \
+  F("pho_PassTightID", pho.PassTightID) \
+  F("pho_isPromptDirect", pho.isPromptDirect) \
+  F("pho_isPromptFrag", pho.isPromptFrag) \
+  F("pho_isFake", pho.isFake) \
+  F("el_size", ele.size) \
+  F("el_Pt", ele.Pt) \
+  F("el_Eta", ele.Eta) \
+  F("el_Phi", ele.Phi) \
+  F("el_E", ele.E) \
+  F("el_Charge", ele.Charge) \
+  F("el_Key", ele.Key) \
+  F("el_Iso03", ele.Iso03) \
+  F("el_Iso03db", ele.Iso03db) \
+  F("el_MiniIso", ele.MiniIso) \
+  F("el_Dxy", ele.Dxy) \
+  F("el_Dz", ele.Dz) \
+  F("el_DB", ele.DB) \
+  F("el_DBerr", ele.DBerr) \
+  F("el_SCEta", ele.SCEta) \
+  F("el_vidVeto", ele.vidVeto) \
+  F("el_vidLoose", ele.vidLoose) \
+  F("el_vidMedium", ele.vidMedium) \
+  F("el_vidTight", ele.vidTight) \
+  F("el_vidHEEP", ele.vidHEEP) \
+  F("el_vidVetonoiso", ele.vidVetonoiso) \
+  F("el_vidLoosenoiso", ele.vidLoosenoiso) \
+  F("el_vidMediumnoiso", ele.vidMediumnoiso) \
+  F("el_vidTightnoiso", ele.vidTightnoiso) \
+  F("el_vidHEEPnoiso", ele.vidHEEPnoiso) \
+  F("el_vidMvaGPvalue", ele.vidMvaGPvalue) \
+  F("el_vidMvaGPcateg", ele.vidMvaGPcateg) \
+  F("el_vidMvaHZZvalue", ele.vidMvaHZZvalue) \
+  F("el_vidMvaHZZcateg", ele.vidMvaHZZcateg) \
+  F("el_IsPartOfNearAK4Jet", ele.IsPartOfNearAK4Jet) \
+  F("el_IsPartOfNearAK8Jet", ele.IsPartOfNearAK8Jet) \
+  F("el_IsPartOfNearSubjet", ele.IsPartOfNearSubjet) \
+  F("el_DRNearGenEleFromSLTop", ele.DRNearGenEleFromSLTop) \
+  F("el_PtNearGenEleFromSLTop", ele.PtNearGenEleFromSLTop) \
+  F("el_PtNearGenTop", ele.PtNearGenTop) \
+  F("el_LepAK4JetFrac", ele.LepAK4JetFrac) \
+  F("el_LepAK8JetFrac", ele.LepAK8JetFrac) \
+  F("el_LepSubjetFrac", ele.LepSubjetFrac) \
+  F("el_LepAK4JetMassDrop", ele.LepAK4JetMassDrop) \
+  F("el_LepAK8JetMassDrop", ele.LepAK8JetMassDrop) \
+  F("el_LepSubjetMassDrop", ele.LepSubjetMassDrop) \
+  F("el_AK4JetV1DR", ele.AK4JetV1DR) \
+  F("el_AK4JetV2DR", ele.AK4JetV2DR) \
+  F("el_AK4JetV3DR", ele.AK4JetV3DR) \
+  F("el_AK8JetV1DR", ele.AK8JetV1DR) \
+  F("el_AK8JetV2DR", ele.AK8JetV2DR) \
+  F("el_AK8JetV3DR", ele.AK8JetV3DR) \
+  F("el_SubjetV1DR", ele.SubjetV1DR) \
+  F("el_SubjetV2DR", ele.SubjetV2DR) \
+  F("el_SubjetV3DR", ele.SubjetV3DR) \
+  F("el_AK4JetV1PtRel", ele.AK4JetV1PtRel) \
+  F("el_AK4JetV2PtRel", ele.AK4JetV2PtRel) \
+  F("el_AK4JetV3PtRel", ele.AK4JetV3PtRel) \
+  F("el_AK8JetV1PtRel", ele.AK8JetV1PtRel) \
+  F("el_AK8JetV2PtRel", ele.AK8JetV2PtRel) \
+  F("el_AK8JetV3PtRel", ele.AK8JetV3PtRel) \
+  F("el_SubjetV1PtRel", ele.SubjetV1PtRel) \
+  F("el_SubjetV2PtRel", ele.SubjetV2PtRel) \
+  F("el_SubjetV3PtRel", ele.SubjetV3PtRel) \
+  F("mu_size", mu.size) \
+  F("mu_Pt", mu.Pt) \
+  F("mu_Eta", mu.Eta) \
+  F("mu_Phi", mu.Phi) \
+  F("mu_E", mu.E) \
+  F("mu_Charge", mu.Charge) \
+  F("mu_Key", mu.Key) \
+  F("mu_Iso04", mu.Iso04) \
+  F("mu_MiniIso", mu.MiniIso) \
+  F("mu_Dxy", mu.Dxy) \
+  F("mu_Dz", mu.Dz) \
+  F("mu_DB", mu.DB) \
+  F("mu_DBerr", mu.DBerr) \
+  F("mu_IsSoftMuon", mu.IsSoftMuon) \
+  F("mu_IsLooseMuon", mu.IsLooseMuon) \
+  F("mu_IsMediumMuon", mu.IsMediumMuon) \
+  F("mu_IsMediumMuon2016", mu.IsMediumMuon2016) \
+  F("mu_IsTightMuon", mu.IsTightMuon) \
+  F("mu_IsHighPtMuon", mu.IsHighPtMuon) \
+  F("mu_IsPartOfNearAK4Jet", mu.IsPartOfNearAK4Jet) \
+  F("mu_IsPartOfNearAK8Jet", mu.IsPartOfNearAK8Jet) \
+  F("mu_IsPartOfNearSubjet", mu.IsPartOfNearSubjet) \
+  F("mu_DRNearGenMuFromSLTop", mu.DRNearGenMuFromSLTop) \
+  F("mu_PtNearGenMuFromSLTop", mu.PtNearGenMuFromSLTop) \
+  F("mu_PtNearGenTop", mu.PtNearGenTop) \
+  F("mu_LepAK4JetFrac", mu.LepAK4JetFrac) \
+  F("mu_LepAK8JetFrac", mu.LepAK8JetFrac) \
+  F("mu_LepSubjetFrac", mu.LepSubjetFrac) \
+  F("mu_LepAK4JetMassDrop", mu.LepAK4JetMassDrop) \
+  F("mu_LepAK8JetMassDrop", mu.LepAK8JetMassDrop) \
+  F("mu_LepSubjetMassDrop", mu.LepSubjetMassDrop) \
+  F("mu_AK4JetV1DR", mu.AK4JetV1DR) \
+  F("mu_AK4JetV2DR", mu.AK4JetV2DR) \
+  F("mu_AK4JetV3DR", mu.AK4JetV3DR) \
+  F("mu_AK8JetV1DR", mu.AK8JetV1DR) \
+  F("mu_AK8JetV2DR", mu.AK8JetV2DR) \
+  F("mu_AK8JetV3DR", mu.AK8JetV3DR) \
+  F("mu_SubjetV1DR", mu.SubjetV1DR) \
+  F("mu_SubjetV2DR", mu.SubjetV2DR) \
+  F("mu_SubjetV3DR", mu.SubjetV3DR) \
+  F("mu_AK4JetV1PtRel", mu.AK4JetV1PtRel) \
+  F("mu_AK4JetV2PtRel", mu.AK4JetV2PtRel) \
+  F("mu_AK4JetV3PtRel", mu.AK4JetV3PtRel) \
+  F("mu_AK8JetV1PtRel", mu.AK8JetV1PtRel) \
+  F("mu_AK8JetV2PtRel", mu.AK8JetV2PtRel) \
+  F("mu_AK8JetV3PtRel", mu.AK8JetV3PtRel) \
+  F("mu_SubjetV1PtRel", mu.SubjetV1PtRel) \
+  F("mu_SubjetV2PtRel", mu.SubjetV2PtRel) \
+  F("mu_SubjetV3PtRel", mu.SubjetV3PtRel) \
+  F("jetAK4CHS_size", jetsAK4.size) \
+  F("jetAK4CHS_Pt", jetsAK4.Pt) \
+  F("jetAK4CHS_Eta", jetsAK4.Eta) \
+  F("jetAK4CHS_Phi", jetsAK4.Phi) \
+  F("jetAK4CHS_E", jetsAK4.E) \
+  F("jetAK4CHS_Charge", jetsAK4.Charge) \
+  F("jetAK4CHS_CSVv2", jetsAK4.CSVv2) \
+  F("jetAK4CHS_CMVAv2", jetsAK4.CMVAv2) \
+  F("jetAK4CHS_CvsL", jetsAK4.CvsL) \
+  F("jetAK4CHS_CvsB", jetsAK4.CvsB) \
+  F("jetAK4CHS_GenPartonEta", jetsAK4.GenPartonEta) \
+  F("jetAK4CHS_GenPartonPhi", jetsAK4.GenPartonPhi) \
+  F("jetAK4CHS_GenPartonPt", jetsAK4.GenPartonPt) \
+  F("jetAK4CHS_GenPartonE", jetsAK4.GenPartonE) \
+  F("jetAK4CHS_GenPartonCharge", jetsAK4.GenPartonCharge) \
+  F("jetAK4CHS_PartonFlavour", jetsAK4.PartonFlavour) \
+  F("jetAK4CHS_HadronFlavour", jetsAK4.HadronFlavour) \
+  F("jetAK4CHS_GenJetEta", jetsAK4.GenJetEta) \
+  F("jetAK4CHS_GenJetPhi", jetsAK4.GenJetPhi) \
+  F("jetAK4CHS_GenJetPt", jetsAK4.GenJetPt) \
+  F("jetAK4CHS_GenJetE", jetsAK4.GenJetE) \
+  F("jetAK4CHS_GenJetCharge", jetsAK4.GenJetCharge) \
+  F("jetAK4CHS_jecFactor0", jetsAK4.jecFactor0) \
+  F("jetAK4CHS_jecUncertainty", jetsAK4.jecUncertainty) \
+  F("jetAK4CHS_JERSF", jetsAK4.JERSF) \
+  F("jetAK4CHS_JERSFUp", jetsAK4.JERSFUp) \
+  F("jetAK4CHS_JERSFDown", jetsAK4.JERSFDown) \
+  F("jetAK4CHS_SmearedPt", jetsAK4.SmearedPt) \
+  F("jetAK4CHS_looseJetID", jetsAK4.looseJetID) \
+  F("jetAK4CHS_tightJetID", jetsAK4.tightJetID) \
+  F("jetAK4CHS_tightLepVetoJetID", jetsAK4.tightLepVetoJetID) \
+  F("jetAK8CHS_size", jetsAK8.size) \
+  F("jetAK8CHS_Pt", jetsAK8.Pt) \
+  F("jetAK8CHS_Eta", jetsAK8.Eta) \
+  F("jetAK8CHS_Phi", jetsAK8.Phi) \
+  F("jetAK8CHS_E", jetsAK8.E) \
+  F("jetAK8CHS_Charge", jetsAK8.Charge) \
+  F("jetAK8CHS_CSVv2", jetsAK8.CSVv2) \
+  F("jetAK8CHS_CMVAv2", jetsAK8.CMVAv2) \
+  F("jetAK8CHS_CvsL", jetsAK8.CvsL) \
+  F("jetAK8CHS_CvsB", jetsAK8.CvsB) \
+  F("jetAK8CHS_GenPartonEta", jetsAK8.GenPartonEta) \
+  F("jetAK8CHS_GenPartonPhi", jetsAK8.GenPartonPhi) \
+  F("jetAK8CHS_GenPartonPt", jetsAK8.GenPartonPt) \
+  F("jetAK8CHS_GenPartonE", jetsAK8.GenPartonE) \
+  F("jetAK8CHS_GenPartonCharge", jetsAK8.GenPartonCharge) \
+  F("jetAK8CHS_PartonFlavour", jetsAK8.PartonFlavour) \
+  F("jetAK8CHS_HadronFlavour", jetsAK8.HadronFlavour) \
+  F("jetAK8CHS_GenJetEta", jetsAK8.GenJetEta) \
+  F("jetAK8CHS_GenJetPhi", jetsAK8.GenJetPhi) \
+  F("jetAK8CHS_GenJetPt", jetsAK8.GenJetPt) \
+  F("jetAK8CHS_GenJetE", jetsAK8.GenJetE) \
+  F("jetAK8CHS_GenJetCharge", jetsAK8.GenJetCharge) \
+  F("jetAK8CHS_jecFactor0", jetsAK8.jecFactor0) \
+  F("jetAK8CHS_jecUncertainty", jetsAK8.jecUncertainty) \
+  F("jetAK8CHS_JERSF", jetsAK8.JERSF) \
+  F("jetAK8CHS_JERSFUp", jetsAK8.JERSFUp) \
+  F("jetAK8CHS_JERSFDown", jetsAK8.JERSFDown) \
+  F("jetAK8CHS_SmearedPt", jetsAK8.SmearedPt) \
+  F("jetAK8CHS_vSubjetIndex0", jetsAK8.vSubjetIndex0) \
+  F("jetAK8CHS_vSubjetIndex1", jetsAK8.vSubjetIndex1) \
+  F("jetAK8CHS_tau1CHS", jetsAK8.tau1CHS) \
+  F("jetAK8CHS_tau2CHS", jetsAK8.tau2CHS) \
+  F("jetAK8CHS_tau3CHS", jetsAK8.tau3CHS) \
+  F("jetAK8CHS_softDropMassCHS", jetsAK8.softDropMassCHS) \
+  F("jetAK8CHS_softDropMassPuppi", jetsAK8.softDropMassPuppi) \
+  F("jetAK8CHS_PtPuppi", jetsAK8.PtPuppi) \
+  F("jetAK8CHS_EtaPuppi", jetsAK8.EtaPuppi) \
+  F("jetAK8CHS_PhiPuppi", jetsAK8.PhiPuppi) \
+  F("jetAK8CHS_MassPuppi", jetsAK8.MassPuppi) \
+  F("jetAK8CHS_tau1Puppi", jetsAK8.tau1Puppi) \
+  F("jetAK8CHS_tau2Puppi", jetsAK8.tau2Puppi) \
+  F("jetAK8CHS_tau3Puppi", jetsAK8.tau3Puppi) \
+  F("jetAK8CHS_uncorrSDMassPuppi", jetsAK8.uncorrSDMassPuppi) \
+  F("jetAK8CHS_corrSDMassPuppi", jetsAK8.corrSDMassPuppi) \
+  F("jetAK8CHS_HasNearGenTop", jetsAK8.HasNearGenTop) \
+  F("jetAK8CHS_NearGenTopIsHadronic", jetsAK8.NearGenTopIsHadronic) \
+  F("jetAK8CHS_NearGenWIsHadronic", jetsAK8.NearGenWIsHadronic) \
+  F("jetAK8CHS_NearGenWToENu", jetsAK8.NearGenWToENu) \
+  F("jetAK8CHS_NearGenWToMuNu", jetsAK8.NearGenWToMuNu) \
+  F("jetAK8CHS_NearGenWToTauNu", jetsAK8.NearGenWToTauNu) \
+  F("jetAK8CHS_looseJetID", jetsAK8.looseJetID) \
+  F("jetAK8CHS_tightJetID", jetsAK8.tightJetID) \
+  F("jetAK8CHS_tightLepVetoJetID", jetsAK8.tightLepVetoJetID) \
+  F("jetAK8CHS_maxSubjetCSVv2", jetsAK8.maxSubjetCSVv2) \
+  F("jetAK8CHS_maxSubjetCMVAv2", jetsAK8.maxSubjetCMVAv2) \
+  F("jetAK8CHS_DRNearGenTop", jetsAK8.DRNearGenTop) \
+  F("jetAK8CHS_DRNearGenWFromTop", jetsAK8.DRNearGenWFromTop) \
+  F("jetAK8CHS_DRNearGenBFromTop", jetsAK8.DRNearGenBFromTop) \
+  F("jetAK8CHS_DRNearGenLepFromSLTop", jetsAK8.DRNearGenLepFromSLTop) \
+  F("jetAK8CHS_DRNearGenNuFromSLTop", jetsAK8.DRNearGenNuFromSLTop) \
+  F("jetAK8CHS_PtNearGenTop", jetsAK8.PtNearGenTop) \
+  F("jetAK8CHS_PtNearGenBFromTop", jetsAK8.PtNearGenBFromTop) \
+  F("jetAK8CHS_PtNearGenWFromTop", jetsAK8.PtNearGenWFromTop) \
+  F("jetAK8CHS_PtNearGenLepFromSLTop", jetsAK8.PtNearGenLepFromSLTop) \
+  F("jetAK8CHS_PtNearGenNuFromSLTop", jetsAK8.PtNearGenNuFromSLTop) \
+  F("subjetAK8CHS_size", subjetsAK8.size) \
+  F("subjetAK8CHS_Pt", subjetsAK8.Pt) \
+  F("subjetAK8CHS_Eta", subjetsAK8.Eta) \
+  F("subjetAK8CHS_Phi", subjetsAK8.Phi) \
+  F("subjetAK8CHS_E", subjetsAK8.E) \
+  F("subjetAK8CHS_Charge", subjetsAK8.Charge) \
+  F("subjetAK8CHS_CSVv2", subjetsAK8.CSVv2) \
+  F("subjetAK8CHS_CMVAv2", subjetsAK8.CMVAv2) \
+  F("subjetAK8CHS_CvsL", subjetsAK8.CvsL) \
+  F("subjetAK8CHS_CvsB", subjetsAK8.CvsB) \
+  F("subjetAK8CHS_GenPartonEta", subjetsAK8.GenPartonEta) \
+  F("subjetAK8CHS_GenPartonPhi", subjetsAK8.GenPartonPhi) \
+  F("subjetAK8CHS_GenPartonPt", subjetsAK8.GenPartonPt) \
+  F("subjetAK8CHS_GenPartonE", subjetsAK8.GenPartonE) \
+  F("subjetAK8CHS_GenPartonCharge", subjetsAK8.GenPartonCharge) \
+  F("subjetAK8CHS_PartonFlavour", subjetsAK8.PartonFlavour) \
+  F("subjetAK8CHS_HadronFlavour", subjetsAK8.HadronFlavour) \
+  F("subjetAK8CHS_GenJetEta", subjetsAK8.GenJetEta) \
+  F("subjetAK8CHS_GenJetPhi", subjetsAK8.GenJetPhi) \
+  F("subjetAK8CHS_GenJetPt", subjetsAK8.GenJetPt) \
+  F("subjetAK8CHS_GenJetE", subjetsAK8.GenJetE) \
+  F("subjetAK8CHS_GenJetCharge", subjetsAK8.GenJetCharge) \
+  F("subjetAK8CHS_jecFactor0", subjetsAK8.jecFactor0) \
+  F("subjetAK8CHS_looseJetID", subjetsAK8.looseJetID) \
+  F("subjetAK8CHS_tightJetID", subjetsAK8.tightJetID) \
+  F("subjetAK8CHS_tightLepVetoJetID", subjetsAK8.tightLepVetoJetID) \
+  F("genjetAK8SD_size", genjetsAK8.size) \
+  F("genjetAK8SD_Pt", genjetsAK8.Pt) \
+  F("genjetAK8SD_Eta", genjetsAK8.Eta) \
+  F("genjetAK8SD_Phi", genjetsAK8.Phi) \
+  F("genjetAK8SD_E", genjetsAK8.E) \
+  F("genjetAK8SD_Charge", genjetsAK8.Charge) \
+
+#endif
@@ -0,0 +1,235 @@
+#ifndef SKIMWRITER_H
+#define SKIMWRITER_H
+//-----------------------------------------------------------------------------
+// File:        SkimWriter.h
+// Description: Writes skimmed trees in a separate thread, so filling the
+//              baskets, compression and auto saves do not stop the event loop
+//              For each event, push() copies the values of all branches of the
+//              added trees (from their current addresses, as TTree::Fill would)
+//              to a free slot of a bounded queue. The writer thread fills the
+//              output trees (empty clones) from the slots, in the same order.
+//              The event loop only waits if all slots are taken.
+//              Only branches with leaf lists (TBranch) are supported.
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "TBranch.h"
+#include "TLeaf.h"
+#include "TROOT.h"
+#include "TTree.h"
+
+class SkimWriter {
+public:
+  SkimWriter(const size_t& queue_size, const int& savecount) :
+    slots_(queue_size), savecount_(savecount) {}
+  ~SkimWriter() { stop(); }
+
+  // True if all branches of the tree can be copied by the writer
+  static bool supported(TTree*);
+
+  // Make the output tree (an empty clone in the same directory) that is
+  // written by the thread, the tree itself is only used for the addresses
+  // (it is taken out of its directory, so it is not saved)
+  TTree* add_tree(TTree*);
+
+  void start();
+
+  // Copy the current values of the branches to the queue
+  void push();
+
+  // Write the events left in the queue and stop the thread
+  void stop();
+
+private:
+  struct Branch {
+    TBranch* source;
+    TBranch* output;
+    std::vector<char> buffer;
+    void* bound;
+  };
+  struct Tree {
+    TTree* output;
+    std::vector<Branch> branches;
+  };
+  struct Slot {
+    std::vector<char>   data;
+    std::vector<size_t> sizes;
+  };
+
+  std::vector<Tree> trees_;
+  std::vector<Slot> slots_;
+  std::deque<size_t> free_;
+  std::deque<size_t> ready_;
+  std::mutex mutex_;
+  std::condition_variable slot_freed_;
+  std::condition_variable slot_ready_;
+  std::thread thread_;
+  bool running_ = false;
+  bool stopping_ = false;
+  int  savecount_;
+  long nwritten_ = 0;
+  long nwaits_ = 0;
+
+  void run_();
+  void write_(Slot&);
+};
+
+//_______________________________________________________
+//                Output trees
+
+bool
+SkimWriter::supported(TTree* tree)
+{
+  TIter next(tree->GetListOfBranches());
+  while ( TBranch* branch = (TBranch*)next() )
+    if ( branch->IsA() != TBranch::Class() || branch->GetListOfBranches()->GetEntries() ) {
+      std::cout << "SkimWriter - branch " << branch->GetName() << " has no leaf list" << std::endl;
+      return false;
+    }
+  return true;
+}
+
+TTree*
+SkimWriter::add_tree(TTree* tree)
+{
+  TTree* output = tree->CloneTree(0);
+  // The addresses are set by the writer, not copied from the tree any more
+  if ( tree->GetListOfClones() ) tree->GetListOfClones()->Remove(output);
+  output->SetDirectory(tree->GetDirectory());
+  output->SetAutoFlush(tree->GetAutoFlush());
+  tree->SetDirectory(0);
+
+  trees_.push_back(Tree());
+  trees_.back().output = output;
+  TIter next(tree->GetListOfBranches());
+  while ( TBranch* branch = (TBranch*)next() ) {
+    Branch b;
+    b.source = branch;
+    b.output = output->GetBranch(branch->GetName());
+    b.output->SetCompressionSettings(branch->GetCompressionSettings());
+    b.bound  = 0;
+    trees_.back().branches.push_back(b);
+  }
+  return output;
+}
+
+//_______________________________________________________
+//                 Thread and queue
+
+void
+SkimWriter::start()
+{
+  // Both threads use ROOT (the event loop reads, this one writes)
+  ROOT::EnableThreadSafety();
+  for (size_t i=0; i<slots_.size(); ++i) free_.push_back(i);
+  stopping_ = false;
+  running_ = true;
+  thread_ = std::thread(&SkimWriter::run_, this);
+}
+
+void
+SkimWriter::push()
+{
+  size_t i;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if ( free_.empty() ) ++nwaits_;
+    slot_freed_.wait(lock, [this] { return !free_.empty(); });
+    i = free_.front();
+    free_.pop_front();
+  }
+
+  // Values are at the address of the first leaf, in the order of the leaves
+  // (for arrays, the number of elements is given by the counter read for this event)
+  Slot& slot = slots_[i];
+  slot.data.clear();
+  slot.sizes.clear();
+  for (const auto& tree : trees_) for (const auto& b : tree.branches) {
+    size_t size = 0;
+    TIter next(b.source->GetListOfLeaves());
+    while ( TLeaf* leaf = (TLeaf*)next() ) size += leaf->GetLenType() * leaf->GetLen();
+    const char* address = (const char*)((TLeaf*)b.source->GetListOfLeaves()->At(0))->GetValuePointer();
+    if ( address ) slot.data.insert(slot.data.end(), address, address+size);
+    else           slot.data.resize(slot.data.size()+size, 0);
+    slot.sizes.push_back(size);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ready_.push_back(i);
+  }
+  slot_ready_.notify_one();
+}
+
+void
+SkimWriter::stop()
+{
+  if ( !running_ ) return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  slot_ready_.notify_one();
+  thread_.join();
+  running_ = false;
+  std::cout << "SkimWriter - " << nwritten_ << " events written, the event loop waited for the writer "
+            << nwaits_ << " times" << std::endl;
+}
+
+void
+SkimWriter::run_()
+{
+  while ( true ) {
+    size_t i;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      slot_ready_.wait(lock, [this] { return stopping_ || !ready_.empty(); });
+      if ( ready_.empty() ) return;
+      i = ready_.front();
+      ready_.pop_front();
+    }
+    write_(slots_[i]);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      free_.push_back(i);
+    }
+    slot_freed_.notify_one();
+  }
+}
+
+//_______________________________________________________
+//              Fill the output trees
+
+void
+SkimWriter::write_(Slot& slot)
+{
+  const char* data = slot.data.data();
+  size_t ibranch = 0;
+  for (auto& tree : trees_) {
+    for (auto& b : tree.branches) {
+      size_t size = slot.sizes[ibranch++];
+      if ( b.buffer.size() < size || b.buffer.empty() ) b.buffer.resize(std::max(size, (size_t)8));
+      if ( size ) std::memcpy(b.buffer.data(), data, size);
+      data += size;
+      if ( b.buffer.data() != b.bound ) {
+        b.output->SetAddress(b.buffer.data());
+        b.bound = b.buffer.data();
+      }
+    }
+    if ( tree.output->Fill() < 0 ) {
+      std::cout << "** Error ** SkimWriter - unable to fill tree " << tree.output->GetName() << std::endl;
+      exit(1);
+    }
+  }
+  if ( ++nwritten_ % savecount_ == 0 )
+    for (auto& tree : trees_) tree.output->AutoSave("SaveSelf");
+}
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef SOA_H
+#define SOA_H
+//-----------------------------------------------------------------------------
+// File:        SoA.h
+// Description: Fixed capacity structure of arrays for the object collections
+//              of DataStruct (see DataStruct_May10_SoA.h)
+//              Each collection owns one arena, allocated once, that holds a
+//              64 byte aligned column of capacity values for each variable.
+//              A column is used like the std::vector it replaces (col[i],
+//              begin/end, size), its size is the size of the collection,
+//              so reading an event does not resize or allocate anything.
+//              itreestream reads the branches straight into the columns.
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+class SoAArena;
+
+// Type independent part, used by itreestream and ColumnCache
+class SoAColumnBase {
+public:
+  SoAColumnBase(const SoAColumnBase&) = delete;
+  SoAColumnBase& operator=(const SoAColumnBase&) = delete;
+
+  void*  address()  const { return data_; }
+  size_t capacity() const { return capacity_; }
+  // Size of the collection (capacity before the first event is read)
+  size_t size()     const { return std::min<size_t>(*size_, capacity_); }
+
+protected:
+  inline SoAColumnBase(SoAArena&, const unsigned int&, const size_t&, void (*)(void*, const size_t&));
+
+  void* data_ = 0;
+  const unsigned int* size_;
+  size_t capacity_ = 0;
+
+private:
+  friend class SoAArena;
+  size_t elsize_;
+  void (*fill_)(void*, const size_t&);
+};
+
+template <class T>
+class SoAColumn : public SoAColumnBase {
+public:
+  typedef T value_type;
+
+  SoAColumn(SoAArena& arena, const unsigned int& size) : SoAColumnBase(arena, size, sizeof(T), &fill_) {}
+
+  T&       operator[](const size_t& i)       { return data()[i]; }
+  const T& operator[](const size_t& i) const { return data()[i]; }
+
+  T*       data()        { return (T*)data_; }
+  const T* data()  const { return (const T*)data_; }
+  T*       begin()       { return data(); }
+  const T* begin() const { return data(); }
+  T*       end()         { return data() + size(); }
+  const T* end()   const { return data() + size(); }
+
+  // Copies of the values of the event
+  operator std::vector<T>() const { return std::vector<T>(begin(), end()); }
+
+  SoAColumn& operator=(const std::vector<T>& v)
+  {
+    std::copy(v.begin(), v.begin() + std::min(v.size(), capacity_), data());
+    return *this;
+  }
+
+private:
+  static void fill_(void* data, const size_t& n) { std::fill_n((T*)data, n, T(-9999)); }
+};
+
+// Memory of the columns of a collection
+class SoAArena {
+public:
+  explicit SoAArena(const size_t& capacity) : capacity_(capacity) {}
+  SoAArena(const SoAArena&) = delete;
+  SoAArena& operator=(const SoAArena&) = delete;
+
+  size_t capacity() const { return capacity_; }
+
+  // Set all values to -9999 (the memory is allocated at the first call,
+  // after all columns are constructed)
+  void fill()
+  {
+    if ( memory_.empty() ) allocate_();
+    for (auto col : columns_) col->fill_(col->data_, capacity_);
+  }
+
+private:
+  friend class SoAColumnBase;
+  static const size_t align_ = 64;
+
+  size_t capacity_;
+  std::vector<SoAColumnBase*> columns_;
+  std::vector<char> memory_;
+
+  static size_t padded_(const size_t& bytes) { return (bytes + align_-1) / align_ * align_; }
+
+  void allocate_()
+  {
+    size_t bytes = 0;
+    for (auto col : columns_) bytes += padded_(capacity_ * col->elsize_);
+    memory_.resize(bytes + align_);
+    char* data = (char*)padded_((uintptr_t)memory_.data());
+    for (auto col : columns_) {
+      col->data_ = data;
+      col->capacity_ = capacity_;
+      data += padded_(capacity_ * col->elsize_);
+    }
+  }
+};
+
+SoAColumnBase::SoAColumnBase(SoAArena& arena, const unsigned int& size, const size_t& elsize,
+			     void (*fill)(void*, const size_t&)) :
+  size_(&size), elsize_(elsize), fill_(fill)
+{
+  arena.columns_.push_back(this);
+}
+
+#endif
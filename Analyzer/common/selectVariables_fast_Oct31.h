@@ -8,8 +8,8 @@
 //-----------------------------------------------------------------------------
 
 void selectVariables(itreestream& stream, DataStruct& data) {
-  //++ stream.select("evt_RunNumber", data.evt.RunNumber);
-  //++ stream.select("evt_LumiBlock", data.evt.LumiBlock);
+  stream.select("evt_RunNumber", data.evt.RunNumber);
+  stream.select("evt_LumiBlock", data.evt.LumiBlock);
   //++ stream.select("evt_EventNumber", data.evt.EventNumber);
   //stream.select("evt_NGoodVtx", data.evt.NGoodVtx);
   //stream.select("evt_LHA_PDF_ID", data.evt.LHA_PDF_ID);
@@ -58,6 +58,7 @@
 #include <typeinfo>
 #include <cctype>
 #include <cassert>
+#include <chrono>
 
 
 #include "TList.h"
@@ -72,11 +73,16 @@
 #include "TList.h"
 #include "TIterator.h"
 #include "TFriendElement.h"
+#include "TChainElement.h"
+#include "TEnv.h"
 
 #ifdef PROJECT_NAME
 #include "PhysicsTools/TheNtupleMaker/interface/treestream.h"
 #else
 #include "treestream.h"
+#include "ColumnCache.h"
+#include "InputStager.h"
+#include "SoA.h"
 #endif
 //----------------------------------------------------------------------------
 using namespace std;
@@ -709,6 +715,23 @@ namespace
       cout << "END toexternal" << endl;
   }
 
+  // ----------------------------------------------------------------------
+  // Copy to a fixed capacity column (SoA.h) from internal buffer.
+  // Note: T is the type of the column, its size is given by the
+  //       collection, values beyond its capacity are dropped
+  // ----------------------------------------------------------------------
+  template <class T>
+  inline
+  void
+  tocolumn(Field* field)
+  {
+    int count = min(field->leaf->GetLen(), field->maxsize);
+    SoAColumnBase* c = reinterpret_cast<SoAColumnBase*>(field->address);
+    T* d = reinterpret_cast<T*>(c->address());
+    for(int index=0; index < count; index++)
+      d[index] = static_cast<T>(field->leaf->GetValue(index));
+  }
+
   // ----------------------------------------------------------------------
   // IMPORTANT: In tree->Branch(..), it is necessary to use the correct 
   // type when giving the address of the variable from which data are to 
@@ -836,89 +859,146 @@ namespace
   }
 
 
-  void 
-  readbranch(Field* field, int entry)
-  {
-    assert(field != 0);
-    if ( field->branch ==0 ) return;
-
-    assert(field->branch != 0);
-    assert(field->leaf != 0);
-
-    // Read entry for current branch
-
-    field->branch->GetEntry(entry);
+  // Function that copies data from the internal to the external buffer
+  // (iotype -> srctype), resolved once when the read tables are compiled
+  typedef void (*CopyFunction)(Field*);
 
+  CopyFunction
+  copyfunction(Field* field)
+  {
     // If address field is zero, this signals that 
     // the caller has not provided a location into which 
     // the value of the current variable is to be written.
     // This should happen only for leaf counter variables.
-    // In this case, just return
 
-    if ( field->address == 0) return;
+    if ( field->address == 0) return 0;
 
     // If this is intrinsically a vector type, we let Root handle it
     // directly
-    if ( field->iotype == 'v' ) return;
+    if ( field->iotype == 'v' ) return 0;
 
-    // Copy data from internal to external buffers
-    // iotype -> srctype
+    if ( field->iscolumn )
+      return field->srctype == 'F' ? &tocolumn<float> : &tocolumn<int>;
 
     switch(field->srctype)
       {
-      case 'D':
-        toexternal<double>(field);
-        break;
-	
-      case 'F':
-        toexternal<float>(field);
-        break;
-        
-      case 'L':
-        toexternal<long>(field);
-        break;
-        
-      case 'I':
-        toexternal<int>(field);
-        break;
-        
-      case 'S':
-        toexternal<short>(field);
-        break;
+      case 'D': return &toexternal<double>;
+      case 'F': return &toexternal<float>;
+      case 'L': return &toexternal<long>;
+      case 'I': return &toexternal<int>;
+      case 'S': return &toexternal<short>;
+      case 'B': return &toexternal<char>;
+      case 'O': return &toexternal<bool>;
+      case 'C': return &toexternal<string>;
+      case 'l': return &toexternal<unsigned long>;
+      case 'i': return &toexternal<unsigned int>;
+      case 's': return &toexternal<unsigned short>;
+      case 'b': return &toexternal<unsigned char>;
+      default:  return &toexternal<double>;
+      }
+  }
 
-      case 'B':
-        toexternal<char>(field);
-        break;
+  // Source type corresponding to the type of the leaf (' ': none)
+  char
+  leafsrctype(TLeaf* leaf)
+  {
+    string t(leaf->GetTypeName());
+    if ( t == "Double_t" )   return 'D';
+    if ( t == "Float_t" )    return 'F';
+    if ( t == "Long64_t" || t == "Long_t" )   return 'L';
+    if ( t == "Int_t" )      return 'I';
+    if ( t == "Short_t" )    return 'S';
+    if ( t == "Char_t" )     return 'B';
+    if ( t == "Bool_t" )     return 'O';
+    if ( t == "ULong64_t" || t == "ULong_t" ) return 'l';
+    if ( t == "UInt_t" )     return 'i';
+    if ( t == "UShort_t" )   return 's';
+    if ( t == "UChar_t" )    return 'b';
+    return ' ';
+  }
 
-      case 'O':
-        toexternal<bool>(field);
-        break;
+  // The branch can read straight into the source if the types are the
+  // same, the branch has a single leaf, and the source is a scalar for a
+  // single value or a vector that can hold the longest array in the file
+  bool
+  canbind(Field* field)
+  {
+    if ( field->copy == 0 ) return false;
+    if ( field->srctype == 'C' ) return false;
+    if ( leafsrctype(field->leaf) != field->srctype ) return false;
+    if ( field->branch->GetNleaves() != 1 ) return false;
+    if ( field->isvector )
+      // vector<bool> has no contiguous storage
+      return field->srctype != 'O' && 
+        getmaxsize(field->leaf) <= field->maxsize;
+    int count = 0;
+    return field->leaf->GetLeafCounter(count) == 0 && count == 1;
+  }
 
-      case 'C':
-        toexternal<string>(field);
-        break;
-	
-      case 'l':
-        toexternal<unsigned long>(field);
-        break;
-	
-      case 'i':
-        toexternal<unsigned int>(field);
-        break;
+  // Size the source vector to the array length of the current entry 
+  // (leaf counters are read first) and point the branch to its storage.
+  // The capacity is kept at maxsize, so the storage only moves if the
+  // vector is replaced by the caller.
+  template <class T>
+  void
+  bindvector(Field* field)
+  {
+    vector<T>* d = reinterpret_cast<vector<T>*>(field->address);
+    if ( (int)d->capacity() < field->maxsize ) d->reserve(field->maxsize);
+    d->resize(field->leaf->GetLen());
+    void* address = d->data();
+    if ( address != field->bound )
+      {
+        field->branch->SetAddress(address);
+        field->bound = address;
+      }
+  }
 
-      case 's':
-        toexternal<unsigned short>(field);
-        break;
+  typedef void (*BindFunction)(Field*);
 
-      case 'b':
-        toexternal<unsigned char>(field);
-        break;
-	
-      default:
-        toexternal<double>(field);
-        break;
+  BindFunction
+  bindfunction(Field* field)
+  {
+    switch(field->srctype)
+      {
+      case 'D': return &bindvector<double>;
+      case 'F': return &bindvector<float>;
+      case 'L': return &bindvector<long>;
+      case 'I': return &bindvector<int>;
+      case 'S': return &bindvector<short>;
+      case 'B': return &bindvector<char>;
+      case 'l': return &bindvector<unsigned long>;
+      case 'i': return &bindvector<unsigned int>;
+      case 's': return &bindvector<unsigned short>;
+      case 'b': return &bindvector<unsigned char>;
+      default:  return 0;
       }
   }
+
+  // Position of the first basket of the branch in its file
+  Long64_t
+  basketseek(Field* field)
+  {
+    return field->branch->GetBasketSeek(0);
+  }
+
+  // Fields in the read tables always have a branch and a leaf
+  // Returns false if the entry could not be read
+  inline
+  bool 
+  readbranch(Field* field, int entry)
+  {
+    if ( field->bind ) field->bind(field);
+
+    // Read entry for current branch
+
+    int nbytes = field->branch->GetEntry(entry);
+    if ( nbytes < 0 ) return false;
+    field->nbytes += nbytes;
+
+    if ( field->copy ) field->copy(field);
+    return true;
+  }
 }
 
 
@@ -932,6 +1012,18 @@ itreestream::itreestream()
     _entries(0),
     _entry(0),
     _index(0),
+    _localentry(0),
+    _cachesize(0),
+    _unzipsize(0),
+    _prefetch(false),
+    _cacheset(false),
+    _colcache(0),
+    _bind(true),
+    _stager(0),
+    _stalltime(0),
+    _retries(0),
+    _skipbad(false),
+    _readerror(false),
     _buffer(vector<double>(1000)),
     data(Data()),
     selecteddata(SelectedData()),
@@ -946,6 +1038,18 @@ itreestream::itreestream(string filename_, int bufsize)
     _entries(0),
     _entry(0),
     _index(0),
+    _localentry(0),
+    _cachesize(0),
+    _unzipsize(0),
+    _prefetch(false),
+    _cacheset(false),
+    _colcache(0),
+    _bind(true),
+    _stager(0),
+    _stalltime(0),
+    _retries(0),
+    _skipbad(false),
+    _readerror(false),
     _buffer(vector<double>(bufsize)),
     data(Data()),
     selecteddata(SelectedData()),
@@ -965,6 +1069,18 @@ itreestream::itreestream(vector<string>& fname, int bufsize)
     _entries(0),
     _entry(0),
     _index(0),
+    _localentry(0),
+    _cachesize(0),
+    _unzipsize(0),
+    _prefetch(false),
+    _cacheset(false),
+    _colcache(0),
+    _bind(true),
+    _stager(0),
+    _stalltime(0),
+    _retries(0),
+    _skipbad(false),
+    _readerror(false),
     _buffer(vector<double>(bufsize)),
     data(Data()),
     selecteddata(SelectedData()),
@@ -982,6 +1098,18 @@ itreestream::itreestream(string filename_, string treename, int bufsize)
     _entries(0),
     _entry(0),
     _index(0),
+    _localentry(0),
+    _cachesize(0),
+    _unzipsize(0),
+    _prefetch(false),
+    _cacheset(false),
+    _colcache(0),
+    _bind(true),
+    _stager(0),
+    _stalltime(0),
+    _retries(0),
+    _skipbad(false),
+    _readerror(false),
     _buffer(vector<double>(bufsize)),
     data(Data()),
     selecteddata(SelectedData()),
@@ -1002,11 +1130,55 @@ itreestream::itreestream(vector<string>& fname, string treename, int bufsize)
     _entries(0),
     _entry(0),
     _index(0),
+    _localentry(0),
+    _cachesize(0),
+    _unzipsize(0),
+    _prefetch(false),
+    _cacheset(false),
+    _colcache(0),
+    _bind(true),
+    _stager(0),
+    _stalltime(0),
+    _retries(0),
+    _skipbad(false),
+    _readerror(false),
+    _buffer(vector<double>(bufsize)),
+    data(Data()),
+    selecteddata(SelectedData()),
+    _delete(true)
+{
+  vector<string> tname;
+  split(treename, tname);
+  _open(fname, tname);
+}
+
+itreestream::itreestream(vector<string>& fname, string treename, 
+                         vector<long long> nentries, int bufsize)
+  : _tree(0),
+    _chain(0),
+    _statuscode(kSUCCESS),
+    _current(-1),
+    _entries(0),
+    _entry(0),
+    _index(0),
+    _localentry(0),
+    _cachesize(0),
+    _unzipsize(0),
+    _prefetch(false),
+    _cacheset(false),
+    _colcache(0),
+    _bind(true),
+    _stager(0),
+    _stalltime(0),
+    _retries(0),
+    _skipbad(false),
+    _readerror(false),
     _buffer(vector<double>(bufsize)),
     data(Data()),
     selecteddata(SelectedData()),
     _delete(true)
 {
+  _nentries = nentries;
   vector<string> tname;
   split(treename, tname);
   _open(fname, tname);
@@ -1134,11 +1306,17 @@ itreestream::_open(vector<string>& fname, vector<string>& tname)
           _chain->AddFriend(_chainlist.back());
         }
 
+      // With known entries, TChain does not open the files here
+      // (friends have the same number of entries)
+      bool known = _nentries.size() == filepath.size();
       for(int i=0; i < (int)filepath.size(); i++)
         {
           for(unsigned int k=0; k < _chainlist.size(); k++)
             {
-              _chainlist[k]->Add(filepath[i].c_str());
+              if ( known )
+                _chainlist[k]->Add(filepath[i].c_str(), _nentries[i]);
+              else
+                _chainlist[k]->Add(filepath[i].c_str());
             }
         }
 
@@ -1355,6 +1533,12 @@ itreestream::close()
 {
   _statuscode = kSUCCESS;
   
+  delete _colcache;
+  _colcache = 0;
+
+  delete _stager;
+  _stager = 0;
+
   if ( _tree == 0 ) return;
   DBUG("itreestream::close file",3);
   if ( _delete ) delete  _tree;
@@ -1491,6 +1675,18 @@ itreestream::select(string namen, vector<unsigned short>& d)
   _select(namen, &d, d.size(), 's', true);
 }
 
+void 
+itreestream::select(string namen, SoAColumn<float>& d)
+{
+  _select(namen, static_cast<SoAColumnBase*>(&d), d.capacity(), 'F', true, true);
+}
+
+void 
+itreestream::select(string namen, SoAColumn<int>& d)
+{
+  _select(namen, static_cast<SoAColumnBase*>(&d), d.capacity(), 'I', true, true);
+}
+
 void 
 itreestream::select(string namen)
 {
@@ -1529,6 +1725,105 @@ itreestream::get(string namen)
 // ------------------------------------------------------------------------
 int 
 itreestream::read(int entry)
+{
+  return _readentry(entry, 0); // Return ordinal value within current tree.
+}
+
+// ------------------------------------------------------------------------
+// Two phase reading: read_preselection reads the leaf counters and the
+// variables tagged with preselect, read_rest reads the others for the
+// same entry (only needed for events passing a preselection).
+// ------------------------------------------------------------------------
+void
+itreestream::preselect(string namen)
+{
+  if ( selecteddata.find(namen) == selecteddata.end() )
+    {
+      warning("itreestream - preselected branch " + namen + " is not selected");
+      return;
+    }
+  selecteddata[namen]->ispreselected = true;
+
+  // Read tables are compiled again at the next read
+  _current = -1;
+}
+
+int 
+itreestream::read_preselection(int entry)
+{
+  return _readentry(entry, 1);
+}
+
+bool
+itreestream::read_rest()
+{
+  return _readentry(_entry, 2) >= 0;
+}
+
+// ------------------------------------------------------------------------
+// Read an entry with the retry policy (see retry): a failed read is
+// repeated after opening the file again, a slow read opens the file again
+// for the next entries, and the entries of bad files are skipped.
+// ------------------------------------------------------------------------
+int
+itreestream::_readentry(int entry, int phase)
+{
+  if ( _retries <= 0 && !_skipbad )
+    {
+      int localentry = phase == 2 ? _localentry : _load(entry);
+      if (localentry < 0) return localentry;
+
+      _read(localentry, phase);
+
+      return localentry;
+    }
+
+  for(int attempt=0; ; attempt++)
+    {
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+      // The rest of an entry is read again together with the counters
+      int readphase = phase == 2 && attempt > 0 ? 0 : phase;
+      _readerror = false;
+      int localentry = readphase == 2 ? _localentry : _load(entry);
+      // (-1: empty chain, -2: no such entry, -3 and below: file or tree not read)
+      if ( localentry == kSKIPPED || localentry == -1 || localentry == -2 ) 
+        return localentry;
+      if ( localentry >= 0 ) _read(localentry, readphase);
+
+      bool failed = localentry < 0 || _readerror;
+      double time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+      bool stalled = _stalltime > 0 && time > _stalltime;
+      if ( !failed && !stalled ) return localentry;
+
+      int tree = _treenumber(entry);
+      if ( tree < 0 || tree >= (int)filepath.size() ) return localentry;
+      stringstream ss;
+      if ( failed ) ss << "itreestream - failed to read entry " << entry;
+      else          ss << "itreestream - reading entry " << entry << " took " << time << " s";
+      ss << " from file " << filepath[tree];
+      warning(ss.str());
+
+      if ( _reopened[tree] < _retries )
+        {
+          _reopened[tree]++;
+          _reopen(tree);
+          // Values of a slow read are good, the file is only opened again
+          if ( failed ) continue;
+          return localentry;
+        }
+      if ( !failed ) return localentry;
+
+      // The file stays bad
+      if ( !_skipbad ) fatal("itreestream - unable to read file " + filepath[tree]);
+      warning("itreestream - skipping the rest of file " + filepath[tree]);
+      _bad[tree] = 1;
+      return kSKIPPED;
+    }
+}
+
+int
+itreestream::_load(int entry)
 {
   _statuscode = kSUCCESS;
   int localentry = 0;
@@ -1542,6 +1837,16 @@ itreestream::read(int entry)
 
       // Load tree into memory
 
+      // Entries of bad files are not read, the next files are staged
+      if ( _bad.size() || _stager != 0 )
+        {
+          int tree = _treenumber(entry);
+          if ( tree >= 0 && tree < (int)_bad.size() && _bad[tree] ) 
+            return kSKIPPED;
+          if ( _stager != 0 && tree != _chain->GetTreeNumber() ) 
+            _stage(tree);
+        }
+
       localentry = _chain->LoadTree(entry);
       
       if (localentry < 0) return localentry;
@@ -1564,32 +1869,55 @@ itreestream::read(int entry)
 
       _entry++;
     }
-     
-  // Copy data into external buffers
+  _localentry = localentry;
+  return localentry;
+}
 
-  SelectedData::iterator it;
+// phase 0: all variables, 1: counters and preselected variables, 2: the rest
+void
+itreestream::_read(int localentry, int phase)
+{
+  // Values of the current tree are in the column cache
+
+  if ( _colcache != 0 && _colcache->mapped() )
+    {
+      for(int t=0; t < 3; t++)
+        {
+          if ( phase == 1 && t == 2 ) continue;
+          if ( phase == 2 && t != 2 ) continue;
+          for(size_t i=0, n=_readorder[t].size(); i < n; i++)
+            if ( _readorder[t][i]->column >= 0 ) 
+              _colcache->get(_readorder[t][i], localentry);
+        }
+      return;
+    }
+
+  // Copy data into external buffers
 
   // IMPORTANT: Read leaf counters first...
 
-  for(it=selecteddata.begin(); it != selecteddata.end(); it++)
+  bool ok = true;
+  if ( phase < 2 )
     {
-      Field* field = it->second;
-      assert(field != 0);
-      if ( ! field->iscounter ) continue;
-      readbranch(field, localentry);
+      for(size_t i=0, n=_readorder[0].size(); i < n; i++)
+        ok &= readbranch(_readorder[0][i], localentry);
+      for(size_t i=0, n=_readorder[1].size(); i < n; i++)
+        ok &= readbranch(_readorder[1][i], localentry);
     }
 
   // ..then other variables
 
-  for(it=selecteddata.begin(); it != selecteddata.end(); it++)
+  if ( phase != 1 )
+    for(size_t i=0, n=_readorder[2].size(); i < n; i++)
+      ok &= readbranch(_readorder[2][i], localentry);
+  if ( !ok ) _readerror = true;
+
+  // Only trees read completely can be cached
+  if ( _colcache != 0 )
     {
-      Field* field = it->second;
-      assert(field != 0);
-      if ( field->iscounter ) continue;
-      readbranch(field, localentry);
+      if ( phase == 0 ) _colcache->record(localentry);
+      else              _colcache->abandon();
     }
-
-  return localentry; // Return ordinal value within current tree.
 }
 
 int 
@@ -1598,6 +1926,169 @@ itreestream::entries() { return _entries; }
 int 
 itreestream::size()    { return _entries; }
 
+void
+itreestream::columncache(string dir)
+{
+  delete _colcache;
+  _colcache = new ColumnCache(dir);
+
+  // The cache is opened for the current tree at the next read
+  _current  = -1;
+}
+
+void
+itreestream::stage(string dir, long long maxsize, int ahead)
+{
+  delete _stager;
+  _stager = new InputStager(dir, maxsize, ahead);
+
+  // The file of the next entry is staged when it is opened
+  _current = -1;
+}
+
+void
+itreestream::retry(double stalltime, int retries, bool skipbad)
+{
+  _stalltime = stalltime;
+  _retries   = retries;
+  _skipbad   = skipbad;
+  _reopened  = vector<int>(filepath.size(), 0);
+  _bad       = vector<char>(filepath.size(), 0);
+}
+
+// Number of the tree (file) of an entry of the chain
+int
+itreestream::_treenumber(int entry)
+{
+  if ( _chain == 0 ) return _current;
+  Long64_t* offsets = _chain->GetTreeOffset();
+  int ntrees = _chain->GetNtrees();
+  return upper_bound(offsets, offsets+ntrees+1, (Long64_t)entry) - offsets - 1;
+}
+
+// Open the file of the tree from the staged copy, if it is ready,
+// and stage the next files while it is read
+void
+itreestream::_stage(int tree)
+{
+  int previous = _chain->GetTreeNumber();
+  if ( previous >= 0 && previous < (int)filepath.size() ) 
+    _stager->release(filepath[previous]);
+  if ( tree < 0 || tree >= (int)filepath.size() ) return;
+
+  _setpath(tree, _stager->path(filepath[tree]));
+  for(int i=tree+1; i <= tree+_stager->ahead() && i < (int)filepath.size(); i++)
+    _stager->prefetch(filepath[i]);
+}
+
+// File name the tree is opened with (also for friends, in the same file)
+void
+itreestream::_setpath(int tree, string path)
+{
+  for(unsigned int k=0; k < _chainlist.size(); k++)
+    {
+      TChainElement* element = 
+        (TChainElement*)_chainlist[k]->GetListOfFiles()->At(tree);
+      if ( element ) element->SetTitle(path.c_str());
+    }
+}
+
+// Open the file again at the next read (the original file, if the
+// staged copy was read)
+void
+itreestream::_reopen(int tree)
+{
+  if ( _stager != 0 && 
+       filepath[tree] != _chain->GetListOfFiles()->At(tree)->GetTitle() )
+    {
+      _stager->invalidate(filepath[tree]);
+      _setpath(tree, filepath[tree]);
+    }
+  // The chains are made again with the same files (and the number of
+  // entries known from the first chain, so the files are not opened here),
+  // the file of the next entry is then opened at the next LoadTree
+  int ntrees = _chain->GetNtrees();
+  Long64_t* offsets = _chain->GetTreeOffset();
+  vector<Long64_t> entries(offsets, offsets+ntrees+1);
+  for(unsigned int k=0; k < _chainlist.size(); k++)
+    {
+      TChain* chain = _chainlist[k];
+      vector<string> paths;
+      for(int i=0; i < ntrees; i++)
+        paths.push_back(chain->GetListOfFiles()->At(i)->GetTitle());
+      chain->Reset();
+      for(int i=0; i < ntrees; i++)
+        chain->Add(paths[i].c_str(), entries[i+1] - entries[i]);
+    }
+
+  // Branch pointers (and the cache) are updated at the next read
+  _cacheset = false;
+  _current = -1;
+}
+
+void
+itreestream::bind(bool on)
+{
+  _bind = on;
+
+  // The read tables are compiled again at the next read
+  _current = -1;
+}
+
+void
+itreestream::cache(long cachesize, double unzipsize, bool prefetch)
+{
+  _cachesize = cachesize;
+  _unzipsize = unzipsize;
+  _prefetch  = prefetch;
+
+  // The next cluster is read ahead by the TFilePrefetch thread of the
+  // TTreeCache, which is only started for files opened after this
+  if ( _prefetch ) gEnv->SetValue("TFile.AsyncPrefetching", 1);
+
+  // The cache is set up at the next read
+  _cacheset  = false;
+  _current   = -1;
+}
+
+map<string, long long>
+itreestream::bytesread()
+{
+  map<string, long long> groups;
+  SelectedData::iterator it;
+  for(it=selecteddata.begin(); it != selecteddata.end(); it++)
+    {
+      Field* field = it->second;
+      assert(field != 0);
+      groups[field->branchname.substr(0, field->branchname.find('_'))] 
+        += field->nbytes;
+    }
+  return groups;
+}
+
+vector<int>
+itreestream::clusters()
+{
+  vector<int> starts;
+  if ( _chain == 0 ) fatal("chain pointer is zero");
+  Long64_t* offsets = _chain->GetTreeOffset();
+  for(int i=0; i < _chain->GetNtrees(); i++)
+    {
+      if ( offsets[i+1] == offsets[i] ) continue;
+      _chain->LoadTree(offsets[i]);
+      TTree* tree = _chain->GetTree();
+      TTree::TClusterIterator cluster = tree->GetClusterIterator(0);
+      Long64_t start;
+      while ( (start = cluster()) < tree->GetEntries() )
+        starts.push_back(offsets[i] + start);
+    }
+  starts.push_back(_entries);
+
+  // Branch pointers are updated again at the next read
+  _current = -1;
+  return starts;
+}
+
 string
 itreestream::name() { return _tree ? _tree->GetName() : ""; }
 
@@ -1614,7 +2105,14 @@ vector<string>
 itreestream::filenames() { return filepath; }
 
 string
-itreestream::filename() { return filepath[_current]; }
+itreestream::filename() { return _current >= 0 ? filepath[_current] : ""; }
+
+string
+itreestream::filename(int entry) 
+{ 
+  int tree = _treenumber(entry);
+  return tree >= 0 && tree < (int)filepath.size() ? filepath[tree] : "";
+}
 
 TTree*
 itreestream::tree() { return _tree; }
@@ -1693,10 +2191,13 @@ itreestream::str() const
 // ------------------------------------------------------------------------
 void 
 itreestream::_select(string namen, void* address, int maxsize, char srctype,
-                     bool isvector)
+                     bool isvector, bool iscolumn)
 {
   _statuscode = kSUCCESS;
 
+  // Read tables are compiled again at the next read
+  _current = -1;
+
   // If variable has already been selected, just update its address and
   // source type, otherwise get the branch and leaf.
 
@@ -1773,6 +2274,7 @@ itreestream::_select(string namen, void* address, int maxsize, char srctype,
     {
       selecteddata[namen]->address = address;
       selecteddata[namen]->srctype = srctype;
+      selecteddata[namen]->iscolumn = iscolumn;
     }
   else if ( data.find(namen) != data.end() )
     {
@@ -1783,6 +2285,7 @@ itreestream::_select(string namen, void* address, int maxsize, char srctype,
       field.maxsize = maxsize;
       field.address = address;     // source address
       field.isvector= isvector;
+      field.iscolumn= iscolumn;
       selecteddata[namen] = &field;
 
       // If this branch has a branch counter, select its branch unless
@@ -1868,6 +2371,9 @@ itreestream::_update()
       // We let Root handle vector types directly
       if ( field->iotype == 'v')
         {
+          if ( field->iscolumn )
+            fatal("_update - " + field->fullname + 
+                  " is a vector branch, it can not be read into a column");
           _chain->SetBranchAddress(field->branchname.c_str(), 
                                    &field->address, 
                                    &field->branch);
@@ -1877,6 +2383,95 @@ itreestream::_update()
               + field->fullname + " is of zero length!");
     }
   DBUG("\tdone updating branch pointers", 1);
+
+  // Cache (and optionally unzip ahead) the baskets of exactly the 
+  // selected branches for the whole cluster being read
+  // The chain keeps the cache (and its branches) for the next trees,
+  // so this is only done once
+  if ( _cachesize > 0 && _chain != 0 && !_cacheset )
+    {
+      if ( _unzipsize > 0 ) _chain->SetParallelUnzip(kTRUE, _unzipsize);
+      _chain->SetCacheSize(_cachesize);
+      _chain->SetCacheLearnEntries(1);
+      for(it=selecteddata.begin(); it != selecteddata.end(); it++)
+        {
+          Field* field = it->second;
+          if ( field->branch == 0 ) continue;
+          _chain->AddBranchToCache(field->branchname.c_str(), kTRUE);
+        }
+      _chain->StopCacheLearningPhase();
+      _cacheset = true;
+      DBUG("\tdone updating cache", 1);
+    }
+
+  _compile();
+
+  if ( _colcache != 0 && _chain != 0 ) _colcache->open(_chain->GetTree(), selecteddata);
+}
+
+// ------------------------------------------------------------------------
+// Compile the selected fields into flat read tables (leaf counters,
+// preselected variables, the rest), each sorted by the position of the
+// baskets in the file, and with the copy function resolved, so reading an
+// entry is a loop without map look ups or switching on the type.
+// Where the source has the same type as the leaf, the branch is bound to
+// the source and there is nothing to copy.
+// ------------------------------------------------------------------------
+void 
+itreestream::_compile()
+{
+  for(int i=0; i < 3; i++) _readorder[i].clear();
+
+  SelectedData::iterator it;
+  for(it=selecteddata.begin(); it != selecteddata.end(); it++)
+    {
+      Field* field = it->second;
+      assert(field != 0);
+      if ( field->branch == 0 ) continue;
+      assert(field->leaf != 0);
+
+      field->copy = copyfunction(field);
+      field->bind = 0;
+      if ( _bind && canbind(field) )
+        {
+          // Zero-copy: the branch reads into the source itself
+          // (vectors are bound before each read)
+          field->copy = 0;
+          if ( field->iscolumn )
+            {
+              // The storage of columns never moves
+              void* address = 
+                reinterpret_cast<SoAColumnBase*>(field->address)->address();
+              field->branch->SetAddress(address);
+              field->bound = address;
+            }
+          else if ( field->isvector )
+            {
+              field->bind  = bindfunction(field);
+              field->bound = 0;
+            }
+          else
+            {
+              field->branch->SetAddress(field->address);
+              field->bound = field->address;
+            }
+        }
+      else if ( field->bound != 0 )
+        {
+          // Was bound before, give back an internal buffer to the branch
+          field->branch->SetAddress(0);
+          field->bound = 0;
+        }
+
+      if      ( field->iscounter )     _readorder[0].push_back(field);
+      else if ( field->ispreselected ) _readorder[1].push_back(field);
+      else                             _readorder[2].push_back(field);
+    }
+  for(int i=0; i < 3; i++)
+    std::stable_sort(_readorder[i].begin(), _readorder[i].end(), 
+                     [](Field* a, Field* b) 
+                     { return basketseek(a) < basketseek(b); });
+  DBUG("\tdone compiling read tables", 1);
 }
 
 int 
@@ -74,8 +74,15 @@ struct Field
     : srctype(' '),
       iotype(' '),
       isvector(false),
+      iscolumn(false),
       iscounter(false),
+      ispreselected(false),
       maxsize(0),
+      nbytes(0),
+      copy(0),
+      bind(0),
+      bound(0),
+      column(-1),
       branch(0),
       leaf(0),
       address(0),
@@ -89,8 +96,15 @@ struct Field
   char   srctype;         /// Source type (type of user name/value pair)
   char   iotype;          /// Input/Output type
   bool   isvector;        /// True if vector type
+  bool   iscolumn;        /// True if fixed capacity column (SoA.h)
   bool   iscounter;       /// true if this is a leaf counter
+  bool   ispreselected;   /// true if read by read_preselection
   int    maxsize;         /// Maximum number of elements in source variable
+  long long nbytes;       /// Number of (uncompressed) bytes read so far
+  void (*copy)(Field*);   /// Copy to source address (0: nothing to copy)
+  void (*bind)(Field*);   /// Prepare source vector to be read into directly
+  void*  bound;           /// Address the branch reads into (0: internal buffer)
+  int    column;          /// Index in the column cache (-1: not cached)
   
   TBranch* branch;        /// Branch pertaining to source
   TLeaf*   leaf;          /// Leaf pertaining to source
@@ -113,6 +127,11 @@ struct FieldBuffer : public Field
 typedef std::map<std::string, Field>  Data;
 typedef std::map<std::string, Field*> SelectedData;
 
+class ColumnCache;
+class InputStager;
+class SoAColumnBase;
+template <class T> class SoAColumn;
+
 
 /** Model an input stream of Root trees.
               The classes itreestream and otreestream provide a convenient 
@@ -174,6 +193,12 @@ class itreestream
   itreestream(std::vector<std::string>& filenames, std::string treename,
               int bufsize=1000);
 
+  /** Same, with the number of entries of each file already known (eg. from
+      an index), so the files are not opened just to count the entries.
+  */
+  itreestream(std::vector<std::string>& filenames, std::string treename,
+              std::vector<long long> nentries, int bufsize=1000);
+
   ///
   virtual ~itreestream();
 
@@ -271,12 +296,35 @@ class itreestream
   ///
   void   select(std::string namen, std::vector<unsigned short>& data);
 
+  /** Select a fixed capacity column of a collection (see SoA.h).
+      The column is not resized, values beyond its capacity are dropped.
+  */
+  void   select(std::string namen, SoAColumn<float>& data);
+
+  ///
+  void   select(std::string namen, SoAColumn<int>& data);
+
   /** Read tree with ordinal value <i>entry</i>. 
       Return the ordinal value of the
       entry within the current tree.
   */
   int    read(int entry);
 
+  /** Tag a selected variable to be read in the preselection phase.
+      Leaf counters are always read in this phase.
+  */
+  void   preselect(std::string namen);
+
+  /** Read only the counters and the preselected variables of entry
+      <i>entry</i>. The rest of the variables can be read with 
+      read_rest(), eg. only for events that pass a preselection.
+  */
+  int    read_preselection(int entry);
+
+  /// Read the variables not read by the last call to read_preselection.
+  /// Returns false if they could not be read.
+  bool   read_rest();
+
   ///
   void   close();
 
@@ -286,6 +334,59 @@ class itreestream
   /// Proxy for entries.
   int    size();
 
+  /** Read the selected branches through a TTreeCache of cachesize bytes.
+      The cache holds exactly these branches (no learning phase).
+      If unzipsize > 0, the cached baskets are decompressed ahead in a
+      background thread into a buffer of unzipsize * cachesize bytes.
+      If prefetch is true, the next cluster is read in a background thread
+      (into a second buffer) while the current one is being read (ROOT's
+      TFile.AsyncPrefetching). Call after the variables are selected and
+      before the first read.
+   */
+  void   cache(long cachesize, double unzipsize=0, bool prefetch=false);
+
+  /** Keep a columnar cache of the selected variables in directory dir.
+      Trees read completely are cached, later the values are read from
+      the cache (see ColumnCache.h). Call after the variables are selected.
+   */
+  void   columncache(std::string dir);
+
+  /** Copy the input files to the local directory dir in a background
+      thread, ahead files before they are read, and read the local copies
+      (see InputStager.h). The least recently used copies are removed to
+      keep the directory below maxsize bytes.
+   */
+  void   stage(std::string dir, long long maxsize, int ahead=1);
+
+  /** Retry policy for unreliable input. If reading an entry fails, the
+      file is opened again (the original file, if a staged copy was read)
+      and the entry is read again. If reading an entry takes more than
+      stalltime seconds (0: no limit), the file is opened again for the
+      next entries. A file is opened again at most retries times, after
+      that a failing file is bad: if skipbad is true, read returns
+      kSKIPPED for all its remaining entries, otherwise the job stops.
+   */
+  void   retry(double stalltime, int retries, bool skipbad=false);
+
+  /// Returned by read for the entries of bad files (see retry)
+  static const int kSKIPPED = -100;
+
+  /** Allow (default) or not to bind branches directly to the selected
+      variables. Switch it off if the branch buffers have to keep the values
+      read (eg. when the tree is cloned), even if the variables are changed.
+   */
+  void   bind(bool on);
+
+  /** Return the number of (uncompressed) bytes read so far, summed for
+      groups of branches with the same prefix (before the first '_').
+   */
+  std::map<std::string, long long> bytesread();
+
+  /** Return the first entry of every cluster (group of entries stored
+      together in baskets) of the chain, followed by the number of entries.
+   */
+  std::vector<int> clusters();
+
   /// Return the maxium size of name/value pair.
   int    maximum(std::string name);
 
@@ -301,6 +402,9 @@ class itreestream
   /// Return name of current file.
   std::string  filename();
 
+  /// Return name of the file of entry (of the chain).
+  std::string  filename(int entry);
+
   /// Return file names.
   std::vector<std::string> filenames();
 
@@ -336,6 +440,20 @@ class itreestream
   int     _entries;
   int     _entry;
   int     _index;
+  int     _localentry;
+  long    _cachesize;
+  double  _unzipsize;
+  bool    _prefetch;
+  bool    _cacheset;
+  ColumnCache* _colcache;
+  bool    _bind;
+  InputStager* _stager;
+  double  _stalltime;
+  int     _retries;
+  bool    _skipbad;
+  bool    _readerror;
+  std::vector<int>  _reopened;
+  std::vector<char> _bad;
   std::vector<double> _buffer;
 
   Data         data;
@@ -348,16 +466,28 @@ class itreestream
   std::vector<std::string>  branchname;
   std::vector<int>          branchtab;
   std::vector<std::string>  filepath;
+  std::vector<long long>    _nentries;
 
   std::vector<TChain*> _chainlist;
 
+  /// Selected fields in read order: leaf counters, preselected, rest
+  std::vector<Field*> _readorder[3];
+
   void _open(std::vector<std::string>& filenames, 
              std::vector<std::string>& treenames);
   void _getbranches(TBranch* branch, int depth);
   void _getleaf    (TBranch* branch, TLeaf* leaf=0);
   void _select     (std::string name, void* address, int maxsize, 
-                    char srctype, bool isvector=false);
+                    char srctype, bool isvector=false, bool iscolumn=false);
   void _update();
+  void _compile();
+  int  _load(int entry);
+  void _read(int localentry, int phase);
+  int  _readentry(int entry, int phase);
+  int  _treenumber(int entry);
+  void _stage(int tree);
+  void _setpath(int tree, std::string path);
+  void _reopen(int tree);
   std::string _gettree(TDirectory* dir, 
 		       std::string treename="", 
 		       int depth=0);
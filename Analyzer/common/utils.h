@@ -16,9 +16,12 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <chrono>
+#include <algorithm>
 
 #include "treestream.h"
 #include "treestream.cc"
+#include "SkimWriter.h"
 
 // -- Root
 
@@ -88,6 +91,161 @@ namespace utils {
     if ( j < 0 ) j = filename.size();
     return filename.substr(i+1,j-i-1);
   }
+  //___________________________________________________
+  //        Exact (order independent) summation
+
+  // The sum is kept as a list of non-overlapping partials (Shewchuk's
+  // algorithm, same as python's math.fsum) and is rounded only once at the
+  // end, so the result does not depend on the order in which the terms were
+  // added. Partial sums of parallel workers can then be merged, and still
+  // give the same bits as a single sequential pass over all events
+  class ExactSum {
+  public:
+    void add(double x)
+    {
+      size_t i = 0;
+      for (size_t j=0, n=partials_.size(); j<n; ++j) {
+        double y = partials_[j];
+        if (std::abs(x) < std::abs(y)) std::swap(x, y);
+        double hi = x + y;
+        double lo = y - (hi - x);
+        if (lo != 0.0) partials_[i++] = lo;
+        x = hi;
+      }
+      // (the memory is kept, so this does not allocate in the event loop)
+      partials_.resize(i+1);
+      partials_[i] = x;
+    }
+
+    void add(const ExactSum& other)
+    {
+      std::vector<double> partials = other.partials_;
+      for (const auto& p : partials) add(p);
+    }
+
+    // Correctly rounded value of the sum
+    double value() const
+    {
+      size_t n = partials_.size();
+      if (n==0) return 0;
+      double hi = partials_[--n], lo = 0;
+      while (n > 0) {
+        double x = hi, y = partials_[--n];
+        hi = x + y;
+        lo = y - (hi - x);
+        if (lo != 0.0) break;
+      }
+      // Make half-even rounding work across multiple partials
+      if (n > 0 && ((lo < 0.0 && partials_[n-1] < 0.0) || (lo > 0.0 && partials_[n-1] > 0.0))) {
+        double y = lo * 2.0;
+        double x = hi + y;
+        if (y == x - hi) hi = x;
+      }
+      return hi;
+    }
+
+    const std::vector<double>& partials() const { return partials_; }
+
+  private:
+    std::vector<double> partials_;
+  };
+
+  //-----------------------------------------------------------------------------
+  //        Per-stage timing of the event loop
+
+  // Wall time (steady_clock) and number of calls are summed for each stage
+  // Only every N-th event is timed (N = sampling, 0 = timing is off),
+  // so the overhead of reading the clock stays negligible
+  class StageTimer {
+  public:
+    StageTimer(const unsigned int& sampling=0) : sampling_(sampling), active_(false) {}
+
+    // Register a new stage, returns the id to be used in start/stop
+    size_t add_stage(const std::string& name)
+    {
+      names_.push_back(name);
+      ns_.push_back(0);
+      calls_.push_back(0);
+      start_.push_back(clock::time_point());
+      return names_.size()-1;
+    }
+
+    // Decide whether this event is timed
+    void new_event(const long& entry) { active_ = sampling_ && entry % sampling_ == 0; }
+
+    void start(const size_t& id) { if (active_) start_[id] = clock::now(); }
+
+    void stop(const size_t& id)
+    {
+      if (!active_) return;
+      ns_[id] += std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start_[id]).count();
+      ++calls_[id];
+    }
+
+    // Write the total time (s) and number of calls of each stage to a "timing" directory
+    void write(TDirectory* dir) const
+    {
+      TDirectory* timing_dir = dir->GetDirectory("timing");
+      if (timing_dir == 0) timing_dir = dir->mkdir("timing");
+      size_t n = names_.size();
+      TH1D* h_time  = new TH1D("time",  ";;Total time (s)",   n,0,n);
+      TH1D* h_calls = new TH1D("calls", ";;Number of calls", n,0,n);
+      for (size_t i=0; i<n; ++i) {
+        h_time ->GetXaxis()->SetBinLabel(i+1, names_[i].c_str());
+        h_calls->GetXaxis()->SetBinLabel(i+1, names_[i].c_str());
+        h_time ->SetBinContent(i+1, ns_[i]*1e-9);
+        h_calls->SetBinContent(i+1, calls_[i]);
+      }
+      for (TH1D* h : { h_time, h_calls }) {
+        h->SetDirectory(0);
+        h->SetStats(0);
+        timing_dir->WriteTObject(h);
+        delete h;
+      }
+    }
+
+    // Add the timing previously saved with write (used to merge parallel workers)
+    void add(TFile* f)
+    {
+      TH1* h_time  = (TH1*)f->Get("timing/time");
+      TH1* h_calls = (TH1*)f->Get("timing/calls");
+      if ( h_time == 0 || h_calls == 0 ) error("timing histos not found in file " + std::string(f->GetName()));
+      for (size_t i=0; i<names_.size(); ++i) {
+        int bin = h_time->GetXaxis()->FindFixBin(names_[i].c_str());
+        if (bin<1) continue;
+        ns_[i]    += std::llround(h_time->GetBinContent(bin)*1e9);
+        calls_[i] += std::llround(h_calls->GetBinContent(bin));
+      }
+    }
+
+    // Summary table, fraction is given relative to the first stage (ie. the whole event)
+    void print() const
+    {
+      if (!sampling_ || names_.empty()) return;
+      std::cout<<"Timing of the event loop stages (every "<<sampling_<<". event):"<<std::endl;
+      std::cout<<std::left<<std::setw(30)<<"  Stage"<<std::right<<std::setw(14)<<"Calls"
+               <<std::setw(14)<<"Total (s)"<<std::setw(16)<<"Per call (us)"<<std::setw(12)<<"Fraction"<<std::endl;
+      for (size_t i=0; i<names_.size(); ++i) {
+        std::cout<<std::left<<std::setw(30)<<"  "+names_[i]<<std::right<<std::setw(14)<<calls_[i]
+                 <<std::fixed<<std::setprecision(3)<<std::setw(14)<<ns_[i]*1e-9
+                 <<std::setw(16)<<(calls_[i] ? ns_[i]*1e-3/calls_[i] : 0)
+                 <<std::setw(11)<<(ns_[0] ? 100.0*ns_[i]/ns_[0] : 0)<<"%"<<std::endl;
+      }
+      std::cout.unsetf(std::ios::floatfield);
+      std::cout<<std::setprecision(6)<<std::endl;
+    }
+
+  private:
+    typedef std::chrono::steady_clock clock;
+
+    unsigned int sampling_;
+    bool active_;
+    std::vector<std::string> names_;
+    std::vector<long long> ns_;
+    std::vector<long long> calls_;
+    std::vector<clock::time_point> start_;
+  };
+
   //-----------------------------------------------------------------------------
   struct outputFile
   {
@@ -95,9 +253,12 @@ namespace utils {
       : filename_(filename),
         file_(new TFile(filename_.c_str(), "recreate")),
         tree_(0),
+        derived_(0),
         b_weight_(0),
         entry_(0),
-        SAVECOUNT_(50000)
+        SAVECOUNT_(50000),
+        queue_(0),
+        writer_(0)
     {
       file_->cd();
       hist_ = new TH1D("counts", "", 1,0,1);
@@ -106,16 +267,48 @@ namespace utils {
       hist_->SetStats(0);
     }
     
-    outputFile(std::string filename, itreestream& stream, int savecount=50000) 
+    // Skim: the input tree is copied for the events added, either with all
+    // branches, or only with those in the list (and their leaf counters)
+    // With derived=true, an empty tree "derived" is also made, that the
+    // analysis can book variables to, and which is filled together with the
+    // skimmed tree (so it can be read as its friend)
+    // compression: ROOT compression settings (100*algorithm+level) of all
+    // branches, -1: same as the input
+    // autoflush: entries (>0) or bytes (<0) per cluster, 0: same as the input
+    // queue: number of events buffered for a separate writer thread (see
+    // SkimWriter.h), 0: the trees are filled in addEvent
+    outputFile(std::string filename, itreestream& stream,
+               const std::vector<std::string>& branches=std::vector<std::string>(),
+               bool derived=false, int compression=-1, long autoflush=0,
+               size_t queue=0, int savecount=50000) 
       : filename_(filename),
         file_(new TFile(filename.c_str(), "recreate")),
-        tree_(stream.tree()->CloneTree(0)),
-        b_weight_(tree_->Branch("eventWeight", &weight_, "eventWeight/D")),
+        tree_(clone_tree_(stream.tree(), branches)),
+        derived_(0),
+        b_weight_(0),
         entry_(0),
-        SAVECOUNT_(savecount)
+        SAVECOUNT_(savecount),
+        queue_(queue),
+        writer_(0)
     {
       std::cout << "events will be skimmed to file "
   	      << filename_ << std::endl;
+      if ( branches.size() )
+        std::cout << "only " << tree_->GetListOfBranches()->GetEntries()
+                  << " branches are saved" << std::endl;
+      // New branches take the compression of the file
+      if ( compression >= 0 ) {
+        file_->SetCompressionSettings(compression);
+        TIter next(tree_->GetListOfBranches());
+        while ( TBranch* branch = (TBranch*)next() ) branch->SetCompressionSettings(compression);
+      }
+      if ( autoflush != 0 ) tree_->SetAutoFlush(autoflush);
+      b_weight_ = tree_->Branch("eventWeight", &weight_, "eventWeight/D");
+      if ( derived ) {
+        file_->cd();
+        derived_ = new TTree("derived", "Derived variables (friend of the skimmed tree)");
+        if ( autoflush != 0 ) derived_->SetAutoFlush(autoflush);
+      }
       file_->cd();
       hist_ = new TH1D("counts", "", 1,0,1);
       //hist_->SetBit(TH1::kCanRebin);
@@ -128,22 +321,98 @@ namespace utils {
       if ( tree_ == 0 ) return;
       
       weight_ = weight;
+      if ( queue_ > 0 ) {
+        // The writer starts with the first event (after the derived variables are booked)
+        if ( writer_ == 0 ) start_writer_();
+        if ( writer_ != 0 ) {
+          writer_->push();
+          entry_++;
+          return;
+        }
+      }
       file_   = tree_->GetCurrentFile();
       file_->cd();
       tree_->Fill();
+      if ( derived_ != 0 ) derived_->Fill();
       
       entry_++;
-      if ( entry_ % SAVECOUNT_ == 0 )
+      if ( entry_ % SAVECOUNT_ == 0 ) {
         tree_->AutoSave("SaveSelf");
+        if ( derived_ != 0 ) derived_->AutoSave("SaveSelf");
+      }
     }
     
-    void count(std::string cond, double w=1.0)
+    // Register a counter (a bin of the counts histogram)
+    // The returned id should be used in the event loop, so
+    // there is no need to build and look up the label in every event
+    size_t counter(const std::string& cond)
     {
-      hist_->Fill(cond.c_str(), w);
+      return count_bin_(cond);
+    }
+
+    // The counts are summed exactly (see ExactSum above) and
+    // are only written to the counts histogram when the file is closed
+    void count_id(const size_t& id, const double& w=1.0)
+    {
+      sumw_[id].add(w);
+      sumw2_[id].add(w*w);
+      ++nfill_[id];
+    }
+
+    void count(const std::string& cond, const double& w=1.0)
+    {
+      count_id(counter(cond), w);
+    }
+
+    // Save the exact partial sums of the counts
+    // (used to merge the results of parallel workers)
+    void write_count_partials(TDirectory* dir)
+    {
+      dir->cd();
+      TTree* tree = new TTree("count_partials", "Partial sums of counts");
+      std::string label;
+      std::vector<double> sumw, sumw2;
+      double nfill;
+      tree->Branch("label", &label);
+      tree->Branch("sumw",  &sumw);
+      tree->Branch("sumw2", &sumw2);
+      tree->Branch("nfill", &nfill, "nfill/D");
+      for (size_t bin=1, n=sumw_.size(); bin<n; ++bin) {
+        label = hist_->GetXaxis()->GetBinLabel(bin);
+        sumw  = sumw_[bin].partials();
+        sumw2 = sumw2_[bin].partials();
+        nfill = nfill_[bin];
+        tree->Fill();
+      }
+      tree->Write();
+    }
+
+    // Add the counts previously saved with write_count_partials
+    void add_count_partials(TFile* f)
+    {
+      TTree* tree = (TTree*)f->Get("count_partials");
+      if ( tree == 0 ) error("count_partials tree not found in file " + std::string(f->GetName()));
+      std::string* label = 0;
+      std::vector<double> *sumw = 0, *sumw2 = 0;
+      double nfill = 0;
+      tree->SetBranchAddress("label", &label);
+      tree->SetBranchAddress("sumw",  &sumw);
+      tree->SetBranchAddress("sumw2", &sumw2);
+      tree->SetBranchAddress("nfill", &nfill);
+      for (Long64_t i=0, n=tree->GetEntries(); i<n; ++i) {
+        tree->GetEntry(i);
+        size_t bin = count_bin_(*label);
+        for (const auto& p : *sumw)  sumw_[bin].add(p);
+        for (const auto& p : *sumw2) sumw2_[bin].add(p);
+        nfill_[bin] += nfill;
+      }
+      tree->ResetBranchAddresses();
     }
     
     void close()
     {
+      if ( writer_ != 0 ) writer_->stop();
+      fill_counts_();
       std::cout << "==> histograms saved to file " << filename_ << std::endl;
       if ( tree_ != 0 )
         {
@@ -160,13 +429,181 @@ namespace utils {
     std::string filename_;  
     TFile* file_;
     TTree* tree_;
+    TTree* derived_;
     TH1D*  hist_;
     TBranch* b_weight_;
     double     weight_;
     int    entry_;
     int    SAVECOUNT_;
+    size_t queue_;
+    SkimWriter* writer_;
+
+  private:
+    std::vector<ExactSum> sumw_;
+    std::vector<ExactSum> sumw2_;
+    std::vector<double>   nfill_;
+
+    // The trees filled by the analysis only hold the addresses from now on,
+    // the writer fills their copies
+    void start_writer_()
+    {
+      if ( !SkimWriter::supported(tree_) || (derived_ != 0 && !SkimWriter::supported(derived_)) ) {
+        std::cout << "** Warning ** outputFile - events are written without a separate thread" << std::endl;
+        queue_ = 0;
+        return;
+      }
+      std::cout << "events are written by a separate thread (queue of " << queue_ << " events)" << std::endl;
+      writer_ = new SkimWriter(queue_, SAVECOUNT_);
+      tree_ = writer_->add_tree(tree_);
+      if ( derived_ != 0 ) derived_ = writer_->add_tree(derived_);
+      writer_->start();
+    }
+
+    // Empty copy of the tree, with only the branches in the list (all if empty)
+    // The other branches are switched off only while the tree is cloned
+    static TTree* clone_tree_(TTree* tree, const std::vector<std::string>& branches)
+    {
+      if ( branches.empty() ) return tree->CloneTree(0);
+      tree->SetBranchStatus("*", 0);
+      for (const auto& name : branches) {
+        TBranch* branch = tree->GetBranch(name.c_str());
+        if ( branch == 0 ) {
+          std::cout << "** Warning ** outputFile - branch " << name << " is not in the input tree" << std::endl;
+          continue;
+        }
+        tree->SetBranchStatus(name.c_str(), 1);
+        // Counters of variable length arrays are needed too
+        TIter next(branch->GetListOfLeaves());
+        while ( TLeaf* leaf = (TLeaf*)next() )
+          if ( leaf->GetLeafCount() != 0 )
+            tree->SetBranchStatus(leaf->GetLeafCount()->GetBranch()->GetName(), 1);
+      }
+      TTree* clone = tree->CloneTree(0);
+      tree->SetBranchStatus("*", 1);
+      return clone;
+    }
+
+    // Bin of the label (new labels are appended to the axis)
+    size_t count_bin_(const std::string& cond)
+    {
+      size_t bin = hist_->GetXaxis()->FindBin(cond.c_str());
+      if (bin >= sumw_.size()) {
+        sumw_ .resize(bin+1);
+        sumw2_.resize(bin+1);
+        nfill_.resize(bin+1, 0);
+      }
+      return bin;
+    }
+
+    void fill_counts_()
+    {
+      if (hist_->GetSumw2N()==0) hist_->Sumw2();
+      double entries = 0;
+      for (size_t bin=1, n=sumw_.size(); bin<n; ++bin) {
+        hist_->SetBinContent(bin, sumw_[bin].value());
+        hist_->GetSumw2()->SetAt(sumw2_[bin].value(), bin);
+        entries += nfill_[bin];
+      }
+      hist_->SetEntries(entries);
+    }
   };
   
+  //-----------------------------------------------------------------------------
+  // Branch names listed in a file: either the names selected in a selectVariables
+  // header (stream.select("name", ...), except in comments), or one name per line
+
+  std::vector<std::string>
+  read_branch_list(const std::string& filename)
+  {
+    std::ifstream file(filename.c_str());
+    if ( !file.good() ) error("unable to open branch list file: " + filename);
+    const bool header = filename.size()>2 && filename.compare(filename.size()-2, 2, ".h")==0;
+    std::vector<std::string> branches;
+    std::string line;
+    while ( std::getline(file, line) ) {
+      line = line.substr(0, line.find("//"));
+      if ( header ) {
+        size_t pos = line.find("select(\"");
+        if ( pos == std::string::npos ) continue;
+        pos += 8;
+        branches.push_back(line.substr(pos, line.find('"', pos)-pos));
+      } else {
+        std::stringstream ss(line.substr(0, line.find('#')));
+        std::string name;
+        if ( ss>>name ) branches.push_back(name);
+      }
+    }
+    if ( branches.empty() ) error("no branches found in file: " + filename);
+    return branches;
+  }
+
+  //-----------------------------------------------------------------------------
+  //        Entry ranges [first, last) of the chain to be processed
+
+  typedef std::vector<std::pair<int, int> > EntryRanges;
+
+  int
+  nentries(const EntryRanges& ranges)
+  {
+    int n = 0;
+    for (const auto& range : ranges) n += range.second - range.first;
+    return n;
+  }
+
+  // Entries with index [from, to) when counting only the entries in the ranges
+  // (eg. to split them between parallel workers)
+  EntryRanges
+  sub_ranges(const EntryRanges& ranges, const int& from, const int& to)
+  {
+    EntryRanges sub;
+    int n = 0;
+    for (const auto& range : ranges) {
+      int first = std::max(range.first,  range.first + from - n);
+      int last  = std::min(range.second, range.first + to   - n);
+      if (first<last) sub.push_back(std::make_pair(first, last));
+      n += range.second - range.first;
+    }
+    return sub;
+  }
+
+  // Split [first, last) to nshard parts with similar size at cluster boundaries
+  // clusters: first entries of all clusters, and the number of entries at the end
+  // so that each shard reads whole baskets
+  EntryRanges
+  shard_range(const std::vector<int>& clusters, const int& first, const int& last,
+	      const int& shard, const int& nshard)
+  {
+    std::vector<int> bounds(1, first);
+    for (const auto& start : clusters) if (start>first && start<last) bounds.push_back(start);
+    bounds.push_back(last);
+    // Shard boundary i is the cluster boundary closest to the even split
+    auto boundary = [&bounds, &first, &last, &nshard] (const int& i) {
+      double target = first + double(last-first) * i / nshard;
+      auto it = std::lower_bound(bounds.begin(), bounds.end(), target);
+      if (it!=bounds.begin() && (it==bounds.end() || target-*(it-1) <= *it-target)) --it;
+      return *it;
+    };
+    EntryRanges ranges;
+    int begin = boundary(shard-1), end = boundary(shard);
+    if (begin<end) ranges.push_back(std::make_pair(begin, end));
+    return ranges;
+  }
+
+  // Every n-th cluster within the ranges, so a quick test samples all files evenly
+  EntryRanges
+  stratified_ranges(const std::vector<int>& clusters, const EntryRanges& ranges, const int& n)
+  {
+    EntryRanges sampled;
+    for (size_t i=0; i+1<clusters.size(); i+=n) {
+      for (const auto& range : ranges) {
+	int first = std::max(range.first,  clusters[i]);
+	int last  = std::min(range.second, clusters[i+1]);
+	if (first<last) sampled.push_back(std::make_pair(first, last));
+      }
+    }
+    return sampled;
+  }
+
   struct commandLine
   {
     std::string progName;
@@ -180,6 +617,22 @@ namespace utils {
     std::string signalName;                // determined automatically from input file names
     int  quickTest;                        // Do a quick test on 1/100th of events
     bool noPlots;                          // Do not make analysis histos (for skimming)
+    int  nThreads;                         // Number of parallel workers splitting the events
+    int  timing;                           // Time the event loop stages in every N-th event (0: off)
+    int  firstEntry;                       // First entry of the chain to process
+    int  lastEntry;                        // Process entries before this one (-1: till the end)
+    int  shard;                            // Process the shard-th (1..nShards) part of the entries
+    int  nShards;                          // Number of parts (aligned to TTree clusters)
+    bool stratified;                       // quickTest samples clusters evenly from all files
+    int  checkpoint;                       // Save a checkpoint every N events (0: off)
+    int  checkpointTime;                   // Save a checkpoint every N seconds (0: off)
+    bool resume;                           // Continue from the last checkpoint
+    std::string metrics;                   // Write live metrics (JSON lines) to this file or "unix:<socket>"
+    double metricsInterval;                // Seconds between metrics records
+    std::string cacheDir;                  // Directory of the columnar cache of the input files
+    std::string indexFileName;             // Sample index (metadata of the input files) next to the file list
+    std::string stageDir;                  // Local directory to copy the input files to, ahead of reading them
+    double stageSize;                      // Maximum size of the staged files (GB)
   };
   
   // Read ntuple fileNames from file list
@@ -224,6 +677,39 @@ namespace utils {
     // Don't fill any histos (useful for skimmin jobs)
     cl.noPlots = false;
 
+    // Process the events with N parallel workers
+    cl.nThreads = 1;
+
+    // Time the stages of the event loop in every N-th event (timing=N, 0: off)
+    cl.timing = 0;
+
+    // Process only a part of the entries in the chain
+    cl.firstEntry = 0;
+    cl.lastEntry = -1;
+    cl.shard = 1;
+    cl.nShards = 1;
+    cl.stratified = false;
+
+    // Checkpoints to resume a job that stopped
+    cl.checkpoint = 0;
+    cl.checkpointTime = 0;
+    cl.resume = false;
+
+    // Live metrics of the event loop
+    cl.metrics = "";
+    cl.metricsInterval = 10;
+
+    // Columnar cache of the selected variables (off)
+    cl.cacheDir = "";
+
+    // Local staging of the input files (off)
+    cl.stageDir = "";
+    cl.stageSize = 20;
+
+    // Sample index, made from the name of the file list (if the input is a single list)
+    cl.indexFileName = "";
+    std::string fullFileList = "", inputFileList = "";
+
     for (int iarg=1; iarg<argc; ++iarg) {
       std::string arg = argv[iarg];
       // look for optional arguments (argument has "=" in it)
@@ -235,8 +721,27 @@ namespace utils {
 	// reading option
 	if (option=="quickTest") value>>cl.quickTest;
 	if (option=="noPlots") value>>cl.noPlots;
+	if (option=="nThreads") value>>cl.nThreads;
+	if (option=="timing") value>>cl.timing;
+	if (option=="firstEntry") value>>cl.firstEntry;
+	if (option=="lastEntry") value>>cl.lastEntry;
+	if (option=="stratified") value>>cl.stratified;
+	if (option=="checkpoint") value>>cl.checkpoint;
+	if (option=="checkpointTime") value>>cl.checkpointTime;
+	if (option=="resume") value>>cl.resume;
+	if (option=="metrics") value>>cl.metrics;
+	if (option=="metricsInterval") value>>cl.metricsInterval;
+	if (option=="cacheDir") value>>cl.cacheDir;
+	if (option=="stageDir") value>>cl.stageDir;
+	if (option=="stageSize") value>>cl.stageSize;
+	if (option=="shard") {
+	  // eg. shard=2/10
+	  char slash;
+	  value>>cl.shard>>slash>>cl.nShards;
+	  if (slash!='/' || cl.nShards<1 || cl.shard<1 || cl.shard>cl.nShards)
+	    error("shard option should be given as shard=i/N (1<=i<=N), got: "+arg);
+	}
 	if (option=="fullFileList") {
-	  std::string fullFileList;
 	  value>>fullFileList;
 	  std::vector<std::string> list = getFilenames(fullFileList);
 	  cl.allFileNames.insert(cl.allFileNames.end(), list.begin(), list.end());
@@ -252,6 +757,7 @@ namespace utils {
 	    // if txt file, read it's contents
 	    std::vector<std::string> list = getFilenames(arg);
 	    cl.fileNames.insert(cl.fileNames.end(), list.begin(), list.end());
+	    inputFileList = n_input ? "" : arg;
 	    if (arg.find("/data/")!=std::string::npos) n_data_arg++;
 	    else if (arg.find("/signals/")!=std::string::npos) n_signal_arg++;
 	    else if (arg.find("/backgrounds/")!=std::string::npos) n_bkg_arg++;
@@ -280,6 +786,11 @@ namespace utils {
     if (!cl.allFileNames.size())
       cl.allFileNames.insert(cl.allFileNames.end(), cl.fileNames.begin(), cl.fileNames.end());
 
+    // The index of the full list also covers the files of split jobs
+    std::string indexList = fullFileList!="" ? fullFileList : n_input==1 ? inputFileList : "";
+    if (indexList.size()>4 && indexList.compare(indexList.size()-4, 4, ".txt")==0)
+      cl.indexFileName = indexList.substr(0, indexList.size()-4) + ".index.root";
+
     // Get the directory name from the first file (used for plotting)
     if (cl.fileNames.size()>0) {
       std::stringstream ss;
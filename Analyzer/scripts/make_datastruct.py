@@ -1,4 +1,10 @@
-import ROOT
+import ROOT, sys
+
+# Print common/DataStruct.h, or with --soa the same with the object collections
+# stored as fixed capacity structures of arrays (common/SoA.h), eg:
+# python scripts/make_datastruct.py --soa May10 > common/DataStruct_May10_SoA.h
+soa = "--soa" in sys.argv
+version = ([arg for arg in sys.argv[1:] if arg != "--soa"] + [""])[0]
 #File = ROOT.TFile.Open("/data/jkarancs/CMSSW/ntuple/B2GTTreeNtupleExtra_MC_25ns_80X_QCD.root")
 #File = ROOT.TFile.Open("/data/jkarancs/CMSSW/SusyAnalysis/Ntuples/Validation/CMSSW_8_0_20/src/B2GTTreeNtupleExtra_MC_25ns_80X_QCD.root")
 #File = ROOT.TFile.Open("/data/jkarancs/CMSSW/SusyAnalysis/Ntuples/Validation/CMSSW_8_0_24_patch1/src/B2GTTreeNtupleExtra_MC_80X.root")
@@ -6,11 +12,22 @@ import ROOT
 File = ROOT.TFile.Open("/data/jkarancs/CMSSW/SusyAnalysis/Ntuples/CMSSW_8_0_26_patch2/src/B2GTTreeNtupleExtra_MC_80X_GJets.root")
 tree = File.Get("B2GTTreeMaker/B2GTree")
 
-def printvars( varname, vartype, prefix, isvector, keep_prefix ):
+def printvars( varname, vartype, prefix, isvector, keep_prefix, use_soa ):
     if varname.startswith(prefix):
         short = varname if keep_prefix else varname[len(prefix):]
         if "Keys" in varname:
             print "    std::vector<std::vector<int> > "+short+";"
+        elif isvector and use_soa:
+            if "i" in vartype:
+                print "    SoAColumn<unsigned int> "+short+"{arena, size};"
+            elif "I" in vartype:
+                print "    SoAColumn<int> "+short+"{arena, size};"
+            elif "l" in vartype:
+                print "    SoAColumn<long> "+short+"{arena, size};"
+            elif "F" in vartype:
+                print "    SoAColumn<float> "+short+"{arena, size};"
+            elif "D" in vartype:
+                print "    SoAColumn<double> "+short+"{arena, size};"
         elif isvector:
             if "i" in vartype:
                 print "    std::vector<unsigned int> "+short+";"
@@ -35,10 +52,13 @@ def printvars( varname, vartype, prefix, isvector, keep_prefix ):
                 print "    double "+short+";"
     return
 
-def printinits( varname, vartype, prefix, isvector, keep_prefix ):
+# SoA columns are all filled by arena.fill() (printed only when not use_soa)
+def printinits( varname, vartype, prefix, isvector, keep_prefix, use_soa ):
     if varname.startswith(prefix):
         short = varname if keep_prefix else varname[len(prefix):]
-        if isvector or "Keys" in varname:
+        if use_soa and isvector and not "Keys" in varname:
+            return
+        elif isvector or "Keys" in varname:
             print "      init_vec("+short+");"
         else:
             if "i" in vartype:
@@ -53,23 +73,33 @@ def printinits( varname, vartype, prefix, isvector, keep_prefix ):
                 print "      "+short+"=NOVAL_F;"
     return
 
-def printclass( tree, classname, name, prefix_list, add_loop ):
+def printclass( tree, classname, name, prefix_list, add_loop, use_soa=0 ):
+    use_soa = use_soa and soa
     print "  class "+classname+" {"
     print "  public:"
     print "    "+classname+"() { init(); };"
     print "    "
+    if use_soa: print "    SoAArena arena{SOA_CAPACITY};"
     # print variables
     for prefix in prefix_list:
-        for branch in tree.GetListOfBranches(): printvars( branch.GetName(), str(branch.GetTitle())[-1:], prefix, ("[" in branch.GetTitle()), (prefix_list[0] != prefix) )
+        for branch in tree.GetListOfBranches(): printvars( branch.GetName(), str(branch.GetTitle())[-1:], prefix, ("[" in branch.GetTitle()), (prefix_list[0] != prefix), use_soa )
     print "    "
     if add_loop:
         print "    unsigned int it;"
         print "    "
     print "    void init() {"
     if add_loop: print "      it = -1;"
-    # initialize variables
+    # initialize variables (with SoA: the size first, then the columns and the keys)
     for prefix in prefix_list:
-        for branch in tree.GetListOfBranches(): printinits( branch.GetName(), str(branch.GetTitle())[-1:], prefix, ("[" in branch.GetTitle()), (prefix_list[0] != prefix) )
+        for branch in tree.GetListOfBranches():
+            if not (use_soa and "Keys" in branch.GetName()):
+                printinits( branch.GetName(), str(branch.GetTitle())[-1:], prefix, ("[" in branch.GetTitle()), (prefix_list[0] != prefix), use_soa )
+    if use_soa:
+        print "      arena.fill();"
+        for prefix in prefix_list:
+            for branch in tree.GetListOfBranches():
+                if "Keys" in branch.GetName():
+                    printinits( branch.GetName(), str(branch.GetTitle())[-1:], prefix, ("[" in branch.GetTitle()), (prefix_list[0] != prefix), use_soa )
     print "    }"
     if add_loop:
         print "    "
@@ -90,15 +120,27 @@ def printclass( tree, classname, name, prefix_list, add_loop ):
 
 
 # Now print the contents for common/DataStruct.h
-print """#ifndef DataStruct_h
-#define DataStruct_h
-
-#define NOVAL_I -9999
+print "#ifndef DataStruct_h"
+print "#define DataStruct_h"
+print ""
+if soa:
+    print """// Same as DataStruct_%s.h, except gen, pho, ele, mu, jetsAK4 and jetsAK8
+// are fixed capacity structures of arrays (common/SoA.h): each collection
+// has one aligned block of memory for all of its variables, which is not
+// reallocated when reading the events
+// (made with scripts/make_datastruct.py --soa %s)
+""" % (version, version)
+print """#define NOVAL_I -9999
 #define NOVAL_F -9999.0
 
 #include <vector>
-#include <iostream>
+#include <iostream>"""
+if soa:
+    print """#include "SoA.h"
 
+// Maximum number of objects in the collections stored as SoA columns
+#define SOA_CAPACITY 500"""
+print """
 inline void init_vec(std::vector<int>& vec) { vec.resize(500); for (int i=0; i<500; ++i) vec[i]=-9999; }
 inline void init_vec(std::vector<float>& vec) { vec.resize(500); for (int i=0; i<500; ++i) vec[i]=-9999; }
 inline void init_vec(std::vector<double>& vec) { vec.resize(500); for (int i=0; i<500; ++i) vec[i]=-9999; }
@@ -122,12 +164,12 @@ printclass( tree, "SystMETUncData",      "syst_met",        ["metsyst_"],
 printclass( tree, "SystPuppiMETUncData", "syst_puppimet",   ["puppimetsyst_"],   1 )
 printclass( tree, "FilterData",          "filter",          ["Flag_"],           0 )
 printclass( tree, "HLTData",             "hlt",             ["HLT_"],            0 )
-printclass( tree, "GenVars",             "gen",             ["gen_"],            1 )
-printclass( tree, "PhotonVars",          "pho",             ["pho_"],            1 )
-printclass( tree, "ElectronVars",        "ele",             ["el_"],             1 )
-printclass( tree, "MuonVars",            "mu",              ["mu_"],             1 )
-printclass( tree, "AK4JetVars",          "jetsAK4",         ["jetAK4CHS_"],      1 )
-printclass( tree, "AK8JetVars",          "jetsAK8",         ["jetAK8CHS_"],      1 )
+printclass( tree, "GenVars",             "gen",             ["gen_"],            1, 1 )
+printclass( tree, "PhotonVars",          "pho",             ["pho_"],            1, 1 )
+printclass( tree, "ElectronVars",        "ele",             ["el_"],             1, 1 )
+printclass( tree, "MuonVars",            "mu",              ["mu_"],             1, 1 )
+printclass( tree, "AK4JetVars",          "jetsAK4",         ["jetAK4CHS_"],      1, 1 )
+printclass( tree, "AK8JetVars",          "jetsAK8",         ["jetAK8CHS_"],      1, 1 )
 printclass( tree, "AK8SubjetVars",       "subjetsAK8",      ["subjetAK8CHS_"],   1 )
 printclass( tree, "AK8GenJetVars",       "genjetsAK8",      ["genjetAK8SD_"],    1 )
 
@@ -0,0 +1,35 @@
+from __future__ import print_function
+import re, sys
+
+# Make the schema header of a DataStruct from a selectVariables header that
+# lists all of its variables (selected or commented out), eg:
+# python scripts/make_schema.py common/selectVariables_skim_May10_photon.h May10 > common/Schema_May10.h
+
+if len(sys.argv) < 3:
+    print("Usage: python scripts/make_schema.py <selectVariables header> <DataStruct version>", file=sys.stderr)
+    sys.exit(1)
+
+select = re.compile(r'select\("(\w+)",\s*data\.([\w.]+)\)')
+fields = []
+for line in open(sys.argv[1]):
+    m = select.search(line)
+    # Keys (vector of vectors) can not be selected with a type conversion
+    if m and not m.group(2).endswith(".Keys") and m.groups() not in fields:
+        fields.append(m.groups())
+
+print("""#ifndef SCHEMA_H
+#define SCHEMA_H
+//-----------------------------------------------------------------------------
+// File:        Schema_%s.h
+// Description: Branch name and DataStruct member of all variables of
+//              DataStruct_%s.h (made with scripts/make_schema.py from
+//              %s)
+//              Usage: #define F(branch, member) ...
+//                     DATASTRUCT_SCHEMA(F)
+//-----------------------------------------------------------------------------
+
+#define DATASTRUCT_SCHEMA(F) \\""" % (sys.argv[2], sys.argv[2], sys.argv[1]))
+for branch, member in fields:
+    print('  F("%s", %s) \\' % (branch, member))
+print("""
+#endif""")
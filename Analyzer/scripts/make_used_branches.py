@@ -0,0 +1,45 @@
+from __future__ import print_function
+import os, re, sys
+
+# List the DataStruct members used by the compiled analysis, called by make
+# with the schema header and the headers included by Analyzer.cc (g++ -MM -MG):
+# python scripts/make_used_branches.py common/Schema_May10.h <sources> > common/usedBranches.h
+
+if len(sys.argv) < 3:
+    print("Usage: python scripts/make_used_branches.py <schema header> <sources>", file=sys.stderr)
+    sys.exit(1)
+
+members = re.findall(r'F\("\w+", ([\w.]+)\)', open(sys.argv[1]).read())
+objects = sorted(set(m.split(".")[0] for m in members))
+reference = re.compile(r'\b(' + "|".join(objects) + r')\s*\.\s*(\w+)')
+# Collections passed to the generic helpers, which use their members without the name of the
+# collection (fillFourVectors: last argument, nobjects: the only argument)
+collection = r'(?:\w+\s*\.\s*)*\b(' + "|".join(objects) + r')\s*\)'
+helpers = [ (re.compile(r'\bfillFourVectors\s*\([^;]*,\s*' + collection), ["Pt", "Eta", "Phi", "E", "size"]),
+            (re.compile(r'\bnobjects\s*\(\s*' + collection), ["size"]) ]
+
+# Files that list all variables
+skip = re.compile(r'(DataStruct|Schema|selectVariables|usedBranches)\w*\.h$')
+
+used = set()
+for source in sys.argv[2:]:
+    if source.endswith(":") or not os.path.isfile(source) or os.path.isabs(source) or skip.search(source):
+        continue
+    for line in open(source):
+        code = line.split("//")[0]
+        for obj, member in reference.findall(code):
+            used.add(obj + "." + member)
+            # Loop() and the counters of collections need their size
+            used.add(obj + ".size")
+        for pattern, helper_members in helpers:
+            for obj in pattern.findall(code):
+                for member in helper_members:
+                    used.add(obj + "." + member)
+
+print("""// Made by make (scripts/make_used_branches.py), do not edit
+// DataStruct members used by the analysis, only their branches are read
+#define USED_DATASTRUCT_MEMBERS \\""")
+for member in members:
+    if member in used:
+        print('  "%s", \\' % member)
+print("")
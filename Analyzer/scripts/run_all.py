@@ -16,10 +16,13 @@ parser.add_option("--prevdir",     dest="PREVDIR",     type="string",       defa
 parser.add_option("--jobtime",     dest="JOBTIME",     type="int",          default=1500,    help="Desired job running time in s (default=1500)")
 parser.add_option("--quick",       dest="NQUICK",      type="int",          default=0,       help="Run only on a subset of events (1/NQUICK)")
 parser.add_option("--nevt",        dest="NEVT",        type="int",          default=-1,      help="Tells how many event to run as a maximum in a single job (Default=-1 all)")
+parser.add_option("--nshard",      dest="NSHARD",      type="int",          default=1,       help="Split each dataset to this number of jobs at cluster boundaries (Default=1)")
+parser.add_option("--stratified",  dest="stratified",  action="store_true", default=False,   help="With --quick, run on every NQUICK-th cluster of all files instead of the first 1/NQUICK")
 parser.add_option("--nfile",       dest="NFILE",       type="int",          default=-1,      help="Tells how many input files to run in a single job (Default=-1 all)")
 parser.add_option("--sleep",       dest="SLEEP",       type="int",          default=3,       help="Wait for this number of seconds between submitting each batch job (Default 3s)")
 parser.add_option("--useprev",     dest="useprev",     action="store_true", default=False,   help="Use previously created temporary filelists")
 parser.add_option("--nproc",       dest="NPROC",       type="int",          default=1,       help="Tells how many parallel interactive jobs to start (Default=3)")
+parser.add_option("--nthread",     dest="NTHREAD",     type="int",          default=1,       help="Number of parallel workers used inside each Analyzer job (Default=1)")
 parser.add_option("--outdir",      dest="OUTDIR",      type="string",       default="",      help="Output directory (Default: results/run_[DATE])")
 parser.add_option("--skimout",     dest="SKIMOUT",     type="string",       default="",      help="Output directory for skimming")
 parser.add_option("--skim",        dest="skim",        action="store_true", default=False,   help="Skim output to --skimout directory (change in script)")
@@ -27,6 +30,8 @@ parser.add_option("--mirror",      dest="mirror",      action="store_true", defa
 parser.add_option("--mirror_user", dest="mirror_user", action="store_true", default=False,   help="Also copy skim output to Janos' EOS")
 parser.add_option("--plot",        dest="plot",        action="store_true", default=False,   help="Make plots after running using Plotter (Janos)")
 parser.add_option("--replot",      dest="replot",      action="store_true", default=False,   help="Remake latest set of plots using Plotter (Janos)")
+parser.add_option("--checkpoint",  dest="CHECKPOINT",  type="int",          default=0,       help="Jobs save a checkpoint every N seconds, --recover resumes from it (Default=0 off)")
+parser.add_option("--metrics",     dest="METRICS",     type="string",       default="",      help="Jobs append live metrics (JSON lines) to this file or to unix:<socket path>")
 parser.add_option("--recover",     dest="recover",     action="store_true", default=False,   help="Recover stopped task (eg. due to some error)")
 parser.add_option("--nohadd",      dest="nohadd",      action="store_true", default=False,   help="Disable hadding output files")
 (opt,args) = parser.parse_args()
@@ -173,7 +178,13 @@ for filelist in input_filelists:
     # Now let's make the argument list for the Analyzer jobs
     options = []
     if opt.NQUICK>1: options.append("quickTest="+str(opt.NQUICK))
+    if opt.NQUICK>1 and opt.stratified: options.append("stratified=1")
     if opt.skim and not opt.plot: options.append("noPlots=1")
+    if opt.NTHREAD>1: options.append("nThreads="+str(opt.NTHREAD))
+    if opt.METRICS != "": options.append("metrics="+opt.METRICS)
+    if opt.CHECKPOINT>0:
+        options.append("checkpointTime="+str(opt.CHECKPOINT))
+        if opt.recover: options.append("resume=1")
     # Temporary filelists
     if opt.useprev:
         # Use previously created lists
@@ -183,6 +194,11 @@ for filelist in input_filelists:
             tmp_filelist = prev_lists[jobnum-1]
             args = [output_file.replace(".root","_"+str(jobnum)+".root"), [EXEC_PATH+"/"+tmp_filelist], options, log_file.replace(".log","_"+str(jobnum)+".log")]
             ana_arguments.append(args)
+    elif opt.NSHARD>1:
+        # SHARD MODE: Each job reads the full filelist, but processes only 1/opt.NSHARD of the entries
+        for n in range(1, opt.NSHARD+1):
+            args = [output_file.replace(".root","_"+str(n)+".root"), [EXEC_PATH+"/"+filelist], options+["shard="+str(n)+"/"+str(opt.NSHARD)], log_file.replace(".log","_"+str(n)+".log")]
+            ana_arguments.append(args)
     elif opt.NEVT != -1 or opt.optim:
         # SPLIT MODE (recommended for batch): Each jobs runs on max opt.NEVT
         JOB_NEVT = opt.NEVT
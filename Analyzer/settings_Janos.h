@@ -2,15 +2,23 @@
 // VER 1 - Moriond17 datasets
 // VER 2 - Moriond17 + 03Feb2017 ReMiniAOD datasets
 // SKIM - 1: save skimmed ntuple, 0: run on already skimmed ntuple
+// SOA  - 1: object collections are fixed capacity arrays (common/SoA.h), 0: std::vectors
 #define VER     2
 #define SKIM    0
+#define SOA     0
 
 #if VER == 1
 #include "common/DataStruct_Jan12.h"
+#elif VER == 2 && SOA == 1
+#include "common/DataStruct_May10_SoA.h"
 #elif VER == 2
 #include "common/DataStruct_May10.h"
 #endif
 #include "common/treestream.h"
+#if VER == 2
+#include "common/Schema_May10.h"
+#include "common/SchemaSelect.h"
+#endif
 //#include "Analysis_Janos.h" // Specify here the implementations for your Analysis
 #include "Analysis_T.h" // Specify here the implementations for your Analysis
 
@@ -60,8 +68,31 @@ struct settings {
     lumiUncertainty          ( 0.025  ),
 #endif
     useXSecFileForBkg        ( true   ), // true: use file below, false: use value in the ntuple (evt_XSec)
-    xSecFileName             ( "common/BackGroundXSec.txt" )
+    xSecFileName             ( "common/BackGroundXSec.txt" ),
+    readPreselectionFirst    ( false  ), // Data only: read branches below first, and the rest only if the event passes the preselection baseline cuts (all is read for skimming)
+    cacheSize                ( 30*1024*1024 ), // TTreeCache size (bytes) for the selected branches, 0: no cache
+    parallelUnzip            ( 0      ), // Unzip the cached baskets ahead in a background thread, buffer size in units of cacheSize (0: off)
+    asyncPrefetch            ( false  ), // Read the next cluster in a background thread while the current one is analysed
+    useSampleIndex           ( false  ), // Take entries, clusters, xsec and total weights of the input files from <list>.index.root (made/updated if needed)
+    readStallTime            ( 0      ), // Open the input file again if reading an event takes longer than this (s), 0: no limit
+    readRetries              ( 0      ), // Open an input file again at most this many times (failed reads are retried), 0: no retries
+    skipBadFiles             ( false  ), // Skip the rest of files that can not be read (counted as "nevents_skipped" and "skipped: <file>"), false: stop the job
+    useSchema                ( false  ), // VER 2: read the branches of DataStruct used by the analysis and present in the input (common/Schema_May10.h), false: selectVariables above
+#if VER == 1
+    skimBranchesFileName     ( "common/selectVariables_fast_Jan12.h" ), // Skim only the branches selected in this file (or listed one per line), "": all
+#else
+    skimBranchesFileName     ( "common/selectVariables_fast_May10.h" ), // Skim only the branches selected in this file (or listed one per line), "": all
+#endif
+    saveDerivedTree          ( false  ), // Also save the recalculated Razor variables, megajets, tag counts and object pass masks to the friend tree "derived"
+    skimCompression          ( 404    ), // ROOT compression of the skim: 100*algorithm+level, eg. 404: LZ4 (fast, for intermediate skims), 207: LZMA, -1: same as input
+    skimAutoFlush            ( -30000000 ), // Skim cluster size: entries (>0) or bytes (<0), 0: same as input
+    skimWriteQueue           ( 1000   )  // Skimmed events are written by a separate thread, buffering this many events (0: write in the event loop)
   {
+    // Branches needed by the JSON lumi mask and baseline_cuts
+    // (only ntuple branches, the common variables are not calculated yet)
+    preselectionBranches = { "evt_RunNumber", "evt_LumiBlock",
+			     "Flag_goodVertices", "Flag_globalTightHalo2016Filter", "Flag_HBHENoiseFilter", "Flag_HBHENoiseIsoFilter",
+			     "Flag_EcalDeadCellTriggerPrimitiveFilter", "Flag_eeBadScFilter", "Flag_BadPFMuonFilter", "Flag_BadChargedCandidateFilter" };
     totWeightHistoNamesSignal.push_back(runOnSkim ? "totweight_T1tttt" : "EventCounter/h_totweight_T1tttt"); // lsp mass vs gluino mass scan, also used for T5ttcc and T5tttt
     totWeightHistoNamesSignal.push_back(runOnSkim ? "totweight_T2tt"   : "EventCounter/h_totweight_T2tt");   // T2tt
   };
@@ -88,6 +119,21 @@ struct settings {
   const double lumiUncertainty;
   const bool useXSecFileForBkg;
   const std::string xSecFileName;
+  const bool readPreselectionFirst;
+  const long cacheSize;
+  const double parallelUnzip;
+  const bool asyncPrefetch;
+  const bool useSampleIndex;
+  const double readStallTime;
+  const int  readRetries;
+  const bool skipBadFiles;
+  const bool useSchema;
+  const std::string skimBranchesFileName;
+  const bool saveDerivedTree;
+  const int  skimCompression;
+  const long skimAutoFlush;
+  const size_t skimWriteQueue;
+  std::vector<std::string> preselectionBranches;
   std::vector<std::string> totWeightHistoNamesSignal;
 
 } settings;